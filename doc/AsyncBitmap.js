@@ -0,0 +1,21 @@
+/**
+ * A handle for an image that is loaded in the background, created by Bitmap.LoadAsync().
+ * @class
+ */
+function AsyncBitmap() {
+	/**
+	 * Name of the file.
+	 * @member {string}
+	 */
+	this.filename = null;
+}
+/**
+ * check if the image was loaded. An exception is thrown if the image could not be loaded.
+ * @returns {Bitmap} the Bitmap or null if decoding is still in progress.
+ */
+AsyncBitmap.prototype.Poll = function () { };
+/**
+ * wait until the image was loaded. An exception is thrown if the image could not be loaded.
+ * @returns {Bitmap} the Bitmap.
+ */
+AsyncBitmap.prototype.Wait = function () { };
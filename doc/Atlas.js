@@ -0,0 +1,63 @@
+/**
+ * Create an empty sprite atlas. Many small images can be packed into the one backing Bitmap of an Atlas.
+ * This saves memory and allows drawing many sprites with a single call using DrawBatch().
+ * @class
+ * 
+ * @param {number} width width of the backing Bitmap.
+ * @param {number} height height of the backing Bitmap.
+ */
+function Atlas(width, height) {
+	/**
+	 * Width in pixels
+	 * @member {number}
+	 */
+	this.width = 0;
+	/**
+	 * Height in pixels
+	 * @member {number}
+	 */
+	this.height = 0;
+}
+/**
+ * copy a Bitmap into the atlas. An exception is thrown if there is not enough space left.
+ * @param {Bitmap} bm the Bitmap to add.
+ * @returns {number} the id of the image in the atlas.
+ */
+Atlas.prototype.Add = function (bm) { };
+/**
+ * get a lightweight Bitmap for an image in the atlas. The Bitmap shares its pixels with the atlas.
+ * @param {number} id the id returned by Add().
+ * @returns {Bitmap} a Bitmap view of the image.
+ */
+Atlas.prototype.Get = function (id) { };
+/**
+ * get the position of an image in the backing Bitmap.
+ * @param {number} id the id returned by Add().
+ * @returns {*} an object with x, y, width and height.
+ */
+Atlas.prototype.GetRect = function (id) { };
+/**
+ * get the number of images in the atlas.
+ * @returns {number} the number of images.
+ */
+Atlas.prototype.Size = function () { };
+/**
+ * Draw an image of the atlas to the canvas at given coordinates.
+ * @param {number} id the id returned by Add().
+ * @param {number} x position to draw to.
+ * @param {number} y position to draw to.
+ */
+Atlas.prototype.Draw = function (id, x, y) { };
+/**
+ * Draw an image of the atlas to the canvas at given coordinates using the alpha channel transparency.
+ * @param {number} id the id returned by Add().
+ * @param {number} x position to draw to.
+ * @param {number} y position to draw to.
+ */
+Atlas.prototype.DrawTrans = function (id, x, y) { };
+/**
+ * Draw many images of the atlas with one call.
+ * @param {IntArray|number[]} records flat list of (id, x, y) triplets.
+ * @param {boolean} [trans] true to use alpha channel transparency.
+ */
+Atlas.prototype.DrawBatch = function (records, trans) { };
@@ -58,6 +58,14 @@ function Bitmap(filename) {
 	 */
 	this.height = 0;
 };
+/**
+ * start loading an image in the background. Reading and decoding the file happens on a worker thread (Linux) so Loop() keeps running smoothly.
+ * Only QOI, WEBP and PNG images are decoded on the worker thread, other formats (e.g. JPEG) are loaded by the first call to Poll() or Wait().
+ * On DOS there are no threads, the image is decoded by the first call to Poll() or Wait().
+ * @param {string} filename name of the file, may be inside a ZIP file.
+ * @returns {AsyncBitmap} a handle to poll for the Bitmap.
+ */
+Bitmap.LoadAsync = function (filename) { };
 
 /**
  * Draw the image to the canvas at given coordinates.
@@ -78,12 +86,40 @@ Bitmap.prototype.Draw = function (x, y) { };
  * @param {number} destH size to draw.
  */
 Bitmap.prototype.DrawAdvanced = function (srcX, srcY, srcW, srcH, destX, destY, destW, destH) { };
+/**
+ * Draw the image to the canvas at given coordinates, all pixels with MASK_COLOR are skipped.
+ * Uses the optimized form if the Bitmap was optimized using Optimize().
+ * @param {number} x position to draw to.
+ * @param {number} y position to draw to.
+ */
+Bitmap.prototype.DrawMasked = function (x, y) { };
 /**
  * Draw the image to the canvas at given coordinates using the alpha channel transparency. Only works for 32bit TGA with alpha channel information.
  * @param {number} x position to draw to.
  * @param {number} y position to draw to.
  */
 Bitmap.prototype.DrawTrans = function (x, y) { };
+/**
+ * Create an optimized representation of this Bitmap for drawing it as a masked sprite using DrawMasked() and DrawTrans().
+ * Pixels with MASK_COLOR are skipped by both, Draw() is not affected by the optimization.
+ * The optimized form is dropped when the Bitmap is changed (e.g. by Clear() or by using it with SetRenderBitmap()).
+ * Bitmaps that are currently used as render target (SetRenderBitmap(), 3D scenes, OpenGL) can't be optimized.
+ * 
+ * @param {SPRITE} [mode] one of SPRITE.NONE, SPRITE.RLE or SPRITE.COMPILED. Default: SPRITE.RLE
+ */
+Bitmap.prototype.Optimize = function (mode) { };
+/**
+ * Get the current optimization mode of this Bitmap.
+ * 
+ * @returns {SPRITE} one of SPRITE.NONE, SPRITE.RLE or SPRITE.COMPILED.
+ */
+Bitmap.prototype.GetOptimization = function () { };
+/**
+ * Get the pixels of this image as RGBA bytes. The same PixelArray is returned on every call, PixelArray.Update() must be called after modifying it.
+ * 
+ * @returns {PixelArray} the pixels.
+ */
+Bitmap.prototype.GetPixels = function () { };
 /**
  * Get the color of a pixel of this image.
  * @param {number} x position.
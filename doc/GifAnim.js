@@ -73,3 +73,19 @@ GIFanim.prototype.PlayFrame = function (x, y) { }
  * @returns {number} -1 if this was the last frame, else the delay for the next frame.
  */
 GIFanim.prototype.SkipFrame = function () { }
+
+/**
+ * cache the composited frames of the animation, after the first pass PlayFrame() only draws the cached Bitmaps instead of decoding the GIF.
+ * The cache needs (frameCount + 1) * width * height * bytes per pixel of the current render Bitmap (4 for 32bpp) and must be enabled while drawing into a Bitmap of the color depth used for playback.
+ * Enabling the cache restarts the animation with the first frame.
+ * 
+ * @param {number} maxBytes maximum memory to use for the cache.
+ * @returns {boolean} true if the cache is enabled, false if the animation needs more memory than allowed.
+ */
+GIFanim.prototype.EnableCache = function (maxBytes) { }
+
+/**
+ * check if all frames are served from the cache.
+ * @returns {boolean} true if all frames were decoded and cached.
+ */
+GIFanim.prototype.IsCached = function () { }
@@ -0,0 +1,118 @@
+/**
+ * Create a native Matrix. All operations change the Matrix in place and return it, so calls can be chained (e.g. m.Identity().Translate(0, 0, 100).RotateY(a)).
+ * Translate(), Scale() and Rotate*() add the new transformation in front of the current one (like OpenGL), use Push() and Pop() to draw hierarchical models.
+ * 
+ * MatrixMul(), ApplyMatrix(), Mesh.Draw() and Mesh.SceneDraw() accept a Matrix or the object returned by GetRotationMatrix(), MatrixMul(), etc. with the 3x3 matrix in `v` and the translation in `t` (see Matrix.Get()).
+ * 
+ * **Note: al3d module must be loaded by calling LoadLibrary("al3d") before using!**
+ * 
+ * @class
+ * @param {Matrix} [m] matrix to copy, the identity matrix is used if omitted.
+ */
+function Matrix(m) { }
+/**
+ * Reset to the identity matrix.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.Identity = function () { };
+/**
+ * Copy another matrix into this one.
+ * @param {Matrix} m the matrix to copy.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.Set = function (m) { };
+/**
+ * Get the matrix values.
+ * @returns {*} an object with the 3x3 matrix in `v` (number[][]) and the translation in `t` (number[]).
+ */
+Matrix.prototype.Get = function () { };
+/**
+ * Replace the matrix with a rotation matrix, see GetRotationMatrix().
+ * @param {number} x x-rotation in radians.
+ * @param {number} y y-rotation in radians.
+ * @param {number} z z-rotation in radians.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.SetRotation = function (x, y, z) { };
+/**
+ * Replace the matrix with a transformation matrix, see GetTransformationMatrix().
+ * @param {number} scale scaling value.
+ * @param {number} xrot x-rotation value.
+ * @param {number} yrot y-rotation value.
+ * @param {number} zrot z-rotation value.
+ * @param {number} x x value.
+ * @param {number} y y value.
+ * @param {number} z y value.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.SetTransformation = function (scale, xrot, yrot, zrot, x, y, z) { };
+/**
+ * Add a translation.
+ * @param {number} x x value.
+ * @param {number} y y value.
+ * @param {number} z z value.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.Translate = function (x, y, z) { };
+/**
+ * Add a scaling.
+ * @param {number} x x scale, used for all axes if y and z are omitted.
+ * @param {number} [y] y scale.
+ * @param {number} [z] z scale.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.Scale = function (x, y, z) { };
+/**
+ * Add a rotation around all three axes.
+ * @param {number} x x-rotation in radians.
+ * @param {number} y y-rotation in radians.
+ * @param {number} z z-rotation in radians.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.Rotate = function (x, y, z) { };
+/**
+ * Add a rotation around the X axis.
+ * @param {number} r rotation in radians.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.RotateX = function (r) { };
+/**
+ * Add a rotation around the Y axis.
+ * @param {number} r rotation in radians.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.RotateY = function (r) { };
+/**
+ * Add a rotation around the Z axis.
+ * @param {number} r rotation in radians.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.RotateZ = function (r) { };
+/**
+ * Multiply with another matrix, m is applied to points after this matrix (same as MatrixMul(this, m)).
+ * @param {Matrix} m the other matrix.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.Mul = function (m) { };
+/**
+ * Multiply with another matrix, m is applied to points before this matrix (same as MatrixMul(m, this)).
+ * @param {Matrix} m the other matrix.
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.PreMul = function (m) { };
+/**
+ * Save a copy of the matrix on the stack of this Matrix (max. 32 entries).
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.Push = function () { };
+/**
+ * Restore the matrix last saved with Push().
+ * @returns {Matrix} this Matrix.
+ */
+Matrix.prototype.Pop = function () { };
+/**
+ * Transform all vertices of a vertex buffer with six values (x, y, z, u, v, c) per vertex. u, v and c are copied unchanged.
+ * @param {DoubleArray|number[]} src the vertices.
+ * @param {DoubleArray|number[]} [dst] destination of the same type and at least the same size, the result is written back to src if omitted.
+ */
+Matrix.prototype.ApplyBuffer = function (src, dst) { };
@@ -0,0 +1,51 @@
+/**
+ * Create a Mesh. The vertices and indices are converted once and kept in native memory, drawing a Mesh transforms, clips, projects and renders all faces in one call.
+ * 
+ * **Note: al3d module must be loaded by calling LoadLibrary("al3d") before using!**
+ * 
+ * @class
+ * @param {IntArray|DoubleArray|number[]|number[][]} vertices the vertices, either as array of [x, y, z, u, v, c] arrays or as flat IntArray/DoubleArray/array with six values per vertex.
+ * @param {IntArray|number[]} [indices] the vertex indices, faceSize entries per face. If omitted the vertices are used in order.
+ * @param {number} [faceSize=3] number of vertices per face (3 for triangles, 4 for quads, up to 32).
+ */
+function Mesh(vertices, indices, faceSize) {
+	/** 
+	 * number of vertices. 
+	 * @member {number}
+	 */
+	this.numVertices = 0;
+	/** 
+	 * number of faces. 
+	 * @member {number}
+	 */
+	this.numFaces = 0;
+	/** 
+	 * number of vertices per face. 
+	 * @member {number}
+	 */
+	this.faceSize = 0;
+}
+/**
+ * Transform all vertices with the matrix, clip the faces against the clipping planes (see Mesh.SetClip()), project them using the viewport set with SetProjectionViewport() and draw them to the current bitmap.
+ * @param {Matrix} m the transformation {@link Matrix}.
+ * @param {POLYTYPE} type one of POLYTYPE.
+ * @param {Bitmap} texture texture Bitmap if one of the textured types, null otherwise.
+ * @param {boolean} [cull=false] true to skip faces facing away from the camera.
+ * @returns {number} number of drawn faces.
+ */
+Mesh.prototype.Draw = function (m, type, texture, cull) { };
+/**
+ * Same as Mesh.Draw(), but the faces are put into the scene created with CreateScene(). Must be called between ClearScene() and RenderScene().
+ * @param {Matrix} m the transformation {@link Matrix}.
+ * @param {POLYTYPE} type one of POLYTYPE.
+ * @param {Bitmap} texture texture Bitmap if one of the textured types, null otherwise.
+ * @param {boolean} [cull=false] true to skip faces facing away from the camera.
+ * @returns {number} number of faces put into the scene.
+ */
+Mesh.prototype.SceneDraw = function (m, type, texture, cull) { };
+/**
+ * Set the clipping planes used by Mesh.Draw() and Mesh.SceneDraw(). The default is 0.1..1000.
+ * @param {number} min_z near clipping plane.
+ * @param {number} max_z far clipping plane.
+ */
+Mesh.prototype.SetClip = function (min_z, max_z) { };
@@ -71,11 +71,17 @@ MPEG1.prototype.HasEnded = function () { }
 
 /**
  * must be called periodically (e.g. every Loop()) to render audio/video.
+ * On Linux the video is decoded ahead by a background thread, Play() only draws the frame for the current time and feeds the queued audio.
+ * Frames that are late are skipped, see GetStats().
+ * The frame is converted from YCbCr directly into the current render Bitmap and can be scaled while doing so.
  * 
  * @param  {number} x x position of the upper left corner of the video
  * @param  {number} y y position of the upper left corner of the video
+ * @param  {number} [w] width of the video on screen (default: video width)
+ * @param  {number} [h] height of the video on screen (default: video height)
+ * @param  {boolean} [bilinear] true to use bilinear filtering when scaling, false for nearest neighbour (default: false)
  */
-MPEG1.prototype.Play = function (x, y) { }
+MPEG1.prototype.Play = function (x, y, w, h, bilinear) { }
 
 /**
  * current play pos
@@ -84,3 +90,22 @@ MPEG1.prototype.Play = function (x, y) { }
  */
 MPEG1.prototype.CurrentTime = function () { }
 
+/**
+ * get playback statistics.
+ * 
+ * @returns {*} an object with the following properties:
+ * 
+ * decoded: number of frames decoded and queued
+ * 
+ * shown: number of frames drawn by Play()
+ * 
+ * dropped: number of frames skipped because they were late
+ * 
+ * queued: number of frames currently waiting in the queue
+ * 
+ * audioQueued: number of audio segments currently waiting in the queue
+ * 
+ * threaded: true if a background thread is decoding the video
+ */
+MPEG1.prototype.GetStats = function () { }
+
@@ -10,16 +10,10 @@
 // The following functions are missing from the implementation (help is much appreciated)
 
 // Vertex Arrays  (1.1)
-GLAPI void GLAPIENTRY glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid * ptr);
-GLAPI void GLAPIENTRY glNormalPointer(GLenum type, GLsizei stride, const GLvoid * ptr);
-GLAPI void GLAPIENTRY glColorPointer(GLint size, GLenum type, GLsizei stride, const GLvoid * ptr);
 GLAPI void GLAPIENTRY glIndexPointer(GLenum type, GLsizei stride, const GLvoid * ptr);
-GLAPI void GLAPIENTRY glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid * ptr);
 GLAPI void GLAPIENTRY glEdgeFlagPointer(GLsizei stride, const GLvoid * ptr);
 GLAPI void GLAPIENTRY glGetPointerv(GLenum pname, void ** params);
 GLAPI void GLAPIENTRY glArrayElement(GLint i);
-GLAPI void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count);
-GLAPI void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid * indices);
 GLAPI void GLAPIENTRY glInterleavedArrays(GLenum format, GLsizei stride, const GLvoid * pointer);
 
 // Texture mapping
@@ -27,7 +21,6 @@ GLAPI void GLAPIENTRY glInterleavedArrays(GLenum format, GLsizei stride, const G
 GLAPI void GLAPIENTRY glPrioritizeTextures(GLsizei n, const GLuint * textures, const GLclampf * priorities);
 GLAPI GLboolean GLAPIENTRY glAreTexturesResident(GLsizei n, const GLuint * textures, GLboolean * residences);
 GLAPI void GLAPIENTRY glTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const GLvoid * pixels);
-GLAPI void GLAPIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid * pixels);
 GLAPI void GLAPIENTRY glCopyTexImage1D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border);
 GLAPI void GLAPIENTRY glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border);
 GLAPI void GLAPIENTRY glCopyTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width);
@@ -1680,8 +1673,13 @@ GLAPI void GLAPIENTRY glGetSeparableFilter(GLenum target, GLenum format, GLenum
  */
 
 // 0 param
-/** */
-function glInit() { }
+/**
+ * Initialize OpenGL. On DOS a 3dfx Voodoo card is used, on Linux a separate window is opened.
+ * If DOjS was compiled for Linux with OSMESA=1 OpenGL renders offscreen into the given Bitmap or the screen. GL.WIDTH and GL.HEIGHT are set to its size.
+ * 
+ * @param {Bitmap} [bm] 32bpp Bitmap to render into (OSMesa only).
+ */
+function glInit(bm) { }
 /** */
 function glShutdown() { }
 /** */
@@ -2326,6 +2324,33 @@ function glTexImage2D(num1, num2, num3, bm) { }
  * @param {Bitmap} bm
  */
 function glTexImage1D(num1, num2, num3, bm) { }
+/**
+ * Replace a region of the bound 2D texture with (a region of) a Bitmap. 32bpp Bitmaps are uploaded without conversion.
+ * 
+ * @param {number} level mipmap level.
+ * @param {number} xoffset left of the region in the texture.
+ * @param {number} yoffset top of the region in the texture.
+ * @param {Bitmap} bm the source Bitmap.
+ * @param {number} [x] left of the region in the Bitmap.
+ * @param {number} [y] top of the region in the Bitmap.
+ * @param {number} [w] width of the region, defaults to the rest of the Bitmap.
+ * @param {number} [h] height of the region, defaults to the rest of the Bitmap.
+ */
+function glTexSubImage2D(level, xoffset, yoffset, bm, x, y, w, h) { }
+/**
+ * Bind the texture of a Bitmap as GL.TEXTURE_2D. The texture is created and uploaded on first use and kept in a cache of 16 Bitmaps (least recently used are dropped).
+ * The Bitmap can't be garbage collected while its texture is cached.
+ * 
+ * @param {Bitmap} bm the Bitmap.
+ * @param {boolean} [update] true to upload the current content of the Bitmap again (e.g. for animated textures).
+ * 
+ * @returns {number} the texture name.
+ */
+function glBitmapTexture(bm, update) { }
+/**
+ * Delete all textures created by glBitmapTexture().
+ */
+function glClearTextureCache() { }
 /**
  * @param {number} num1
  * @param {number} num2
@@ -2391,3 +2416,57 @@ function glBitmap(num1, num2, num3, num4, num5, num6, num7) { }
  * @param {number} num9
  */
 function gluLookAt(num1, num2, num3, num4, num5, num6, num7, num8, num9) { }
+
+// vertex arrays
+/**
+ * Bind a vertex buffer. DoubleArray (GL.DOUBLE) and IntArray (GL.INT) are used by OpenGL directly without copying, they may be modified between draw calls.
+ * JS arrays are converted to floats once when calling this function. Passing null unbinds the buffer.
+ * 
+ * @param {number} size number of components per vertex (2..4).
+ * @param {DoubleArray|IntArray|number[]} buffer vertex data.
+ * @param {number} [stride] distance between two vertices in elements, 0 for tightly packed data.
+ * @param {number} [offset] index of the first element to use.
+ */
+function glVertexPointer(size, buffer, stride, offset) { }
+/**
+ * Bind a color buffer, see glVertexPointer().
+ * 
+ * @param {number} size number of components per color (3 or 4).
+ * @param {DoubleArray|IntArray|number[]} buffer color data.
+ * @param {number} [stride] distance between two colors in elements, 0 for tightly packed data.
+ * @param {number} [offset] index of the first element to use.
+ */
+function glColorPointer(size, buffer, stride, offset) { }
+/**
+ * Bind a normal buffer with three components per normal, see glVertexPointer().
+ * 
+ * @param {DoubleArray|IntArray|number[]} buffer normal data.
+ * @param {number} [stride] distance between two normals in elements, 0 for tightly packed data.
+ * @param {number} [offset] index of the first element to use.
+ */
+function glNormalPointer(buffer, stride, offset) { }
+/**
+ * Bind a texture coordinate buffer, see glVertexPointer().
+ * 
+ * @param {number} size number of components per coordinate (1..4).
+ * @param {DoubleArray|IntArray|number[]} buffer texture coordinates.
+ * @param {number} [stride] distance between two coordinates in elements, 0 for tightly packed data.
+ * @param {number} [offset] index of the first element to use.
+ */
+function glTexCoordPointer(size, buffer, stride, offset) { }
+/**
+ * Render vertices from the enabled arrays (see glEnableClientState()).
+ * 
+ * @param {number} mode primitive type, e.g. GL.TRIANGLES.
+ * @param {number} first first vertex.
+ * @param {number} count number of vertices.
+ */
+function glDrawArrays(mode, first, count) { }
+/**
+ * Render indexed vertices from the enabled arrays (see glEnableClientState()).
+ * 
+ * @param {number} mode primitive type, e.g. GL.TRIANGLES.
+ * @param {IntArray|number[]} indices vertex indices, an IntArray is used without copying.
+ * @param {number} [count] number of indices to use, defaults to all.
+ */
+function glDrawElements(mode, indices, count) { }
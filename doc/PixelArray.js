@@ -0,0 +1,18 @@
+/**
+ * The pixels of a Bitmap or the screen as RGBA bytes, created by Bitmap.GetPixels() and GetScreenPixels().
+ * Entries are accessed like an array (px[i]), there are four entries (red, green, blue, alpha) per pixel, moving from left to right across each row, then down each column.
+ * Values are clamped to 0..255 and writes outside the array are ignored.
+ * In 32bpp mode the memory of the Bitmap is accessed directly, otherwise a copy is made and written back by Update().
+ * @class
+ */
+function PixelArray() {
+	/**
+	 * Number of entries (width * height * 4).
+	 * @member {number}
+	 */
+	this.length = 0;
+}
+/**
+ * must be called after the pixels were modified. Drops the Bitmap.Optimize() data of the Bitmap and writes back the copy if the bitmap is not 32bpp.
+ */
+PixelArray.prototype.Update = function () { };
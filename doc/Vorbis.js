@@ -8,7 +8,7 @@
  * @class
  * 
  * @param {string} filename file name of the soundfile to load.
- * @param {number} [buffersize] playback buffer size, default is 16KiB.
+ * @param {number} [buffersize] playback buffer size, default is 16KiB, at most 1048576 samples.
  */
 function Ogg(filename, buffersize) {
 	/**
@@ -75,13 +75,38 @@ Ogg.prototype.Rewind = function () { };
 Ogg.prototype.CurrentSample = function () { };
 
 /**
+ * start or resume playback, nothing is played before the first call.
  * must be called periodically (e.g. every Loop()) to update the playback buffer.
+ * On Linux the first call starts a background thread that decodes the audio and a timer that passes it to the sound driver, playback continues even if Loop() is slow until Stop() is called.
+ * Playback is always stereo, mono files are played on both channels.
  */
 Ogg.prototype.Play = function () { };
 
+/**
+ * stop (pause) playback, the next Play() continues at the current position.
+ */
+Ogg.prototype.Stop = function () { };
+
 /**
  * move audio to specified sample index.
  * 
  * @param {number} idx new play index
  */
 Ogg.prototype.Seek = function (idx) { };
+
+/**
+ * get playback statistics.
+ * 
+ * @returns {*} an object with the following properties:
+ * 
+ * underruns: number of playback buffers that could not be filled with decoded audio in time
+ * 
+ * decoded: number of samples decoded in total
+ * 
+ * played: number of samples passed to the sound driver since the last seek
+ * 
+ * buffered: number of decoded samples waiting for playback
+ * 
+ * threaded: true if decoding and playback run in the background, only while playing
+ */
+Ogg.prototype.GetStats = function () { };
@@ -284,6 +284,12 @@ function SizeY() { }
  */
 function GetScreenMode() { }
 
+/**
+ * Get the pixels of the screen as RGBA bytes. The same PixelArray is returned on every call, PixelArray.Update() must be called after modifying it.
+ * @returns {PixelArray} the pixels.
+ */
+function GetScreenPixels() { }
+
 /**
  * clear the screen with given color.
  * @param {number} c the color.
@@ -319,6 +325,30 @@ function Line(x1, y1, x2, y2, c) { }
  */
 function CustomLine(x1, y1, x2, y2, w, c) { }
 
+/**
+ * draw connected lines.
+ * @param {number[][]|IntArray} points an array of arrays with two coordinates (e.g. [[1, 1], [1, 10], [10, 10]]) or an IntArray with x/y pairs (e.g. [1, 1, 1, 10, 10, 10]).
+ * @param {number} c color.
+ * @param {boolean} [close] true to connect the last point with the first one.
+ */
+function PolyLine(points, c, close) { }
+
+/**
+ * draw connected lines with given width.
+ * @param {number[][]|IntArray} points an array of arrays with two coordinates or an IntArray with x/y pairs.
+ * @param {number} w line width.
+ * @param {number} c color.
+ * @param {boolean} [close] true to connect the last point with the first one.
+ */
+function CustomPolyLine(points, w, c, close) { }
+
+/**
+ * draw many points with the same color.
+ * @param {number[][]|IntArray} points an array of arrays with two coordinates or an IntArray with x/y pairs.
+ * @param {number} c color.
+ */
+function PlotPoints(points, c) { }
+
 /**
  * draw a box.
  * @param {number} x1 start x coordinate.
@@ -436,11 +466,94 @@ function FloodFill(x, y, bound, c) { }
 
 /**
  * draw a filled polygon.
- * @param {number[][]} points an array of arrays with two coordinates (e.g. [[1, 1], [1, 10], [10, 10], [10, 1]]).
+ * @param {number[][]|IntArray} points an array of arrays with two coordinates (e.g. [[1, 1], [1, 10], [10, 10], [10, 1]]) or an IntArray with x/y pairs. IntArrays are used without copying.
  * @param {number} c color.
  */
 function FilledPolygon(points, c) { }
 
+/**
+ * draw many filled polygons with one call.
+ * @param {number[][]|IntArray} points the vertices of all polygons one after the other, an array of arrays with two coordinates or an IntArray with x/y pairs.
+ * @param {number[]|IntArray} counts the number of vertices for every polygon.
+ * @param {number|number[]|IntArray} c one color for all polygons or one color per polygon.
+ */
+function FilledPolygons(points, counts, c) { }
+
+/**
+ * reset the current 2D transformation to the identity matrix.
+ * The transformation is applied to the coordinates of Plot(), Line(), CustomLine(), PlotPoints(), PolyLine(), CustomPolyLine(), FilledPolygon() and FilledPolygons().
+ */
+function TransformReset() { }
+
+/**
+ * save the current 2D transformation on a stack.
+ */
+function TransformPush() { }
+
+/**
+ * restore the last 2D transformation saved by TransformPush().
+ */
+function TransformPop() { }
+
+/**
+ * multiply the current 2D transformation with the given matrix (x' = a * x + c * y + e, y' = b * x + d * y + f).
+ * @param {number} a matrix value.
+ * @param {number} b matrix value.
+ * @param {number} c matrix value.
+ * @param {number} d matrix value.
+ * @param {number} e matrix value.
+ * @param {number} f matrix value.
+ */
+function TransformApply(a, b, c, d, e, f) { }
+
+/**
+ * add a translation to the current 2D transformation.
+ * @param {number} x translation in x direction.
+ * @param {number} y translation in y direction.
+ */
+function TransformTranslate(x, y) { }
+
+/**
+ * add a rotation to the current 2D transformation.
+ * @param {number} angle the angle in radians.
+ */
+function TransformRotate(angle) { }
+
+/**
+ * add scaling to the current 2D transformation.
+ * @param {number} x scale factor in x direction.
+ * @param {number} [y] scale factor in y direction, defaults to x.
+ */
+function TransformScale(x, y) { }
+
+/**
+ * check if the current 2D transformation is not the identity matrix.
+ * @returns {boolean} true if coordinates are transformed.
+ */
+function TransformActive() { }
+
+/**
+ * get the current 2D transformation.
+ * @returns {number[]} the matrix values [a, b, c, d, e, f].
+ */
+function TransformGet() { }
+
+/**
+ * transform a point with the current 2D transformation.
+ * @param {number} x x coordinate.
+ * @param {number} y y coordinate.
+ * @returns {number} the transformed x coordinate.
+ */
+function TransformX(x, y) { }
+
+/**
+ * transform a point with the current 2D transformation.
+ * @param {number} x x coordinate.
+ * @param {number} y y coordinate.
+ * @returns {number} the transformed y coordinate.
+ */
+function TransformY(x, y) { }
+
 /**
  * Draw a text with the default font.
 * @param {number} x x coordinate.
@@ -605,6 +718,13 @@ function Sleep(ms) { }
  */
 function MsecTime() { }
 
+/**
+ * Get a high resolution monotonic timestamp. In headless mode this is the virtual time that advances by one frame period per frame.
+ * @param {boolean} [real] true to get the real time in headless mode, e.g. for benchmarks.
+ * @returns {number} time in ns.
+ */
+function NsecTime(real) { }
+
 /**
  * check for existence of a file.
  * @param {string} filename name of file to check.
@@ -719,6 +839,101 @@ function SetFramerate(rate) { }
  */
 function GetFramerate() { }
 
+/**
+ * Get statistics for the frame times of the last 128 frames (including the time waited for the frame rate).
+ * @returns {FrameStats} the frame time statistics.
+ */
+function GetFrameStats() { }
+
+/**
+ * Call the optional Update() function with a fixed rate independent of the frame rate.
+ * Update() is called zero or more times before each Loop(), if the script falls behind at most 5 updates are done per frame.
+ * @param {number} hz number of Update() calls per second, 0 to disable.
+ */
+function SetUpdateRate(hz) { }
+
+/**
+ * Get the interpolation factor for rendering between the last and the next Update() in Loop().
+ * @returns {number} a value between 0 (right after an Update()) and 1 (just before the next Update()).
+ */
+function GetUpdateAlpha() { }
+
+/**
+ * Get the time spent in the different phases of the main loop for the last 256 frames, oldest frame first.
+ * @returns {ProfileFrame[]} an array with the phase times of each frame.
+ */
+function GetProfile() { }
+
+/**
+ * Write the phase times of the last 256 frames to a CSV file (one line per frame, all times in ms).
+ * @param {string} fname name of the file.
+ */
+function SaveProfileCSV(fname) { }
+
+/**
+ * Draw the phase times of the last frames as a graph in the lower left corner of the screen. The white line marks the frame time of the wanted frame rate.
+ * The graph can also be toggled by pressing F12.
+ * @param {boolean} enable true to enable the overlay.
+ */
+function SetProfileOverlay(enable) { }
+
+/**
+ * Start recording the screen to an image sequence. After every Loop() the screen is copied into one of the preallocated frames and written to disk by background threads (Linux) as PREFIXnnnnn.EXT.
+ * If all frames are still waiting to be written the current frame is dropped, so recording does not slow down the script. On DOS the frames are written immediately.
+ * 'tga' is always available, 'png' and 'qoi' need the corresponding libraries (e.g. LoadLibrary("qoi")).
+ * @param {string} prefix file name prefix, may include a directory.
+ * @param {string} [format] file format: 'tga' (default), 'png' or 'qoi'.
+ * @param {number} [slots] number of preallocated frames (1..64, default 8).
+ * @param {number} [threads] number of encoder threads (0..8, default 2), 0 writes the frames on the main thread (Linux).
+ */
+function StartRecording(prefix, format, slots, threads) { }
+
+/**
+ * Stop recording and wait until all frames are written.
+ * @returns {RecorderStats} the statistics of the recording.
+ */
+function StopRecording() { }
+
+/**
+ * Get the statistics of the current or last recording.
+ * @returns {RecorderStats} the statistics of the recording.
+ */
+function GetRecorderStats() { }
+
+/**
+ * Get statistics for the cache of decoded images. Bitmaps loaded from the same file share the decoded image until one of them is modified.
+ * @returns {ImageCacheInfo} an info object.
+ */
+function ImageCacheStats() { }
+
+/**
+ * Set the maximum amount of memory the image cache may use. Images still in use by a Bitmap are never evicted.
+ * @param {number} bytes the new limit in bytes, 0 disables the cache.
+ */
+function SetImageCacheSize(bytes) { }
+
+/**
+ * Remove all unused images from the image cache and reset the statistics.
+ */
+function ClearImageCache() { }
+
+/**
+ * Get statistics for the cache of rendered strings used by {@link TextXY} and the Font.DrawString*() methods.
+ * @returns {TextCacheInfo} an info object.
+ */
+function TextCacheStats() { }
+
+/**
+ * Set the maximum amount of memory used for rendered strings.
+ * @param {number} bytes the new limit in bytes, 0 disables the cache.
+ */
+function SetTextCacheSize(bytes) { }
+
+/**
+ * Remove all strings from the text cache and reset the statistics.
+ */
+function ClearTextCache() { }
+
 /**
  * Change the exit key from ESCAPE to any other keycode from {@link KEY}}.
  * @param {number} key 
@@ -859,6 +1074,30 @@ function GetBlue(c) { }
  */
 function GetAlpha(c) { }
 
+/**
+ * convert p5js style color arguments to a color. Results are cached, repeated calls with the same arguments only cost a hash lookup.
+ * @param {string} mode color mode: "rgb", "hsb" or "hsl".
+ * @param {number[]} maxes the maximum values for the four components in this mode.
+ * @param {*[]} args the color: a gray value (and alpha), three or four component values or a CSS color string (named, hex, rgb(a), hsl(a), hsb(a)).
+ * @returns {number} the color.
+ */
+function ColorFromArgs(mode, maxes, args) { }
+
+/**
+ * convert p5js style color arguments to RGBA components normalized to 0..1.
+ * @param {string} mode color mode: "rgb", "hsb" or "hsl".
+ * @param {number[]} maxes the maximum values for the four components in this mode.
+ * @param {*[]} args the color, see {@link ColorFromArgs}.
+ * @returns {number[]} the normalized [r, g, b, a] components.
+ */
+function ColorFromArgsRGBA(mode, maxes, args) { }
+
+/**
+ * Get statistics for the cache used by {@link ColorFromArgs}.
+ * @returns {ColorCacheInfo} an info object.
+ */
+function ColorCacheStats() { }
+
 /**
  * **Note: al3d module must be loaded by calling LoadLibrary("al3d") before using!**
  * 
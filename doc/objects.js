@@ -58,11 +58,69 @@ class StatInfo { }
 class MemInfo { }
 
 /**
- * @typedef {object} Matrix
- * @property {number[][]} v the 3x3 matrix data.
- * @property {number[]} t the translation data.
+ * @typedef {object} ImageCacheInfo
+ * @property {number} hits number of images that were taken from the cache.
+ * @property {number} misses number of images that had to be decoded.
+ * @property {number} evictions number of images dropped from the cache.
+ * @property {number} entries number of images currently in the cache.
+ * @property {number} bytes memory used by the cached images.
+ * @property {number} limit maximum memory the cache may use.
  */
-class Matrix { }
+class ImageCacheInfo { }
+
+/**
+ * @typedef {object} TextCacheInfo
+ * @property {number} hits number of strings that were drawn from the cache.
+ * @property {number} misses number of strings that had to be rendered.
+ * @property {number} evictions number of strings dropped from the cache.
+ * @property {number} entries number of strings currently in the cache.
+ * @property {number} bytes memory used by the cached strings.
+ * @property {number} limit maximum memory the cache may use.
+ */
+class TextCacheInfo { }
+
+/**
+ * @typedef {object} ColorCacheInfo
+ * @property {number} hits number of colors that were taken from the cache.
+ * @property {number} misses number of colors that had to be converted.
+ * @property {number} entries number of colors currently in the cache.
+ */
+class ColorCacheInfo { }
+
+/**
+ * @typedef {object} FrameStats
+ * @property {number} min shortest frame time in ms.
+ * @property {number} avg average frame time in ms.
+ * @property {number} max longest frame time in ms.
+ * @property {number} p99 99th percentile of the frame times in ms.
+ * @property {number} frames number of frames in the statistics.
+ */
+class FrameStats { }
+
+/**
+ * @typedef {object} ProfileFrame
+ * @property {number} gc time in ms for the garbage collection.
+ * @property {number} socket time in ms for socket housekeeping.
+ * @property {number} update time in ms for all Update() calls.
+ * @property {number} loop time in ms for Loop().
+ * @property {number} input time in ms for input polling and Input().
+ * @property {number} blit time in ms to copy the render bitmap to the screen.
+ * @property {number} sleep time in ms waited for the frame rate.
+ * @property {number} total sum of all phases in ms.
+ */
+class ProfileFrame { }
+
+/**
+ * @typedef {object} RecorderStats
+ * @property {number} captured number of frames offered to the recorder (including dropped frames).
+ * @property {number} written number of frames written to disk.
+ * @property {number} dropped number of frames dropped because all slots were waiting to be written.
+ * @property {number} failed number of frames that could not be written.
+ * @property {number} pending number of frames currently waiting to be written.
+ * @property {number} maxPending highest number of frames waiting at the same time.
+ * @property {number} captureMs average time in ms the main loop spent copying a frame.
+ */
+class RecorderStats { }
 
 /**
  * A vertex with x, y, z, u, v and c represented as an array of six numbers (e.g. [1, 1, 1, 0, 0, EGA.BLACK])
@@ -751,12 +751,18 @@ function NPerspProject(x, y, z) {
 /**
  * Allocates memory for a scene, `nedge' and `npoly' are your estimates of how many edges and how many polygons you will render (you cannot get over the limit specified here).
  * 
+ * If `threads' is given the scene is rendered by the tiled renderer instead: polygons are sorted into 64x64 tiles which are drawn in parallel by `threads' render threads (on DOS the tiles are drawn one after another) using a z-buffer.
+ * The tiled renderer only supports convex polygons and changes the current ZBuffer during RenderScene().
+ * Its output is not identical to the default renderer: visibility is decided per pixel by the z-buffer, so pixels differ where polygons intersect or touch at the same depth.
+ * Consecutive polygons of different perspective textured POLYTYPEs are rendered one after another, mixing them reduces the speedup.
+ * 
  * @param {number} nedge max number of edges.
  * @param {number} npoly max number of polygons.
+ * @param {number} [threads] number of render threads for the tiled renderer.
  */
-function CreateScene(nedge, npoly) {
+function CreateScene(nedge, npoly, threads) {
 	_bitmap_array = [];
-	_CreateScene(nedge, npoly);
+	_CreateScene(nedge, npoly, threads);
 }
 
 /**
@@ -93,6 +93,11 @@ var EGA = {
 */
 var NO_COLOR = -1;
 
+/**
+* @property {Color} MASK_COLOR the mask Color, pixels of this Color are skipped by Bitmap.DrawMasked() and Bitmap.DrawTrans().
+*/
+var MASK_COLOR = Color(255, 0, 255, 0);
+
 /**
  * blend mode definitions for TransparencyEnabled()
  * 
@@ -694,6 +694,18 @@ var SYSTEM = {
 	TIMER: 0x10
 };
 
+/**
+ * optimization modes for Bitmap.Optimize().
+ * @property {*} NONE plain Bitmap, drawn with the generic blitter
+ * @property {*} RLE run length encoded sprite, fast for sprites with large transparent areas
+ * @property {*} COMPILED compiled sprite, fastest when drawn fully on screen
+ */
+var SPRITE = {
+	NONE: 0,
+	RLE: 1,
+	COMPILED: 2
+};
+
 /**
  * event interface.
  * @property {*} Mode.NONE no cursor
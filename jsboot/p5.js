@@ -57,8 +57,7 @@ exports._currentEnv = {
 	_rectMode: CORNER,
 	_ellipseMode: CENTER,
 	_imageMode: CORNER,
-	_strokeWeight: 1,
-	_matrix: null
+	_strokeWeight: 1
 };
 
 // TODO: implement matrix preservation for setup() and draw()
@@ -67,17 +66,6 @@ exports._currentEnv = {
  * deep copy the current environment.
  */
 exports._cloneEnv = function () {
-	if (_currentEnv._matrix) {
-		// deep copy matrix
-		var matrix = [
-			_currentEnv._matrix[0].slice(0),
-			_currentEnv._matrix[1].slice(0),
-			_currentEnv._matrix[2].slice(0)
-		]
-	} else {
-		var matrix = null;
-	}
-
 	return {
 		_fill: _currentEnv._fill,
 		_stroke: _currentEnv._stroke,
@@ -94,8 +82,7 @@ exports._cloneEnv = function () {
 		_rectMode: _currentEnv._rectMode,
 		_ellipseMode: _currentEnv._ellipseMode,
 		_imageMode: _currentEnv._imageMode,
-		_strokeWeight: _currentEnv._strokeWeight,
-		_matrix: matrix
+		_strokeWeight: _currentEnv._strokeWeight
 	};
 }
 
@@ -628,6 +615,7 @@ exports.loadBytes = function (fname) {
  */
 exports.push = function () {
 	_env.push(_cloneEnv());
+	TransformPush();
 };
 
 /**
@@ -680,6 +668,7 @@ exports.push = function () {
 exports.pop = function () {
 	if (_env.length > 0) {
 		_currentEnv = _env.pop();
+		TransformPop();
 	} else {
 		console.warn('pop() was called without matching push()');
 	}
@@ -316,22 +316,27 @@ exports.p5Color = function (vals) {
 	// Record color mode and maxes at time of construction.
 	this._storeModeAndMaxes(_currentEnv._colorMode, _currentEnv._colorMaxes);
 
-	// Calculate normalized RGBA values.
-	if (
-		this.mode !== RGB &&
-		this.mode !== HSL &&
-		this.mode !== HSB
-	) {
-		throw new Error(this.mode + ' is an invalid colorMode.');
-	} else {
-		this._array = p5Color._parseInputs.apply(this, vals);
-	}
+	// Calculate normalized RGBA values (throws on invalid color modes).
+	this._array = ColorFromArgsRGBA(this.mode, this.maxes[this.mode], vals);
 
 	// Expose closest screen color.
 	this._calculateLevels();
 	return this;
 };
 
+/**
+ * convert color arguments in the current color mode directly to an Allegro color.
+ * The conversion is done natively and cached, so calling fill('#ff8800') every frame only costs a hash lookup.
+ *
+ * @private
+ * @param {Array} args an 'array-like' object with the arguments passed to fill()/stroke()/background().
+ * @returns {number} an Allegro color.
+ */
+exports._colorToAllegro = function (args) {
+	var mode = _currentEnv._colorMode;
+	return ColorFromArgs(mode, _currentEnv._colorMaxes[mode], args);
+};
+
 exports.p5Color.prototype.toAllegro = function () {
 	var a = this.levels;
 	// FIX: alpha can never be 255 because the resulting integer for WHITE would be -1 and that is equal to 'no color'
@@ -716,309 +721,6 @@ exports.p5Color.prototype._getSaturation = function () {
 	}
 };
 
-/**
- * CSS named colors.
- */
-var namedColors = {
-	aliceblue: '#f0f8ff',
-	antiquewhite: '#faebd7',
-	aqua: '#00ffff',
-	aquamarine: '#7fffd4',
-	azure: '#f0ffff',
-	beige: '#f5f5dc',
-	bisque: '#ffe4c4',
-	black: '#000000',
-	blanchedalmond: '#ffebcd',
-	blue: '#0000ff',
-	blueviolet: '#8a2be2',
-	brown: '#a52a2a',
-	burlywood: '#deb887',
-	cadetblue: '#5f9ea0',
-	chartreuse: '#7fff00',
-	chocolate: '#d2691e',
-	coral: '#ff7f50',
-	cornflowerblue: '#6495ed',
-	cornsilk: '#fff8dc',
-	crimson: '#dc143c',
-	cyan: '#00ffff',
-	darkblue: '#00008b',
-	darkcyan: '#008b8b',
-	darkgoldenrod: '#b8860b',
-	darkgray: '#a9a9a9',
-	darkgreen: '#006400',
-	darkgrey: '#a9a9a9',
-	darkkhaki: '#bdb76b',
-	darkmagenta: '#8b008b',
-	darkolivegreen: '#556b2f',
-	darkorange: '#ff8c00',
-	darkorchid: '#9932cc',
-	darkred: '#8b0000',
-	darksalmon: '#e9967a',
-	darkseagreen: '#8fbc8f',
-	darkslateblue: '#483d8b',
-	darkslategray: '#2f4f4f',
-	darkslategrey: '#2f4f4f',
-	darkturquoise: '#00ced1',
-	darkviolet: '#9400d3',
-	deeppink: '#ff1493',
-	deepskyblue: '#00bfff',
-	dimgray: '#696969',
-	dimgrey: '#696969',
-	dodgerblue: '#1e90ff',
-	firebrick: '#b22222',
-	floralwhite: '#fffaf0',
-	forestgreen: '#228b22',
-	fuchsia: '#ff00ff',
-	gainsboro: '#dcdcdc',
-	ghostwhite: '#f8f8ff',
-	gold: '#ffd700',
-	goldenrod: '#daa520',
-	gray: '#808080',
-	green: '#008000',
-	greenyellow: '#adff2f',
-	grey: '#808080',
-	honeydew: '#f0fff0',
-	hotpink: '#ff69b4',
-	indianred: '#cd5c5c',
-	indigo: '#4b0082',
-	ivory: '#fffff0',
-	khaki: '#f0e68c',
-	lavender: '#e6e6fa',
-	lavenderblush: '#fff0f5',
-	lawngreen: '#7cfc00',
-	lemonchiffon: '#fffacd',
-	lightblue: '#add8e6',
-	lightcoral: '#f08080',
-	lightcyan: '#e0ffff',
-	lightgoldenrodyellow: '#fafad2',
-	lightgray: '#d3d3d3',
-	lightgreen: '#90ee90',
-	lightgrey: '#d3d3d3',
-	lightpink: '#ffb6c1',
-	lightsalmon: '#ffa07a',
-	lightseagreen: '#20b2aa',
-	lightskyblue: '#87cefa',
-	lightslategray: '#778899',
-	lightslategrey: '#778899',
-	lightsteelblue: '#b0c4de',
-	lightyellow: '#ffffe0',
-	lime: '#00ff00',
-	limegreen: '#32cd32',
-	linen: '#faf0e6',
-	magenta: '#ff00ff',
-	maroon: '#800000',
-	mediumaquamarine: '#66cdaa',
-	mediumblue: '#0000cd',
-	mediumorchid: '#ba55d3',
-	mediumpurple: '#9370db',
-	mediumseagreen: '#3cb371',
-	mediumslateblue: '#7b68ee',
-	mediumspringgreen: '#00fa9a',
-	mediumturquoise: '#48d1cc',
-	mediumvioletred: '#c71585',
-	midnightblue: '#191970',
-	mintcream: '#f5fffa',
-	mistyrose: '#ffe4e1',
-	moccasin: '#ffe4b5',
-	navajowhite: '#ffdead',
-	navy: '#000080',
-	oldlace: '#fdf5e6',
-	olive: '#808000',
-	olivedrab: '#6b8e23',
-	orange: '#ffa500',
-	orangered: '#ff4500',
-	orchid: '#da70d6',
-	palegoldenrod: '#eee8aa',
-	palegreen: '#98fb98',
-	paleturquoise: '#afeeee',
-	palevioletred: '#db7093',
-	papayawhip: '#ffefd5',
-	peachpuff: '#ffdab9',
-	peru: '#cd853f',
-	pink: '#ffc0cb',
-	plum: '#dda0dd',
-	powderblue: '#b0e0e6',
-	purple: '#800080',
-	red: '#ff0000',
-	rosybrown: '#bc8f8f',
-	royalblue: '#4169e1',
-	saddlebrown: '#8b4513',
-	salmon: '#fa8072',
-	sandybrown: '#f4a460',
-	seagreen: '#2e8b57',
-	seashell: '#fff5ee',
-	sienna: '#a0522d',
-	silver: '#c0c0c0',
-	skyblue: '#87ceeb',
-	slateblue: '#6a5acd',
-	slategray: '#708090',
-	slategrey: '#708090',
-	snow: '#fffafa',
-	springgreen: '#00ff7f',
-	steelblue: '#4682b4',
-	tan: '#d2b48c',
-	teal: '#008080',
-	thistle: '#d8bfd8',
-	tomato: '#ff6347',
-	turquoise: '#40e0d0',
-	violet: '#ee82ee',
-	wheat: '#f5deb3',
-	white: '#ffffff',
-	whitesmoke: '#f5f5f5',
-	yellow: '#ffff00',
-	yellowgreen: '#9acd32'
-};
-
-/**
- * These regular expressions are used to build up the patterns for matching
- * viable CSS color strings: fragmenting the regexes in this way increases the
- * legibility and comprehensibility of the code.
- *
- * Note that RGB values of .9 are not parsed by IE, but are supported here for
- * color string consistency.
- */
-var WHITESPACE = /\s*/; // Match zero or more whitespace characters.
-var INTEGER = /(\d{1,3})/; // Match integers: 79, 255, etc.
-var DECIMAL = /((?:\d+(?:\.\d+)?)|(?:\.\d+))/; // Match 129.6, 79, .9, etc.
-var PERCENT = new RegExp(DECIMAL.source + '%'); // Match 12.9%, 79%, .9%, etc.
-
-/**
- * Full color string patterns. The capture groups are necessary.
- */
-var colorPatterns = {
-	// Match colors in format #XXX, e.g. #416.
-	HEX3: /^#([a-f0-9])([a-f0-9])([a-f0-9])$/i,
-
-	// Match colors in format #XXXX, e.g. #5123.
-	HEX4: /^#([a-f0-9])([a-f0-9])([a-f0-9])([a-f0-9])$/i,
-
-	// Match colors in format #XXXXXX, e.g. #b4d455.
-	HEX6: /^#([a-f0-9]{2})([a-f0-9]{2})([a-f0-9]{2})$/i,
-
-	// Match colors in format #XXXXXXXX, e.g. #b4d45535.
-	HEX8: /^#([a-f0-9]{2})([a-f0-9]{2})([a-f0-9]{2})([a-f0-9]{2})$/i,
-
-	// Match colors in format rgb(R, G, B), e.g. rgb(255, 0, 128).
-	RGB: new RegExp(
-		[
-			'^rgb\\(',
-			INTEGER.source,
-			',',
-			INTEGER.source,
-			',',
-			INTEGER.source,
-			'\\)$'
-		].join(WHITESPACE.source),
-		'i'
-	),
-
-	// Match colors in format rgb(R%, G%, B%), e.g. rgb(100%, 0%, 28.9%).
-	RGB_PERCENT: new RegExp(
-		[
-			'^rgb\\(',
-			PERCENT.source,
-			',',
-			PERCENT.source,
-			',',
-			PERCENT.source,
-			'\\)$'
-		].join(WHITESPACE.source),
-		'i'
-	),
-
-	// Match colors in format rgb(R, G, B, A), e.g. rgb(255, 0, 128, 0.25).
-	RGBA: new RegExp(
-		[
-			'^rgba\\(',
-			INTEGER.source,
-			',',
-			INTEGER.source,
-			',',
-			INTEGER.source,
-			',',
-			DECIMAL.source,
-			'\\)$'
-		].join(WHITESPACE.source),
-		'i'
-	),
-
-	// Match colors in format rgb(R%, G%, B%, A), e.g. rgb(100%, 0%, 28.9%, 0.5).
-	RGBA_PERCENT: new RegExp(
-		[
-			'^rgba\\(',
-			PERCENT.source,
-			',',
-			PERCENT.source,
-			',',
-			PERCENT.source,
-			',',
-			DECIMAL.source,
-			'\\)$'
-		].join(WHITESPACE.source),
-		'i'
-	),
-
-	// Match colors in format hsla(H, S%, L%), e.g. hsl(100, 40%, 28.9%).
-	HSL: new RegExp(
-		[
-			'^hsl\\(',
-			INTEGER.source,
-			',',
-			PERCENT.source,
-			',',
-			PERCENT.source,
-			'\\)$'
-		].join(WHITESPACE.source),
-		'i'
-	),
-
-	// Match colors in format hsla(H, S%, L%, A), e.g. hsla(100, 40%, 28.9%, 0.5).
-	HSLA: new RegExp(
-		[
-			'^hsla\\(',
-			INTEGER.source,
-			',',
-			PERCENT.source,
-			',',
-			PERCENT.source,
-			',',
-			DECIMAL.source,
-			'\\)$'
-		].join(WHITESPACE.source),
-		'i'
-	),
-
-	// Match colors in format hsb(H, S%, B%), e.g. hsb(100, 40%, 28.9%).
-	HSB: new RegExp(
-		[
-			'^hsb\\(',
-			INTEGER.source,
-			',',
-			PERCENT.source,
-			',',
-			PERCENT.source,
-			'\\)$'
-		].join(WHITESPACE.source),
-		'i'
-	),
-
-	// Match colors in format hsba(H, S%, B%, A), e.g. hsba(100, 40%, 28.9%, 0.5).
-	HSBA: new RegExp(
-		[
-			'^hsba\\(',
-			INTEGER.source,
-			',',
-			PERCENT.source,
-			',',
-			PERCENT.source,
-			',',
-			DECIMAL.source,
-			'\\)$'
-		].join(WHITESPACE.source),
-		'i'
-	)
-};
-
 /**
  * For a number of different inputs, returns a color formatted as [r, g, b, a]
  * arrays, with each component normalized between 0 and 1.
@@ -1026,6 +728,8 @@ var colorPatterns = {
  * @private
  * @param {Array} [...args] An 'array-like' object that represents a list of
  *                          arguments
+ * CSS color strings (named, hex, rgb(a), hsl(a), hsb(a)) are parsed natively.
+ *
  * @return {Number[]}       a color formatted as [r, g, b, a]
  *                          Example:
  *                          input        ==> output
@@ -1041,227 +745,7 @@ var colorPatterns = {
  * // todo
  */
 exports.p5Color._parseInputs = function (r, g, b, a) {
-	var numArgs = arguments.length;
-	var mode = this.mode;
-	var maxes = this.maxes[mode];
-	var results = [];
-	var i;
-
-	if (numArgs >= 3) {
-		// Argument is a list of component values.
-
-		results[0] = r / maxes[0];
-		results[1] = g / maxes[1];
-		results[2] = b / maxes[2];
-
-		// Alpha may be undefined, so default it to 100%.
-		if (typeof a === 'number') {
-			results[3] = a / maxes[3];
-		} else {
-			results[3] = 1;
-		}
-
-		// Constrain components to the range [0,1].
-		// (loop backwards for performance)
-		for (i = results.length - 1; i >= 0; --i) {
-			var result = results[i];
-			if (result < 0) {
-				results[i] = 0;
-			} else if (result > 1) {
-				results[i] = 1;
-			}
-		}
-
-		// Convert to RGBA and return.
-		if (mode === HSL) {
-			return ColorConversion._hslaToRGBA(results);
-		} else if (mode === HSB) {
-			return ColorConversion._hsbaToRGBA(results);
-		} else {
-			return results;
-		}
-	} else if (numArgs === 1 && typeof r === 'string') {
-		var str = r.trim().toLowerCase();
-
-		// Return if string is a named colour.
-		if (namedColors[str]) {
-			return p5Color._parseInputs.call(this, namedColors[str]);
-		}
-
-		// Try RGBA pattern matching.
-		if (colorPatterns.HEX3.test(str)) {
-			// #rgb
-			results = colorPatterns.HEX3.exec(str)
-				.slice(1)
-				.map(function (color) {
-					return parseInt(color + color, 16) / 255;
-				});
-			results[3] = 1;
-			return results;
-		} else if (colorPatterns.HEX6.test(str)) {
-			// #rrggbb
-			results = colorPatterns.HEX6.exec(str)
-				.slice(1)
-				.map(function (color) {
-					return parseInt(color, 16) / 255;
-				});
-			results[3] = 1;
-			return results;
-		} else if (colorPatterns.HEX4.test(str)) {
-			// #rgba
-			results = colorPatterns.HEX4.exec(str)
-				.slice(1)
-				.map(function (color) {
-					return parseInt(color + color, 16) / 255;
-				});
-			return results;
-		} else if (colorPatterns.HEX8.test(str)) {
-			// #rrggbbaa
-			results = colorPatterns.HEX8.exec(str)
-				.slice(1)
-				.map(function (color) {
-					return parseInt(color, 16) / 255;
-				});
-			return results;
-		} else if (colorPatterns.RGB.test(str)) {
-			// rgb(R,G,B)
-			results = colorPatterns.RGB.exec(str)
-				.slice(1)
-				.map(function (color) {
-					return color / 255;
-				});
-			results[3] = 1;
-			return results;
-		} else if (colorPatterns.RGB_PERCENT.test(str)) {
-			// rgb(R%,G%,B%)
-			results = colorPatterns.RGB_PERCENT.exec(str)
-				.slice(1)
-				.map(function (color) {
-					return parseFloat(color) / 100;
-				});
-			results[3] = 1;
-			return results;
-		} else if (colorPatterns.RGBA.test(str)) {
-			// rgba(R,G,B,A)
-			results = colorPatterns.RGBA.exec(str)
-				.slice(1)
-				.map(function (color, idx) {
-					if (idx === 3) {
-						return parseFloat(color);
-					}
-					return color / 255;
-				});
-			return results;
-		} else if (colorPatterns.RGBA_PERCENT.test(str)) {
-			// rgba(R%,G%,B%,A%)
-			results = colorPatterns.RGBA_PERCENT.exec(str)
-				.slice(1)
-				.map(function (color, idx) {
-					if (idx === 3) {
-						return parseFloat(color);
-					}
-					return parseFloat(color) / 100;
-				});
-			return results;
-		}
-
-		// Try HSLA pattern matching.
-		if (colorPatterns.HSL.test(str)) {
-			// hsl(H,S,L)
-			results = colorPatterns.HSL.exec(str)
-				.slice(1)
-				.map(function (color, idx) {
-					if (idx === 0) {
-						return parseInt(color, 10) / 360;
-					}
-					return parseInt(color, 10) / 100;
-				});
-			results[3] = 1;
-		} else if (colorPatterns.HSLA.test(str)) {
-			// hsla(H,S,L,A)
-			results = colorPatterns.HSLA.exec(str)
-				.slice(1)
-				.map(function (color, idx) {
-					if (idx === 0) {
-						return parseInt(color, 10) / 360;
-					} else if (idx === 3) {
-						return parseFloat(color);
-					}
-					return parseInt(color, 10) / 100;
-				});
-		}
-		results = results.map(function (value) {
-			return Math.max(Math.min(value, 1), 0);
-		});
-		if (results.length) {
-			return ColorConversion._hslaToRGBA(results);
-		}
-
-		// Try HSBA pattern matching.
-		if (colorPatterns.HSB.test(str)) {
-			// hsb(H,S,B)
-			results = colorPatterns.HSB.exec(str)
-				.slice(1)
-				.map(function (color, idx) {
-					if (idx === 0) {
-						return parseInt(color, 10) / 360;
-					}
-					return parseInt(color, 10) / 100;
-				});
-			results[3] = 1;
-		} else if (colorPatterns.HSBA.test(str)) {
-			// hsba(H,S,B,A)
-			results = colorPatterns.HSBA.exec(str)
-				.slice(1)
-				.map(function (color, idx) {
-					if (idx === 0) {
-						return parseInt(color, 10) / 360;
-					} else if (idx === 3) {
-						return parseFloat(color);
-					}
-					return parseInt(color, 10) / 100;
-				});
-		}
-
-		if (results.length) {
-			// (loop backwards for performance)
-			for (i = results.length - 1; i >= 0; --i) {
-				results[i] = Math.max(Math.min(results[i], 1), 0);
-			}
-
-			return ColorConversion._hsbaToRGBA(results);
-		}
-
-		// Input did not match any CSS color pattern: default to white.
-		results = [1, 1, 1, 1];
-	} else if ((numArgs === 1 || numArgs === 2) && typeof r === 'number') {
-		// 'Grayscale' mode.
-
-		/**
-		 * For HSB and HSL, interpret the gray level as a brightness/lightness
-		 * value (they are equivalent when chroma is zero). For RGB, normalize the
-		 * gray level according to the blue maximum.
-		 */
-		results[0] = r / maxes[2];
-		results[1] = r / maxes[2];
-		results[2] = r / maxes[2];
-
-		// Alpha may be undefined, so default it to 100%.
-		if (typeof g === 'number') {
-			results[3] = g / maxes[3];
-		} else {
-			results[3] = 1;
-		}
-
-		// Constrain components to the range [0,1].
-		results = results.map(function (value) {
-			return Math.max(Math.min(value, 1), 0);
-		});
-	} else {
-		throw new Error(arguments + 'is not a valid color representation.');
-	}
-
-	return results;
+	return ColorFromArgsRGBA(this.mode, this.maxes[this.mode], arguments);
 };
 
 /**********************************************************************************************************************
@@ -1804,7 +1288,7 @@ exports.background = function () {
 		if (arguments[0] instanceof p5Color) {
 			_background = arguments[0].toAllegro()
 		} else {
-			_background = new p5Color(arguments).toAllegro();
+			_background = _colorToAllegro(arguments);
 		}
 		FilledBox(0, 0, SizeX(), SizeY(), _background);
 	}
@@ -2024,7 +1508,7 @@ exports.fill = function () {
 	if (arguments[0] instanceof p5Color) {
 		_currentEnv._fill = arguments[0].toAllegro();
 	} else {
-		_currentEnv._fill = new p5Color(arguments).toAllegro();
+		_currentEnv._fill = _colorToAllegro(arguments);
 	}
 };
 
@@ -2187,6 +1671,6 @@ exports.stroke = function () {
 	if (arguments[0] instanceof p5Color) {
 		_currentEnv._stroke = arguments[0].toAllegro()
 	} else {
-		_currentEnv._stroke = new p5Color(arguments).toAllegro();
+		_currentEnv._stroke = _colorToAllegro(arguments);
 	}
 };
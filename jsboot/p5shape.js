@@ -186,15 +186,11 @@ exports.circle = function (x, y, r) {
  */
 exports.line = function (x1, y1, x2, y2) {
 	if (_currentEnv._stroke != NO_COLOR) {
-		var tx1 = _transX(x1, y1);
-		var ty1 = _transY(x1, y1);
-		var tx2 = _transX(x2, y2);
-		var ty2 = _transY(x2, y2);
-
+		// the current matrix is applied by Line()/CustomLine()
 		if (_currentEnv._strokeWeight == 1) {
-			Line(tx1, ty1, tx2, ty2, _currentEnv._stroke);
+			Line(x1, y1, x2, y2, _currentEnv._stroke);
 		} else {
-			CustomLine(tx1, ty1, tx2, ty2, _currentEnv._strokeWeight, _currentEnv._stroke);
+			CustomLine(x1, y1, x2, y2, _currentEnv._strokeWeight, _currentEnv._stroke);
 		}
 	}
 };
@@ -217,7 +213,7 @@ exports.line = function (x1, y1, x2, y2) {
  */
 exports.point = function (x, y) {
 	if (_currentEnv._stroke != NO_COLOR) {
-		Plot(_transX(x, y), _transY(x, y), _currentEnv._stroke);
+		Plot(x, y, _currentEnv._stroke);
 	}
 };
 
@@ -272,7 +268,7 @@ exports.quad = function (x1, y1, x2, y2, x3, y3, x4, y4) {
  * rect(30, 20, 55, 55);
  */
 exports.rect = function (x, y, w, h) {
-	if (_currentEnv._matrix || _currentEnv._strokeWeight > 1) {
+	if (TransformActive() || _currentEnv._strokeWeight > 1) {
 		beginShape();
 		if (_currentEnv._rectMode === CORNER) {
 			vertex(x, y);
@@ -487,7 +483,8 @@ exports.beginShape = function (m) {
  * endShape();
  */
 exports.vertex = function (x, y) {
-	_shape.push([_transX(x, y), _transY(x, y)]);
+	// the current matrix is applied when the shape is drawn
+	_shape.push([x, y]);
 };
 
 /**
@@ -518,9 +515,7 @@ exports.vertex = function (x, y) {
  */
 exports.endShape = function (p) {
 	if (_shapeMode === POINTS) {
-		_shape.forEach(function (p) {
-			Plot(p[0], p[1], _currentEnv._stroke);
-		});
+		PlotPoints(_shape, _currentEnv._stroke);
 	} else if (_shapeMode === LINES) {
 		for (var i = 0; i < _shape.length; i += 2) {
 			if (_currentEnv._strokeWeight == 1) {
@@ -553,20 +548,10 @@ exports.endShape = function (p) {
  * draw polygon by using lines.
  */
 exports._PolyLine = function (shape, close) {
-	for (var i = 0; i < shape.length - 1; i++) {
-		if (_currentEnv._strokeWeight == 1) {
-			Line(shape[i][0], shape[i][1], shape[i + 1][0], shape[i + 1][1], _currentEnv._stroke);
-		} else {
-			CustomLine(shape[i][0], shape[i][1], shape[i + 1][0], shape[i + 1][1], _currentEnv._strokeWeight, _currentEnv._stroke);
-		}
-	}
-	if (close) {
-		var last = shape.length - 1;
-		if (_currentEnv._strokeWeight == 1) {
-			Line(shape[0][0], shape[0][1], shape[last][0], shape[last][1], _currentEnv._stroke);
-		} else {
-			CustomLine(shape[0][0], shape[0][1], shape[last][0], shape[last][1], _currentEnv._strokeWeight, _currentEnv._stroke);
-		}
+	if (_currentEnv._strokeWeight == 1) {
+		PolyLine(shape, _currentEnv._stroke, close);
+	} else {
+		CustomPolyLine(shape, _currentEnv._strokeWeight, _currentEnv._stroke, close);
 	}
 }
 
@@ -703,7 +688,14 @@ exports.loadImage = function (path) {
 		this.width = this.bm.width;
 		this.height = this.bm.height;
 	};
-	ret.prototype.loadPixels = function () { };
+	ret.prototype.loadPixels = function () {
+		this.pixels = this.bm.GetPixels();
+	};
+	ret.prototype.updatePixels = function () {
+		if (this.pixels) {
+			this.pixels.Update();
+		}
+	};
 	ret.prototype.get = function (x, y) {	// TODO: check!
 		var px = this.bm.GetPixel(x, y);
 		return color(GetRed(px), GetGreen(px), GetBlue(px), 255);
@@ -776,13 +768,20 @@ exports.createImage = function (width, height) {
 		this.width = this.bm.width;
 		this.height = this.bm.height;
 	};
-	ret.prototype.loadPixels = function () { };
+	ret.prototype.loadPixels = function () {
+		this.pixels = this.bm.GetPixels();
+	};
+	ret.prototype.updatePixels = function () {
+		if (this.pixels) {
+			this.pixels.Update();
+		}
+	};
 	ret.prototype.get = function (x, y) {	// TODO: check!
 		var px = this.bm.GetPixel(x, y);
 		return color(GetRed(px), GetGreen(px), GetBlue(px), 255);
 	};
 
-	return new ret(path);
+	return new ret();
 };
 
 /**
@@ -834,6 +833,57 @@ exports.image = function (img, x, y) {
 	img.bm.Draw(_transX(x1, y1), _transY(x1, y1));
 };
 
+/**
+ * Uint8ClampedArray like object containing the values for all the pixels in
+ * the display window. These values are numbers. This array is the size
+ * (including an appropriate factor for pixelDensity) of the display window
+ * x4, representing the R, G, B, A values in order for each pixel, moving
+ * from left to right across each row, then down each column.
+ * <br><br>
+ * The array directly accesses the screen memory when running in 32bpp mode,
+ * changes are visible without copying.
+ * <br><br>
+ * Before accessing this array, the data must loaded with the loadPixels()
+ * function. After the array data has been modified, the updatePixels()
+ * function must be run to update the changes.
+ *
+ * @property {PixelArray} pixels
+ * @example
+ * let pink = color(255, 102, 204);
+ * loadPixels();
+ * let halfImage = 4 * width * (height / 2);
+ * for (let i = 0; i < halfImage; i += 4) {
+ *   pixels[i] = red(pink);
+ *   pixels[i + 1] = green(pink);
+ *   pixels[i + 2] = blue(pink);
+ *   pixels[i + 3] = alpha(pink);
+ * }
+ * updatePixels();
+ */
+exports.pixels = [];
+
+/**
+ * Loads the pixel data for the display window into the pixels[] array. This
+ * function must always be called before reading from or writing to pixels[].
+ *
+ * @method loadPixels
+ */
+exports.loadPixels = function () {
+	pixels = GetScreenPixels();
+};
+
+/**
+ * Updates the display window with the data in the pixels[] array.
+ * Use in conjunction with loadPixels().
+ *
+ * @method updatePixels
+ */
+exports.updatePixels = function () {
+	if (pixels.Update) {
+		pixels.Update();
+	}
+};
+
 
 /**
  * Set image mode. Modifies the location from which images are drawn by
@@ -28,64 +28,25 @@
 * @module p5compat
 */
 
-/**
-* make sure we have a 2x2 identity matrix.
-*/
-exports._ensureMatrix = function () {
-	if (!_currentEnv._matrix) {
-		_currentEnv._matrix = [
-			[1, 0, 0],
-			[0, 1, 0],
-			[0, 0, 1]
-		];
-	}
-}
-
-exports._MaMul = function (a, b) {
-	var aNumRows = a.length, aNumCols = a[0].length,
-		bNumRows = b.length, bNumCols = b[0].length,
-		m = new Array(aNumRows);  // initialize array of rows
-	for (var r = 0; r < aNumRows; ++r) {
-		m[r] = new Array(bNumCols); // initialize the current row
-		for (var c = 0; c < bNumCols; ++c) {
-			m[r][c] = 0;             // initialize the current cell
-			for (var i = 0; i < aNumCols; ++i) {
-				m[r][c] += a[r][i] * b[i][c];
-			}
-		}
-	}
-	return m;
-};
-
 /**
  * translate a point with the current matrix (if any).
+ * The matrix is kept natively, see TransformApply() etc.
  * 
  * @param {number} x point
  * @param {number} y point
  * @returns {number} the translated x coordinate.
  */
-exports._transX = function (x, y) {
-	if (_currentEnv._matrix) {
-		return x * _currentEnv._matrix[0][0] + y * _currentEnv._matrix[0][1] + _currentEnv._matrix[0][2];
-	} else {
-		return x;
-	}
-}
+exports._transX = TransformX;
 
 /**
  * translate a point with the current matrix (if any).
+ * The matrix is kept natively, see TransformApply() etc.
  * 
  * @param {number} x point
  * @param {number} y point
  * @returns {number} the translated y coordinate.
  */
-exports._transY = function (x, y) {
-	if (_currentEnv._matrix) {
-		return x * _currentEnv._matrix[1][0] + y * _currentEnv._matrix[1][1] + _currentEnv._matrix[1][2];
-	} else {
-		return y;
-	}
-}
+exports._transY = TransformY;
 
 /**
  * Multiplies the current matrix by the one specified through the parameters.
@@ -172,21 +133,7 @@ exports._transY = function (x, y) {
  * }
  */
 exports.applyMatrix = function (a, b, c, d, e, f) {
-	_ensureMatrix();
-
-	var pm = function (m) {
-		for (var r = 0; r < m.length; ++r) {
-			Println('  ' + m[r].join(' '));
-		}
-	}
-
-	var m1 = [
-		[a, c, e],
-		[b, d, f],
-		[0, 0, 1]
-	];
-
-	_currentEnv._matrix = _MaMul(_currentEnv._matrix, m1);
+	TransformApply(a, b, c, d, e, f);
 };
 
 /**
@@ -202,7 +149,7 @@ exports.applyMatrix = function (a, b, c, d, e, f) {
  * rect(0, 0, 20, 20);
  */
 exports.resetMatrix = function () {
-	_currentEnv._matrix = null;
+	TransformReset();
 };
 
 /**
@@ -230,16 +177,7 @@ exports.resetMatrix = function () {
  * rect(-26, -26, 52, 52);
  */
 exports.rotate = function (angle) {
-	_ensureMatrix();
-	var cA = cos(angle);
-	var sA = sin(angle);
-
-	var m1 = [
-		[cA, -sA, 0],
-		[sA, cA, 0],
-		[0, 0, 1]
-	];
-	_currentEnv._matrix = _MaMul(_currentEnv._matrix, m1);
+	TransformRotate(_toRadians(angle));
 };
 
 /**
@@ -267,13 +205,7 @@ exports.rotate = function (angle) {
  * rect(0, 0, 30, 30);
  */
 exports.shearX = function (angle) {
-	_ensureMatrix();
-	var m1 = [
-		[1, tan(angle), 0],
-		[0, 1, 0],
-		[0, 0, 1]
-	];
-	_currentEnv._matrix = _MaMul(_currentEnv._matrix, m1);
+	TransformApply(1, 0, tan(angle), 1, 0, 0);
 };
 
 /**
@@ -301,13 +233,7 @@ exports.shearX = function (angle) {
  * rect(0, 0, 30, 30);
  */
 exports.shearY = function (angle) {
-	_ensureMatrix();
-	var m1 = [
-		[1, 0, 0],
-		[tan(angle), 1, 0],
-		[0, 0, 1]
-	];
-	_currentEnv._matrix = _MaMul(_currentEnv._matrix, m1);
+	TransformApply(1, tan(angle), 0, 1, 0, 0);
 };
 
 /**
@@ -349,17 +275,11 @@ exports.shearY = function (angle) {
  * @param  {p5.Vector} vector the vector to translate by
  */
 exports.translate = function (x, y, z) {
-	_ensureMatrix();
 	if (x instanceof PVector) {
 		y = x.y;
 		x = x.x;
 	}
-	var m1 = [
-		[1, 0, x],
-		[0, 1, y],
-		[0, 0, 1]
-	];
-	_currentEnv._matrix = _MaMul(_currentEnv._matrix, m1);
+	TransformTranslate(x, y);
 };
 
 
@@ -398,7 +318,6 @@ exports.translate = function (x, y, z) {
  * @param  {p5.Vector|Number[]} scales per-axis percents to scale the object
  */
 exports.scale = function (x, y, z) {
-	_ensureMatrix();
 	// Only check for Vector argument type if Vector is available
 	if (x instanceof PVector) {
 		var v = x;
@@ -416,10 +335,5 @@ exports.scale = function (x, y, z) {
 	} else if (isNaN(z)) {
 		z = 1;
 	}
-	var m1 = [
-		[x, 0, 0],
-		[0, y, 0],
-		[0, 0, 1]
-	];
-	_currentEnv._matrix = _MaMul(_currentEnv._matrix, m1);
+	TransformScale(x, y);
 };
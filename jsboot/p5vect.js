@@ -55,27 +55,24 @@
  * v1.add(v2);
  * ellipse(v1.x, v1.y, 50, 50);
  */
-exports.PVector = function PVector() {
-	var x, y, z;
-	x = arguments[0] || 0;
-	y = arguments[1] || 0;
-	z = arguments[2] || 0;
-	/**
-	 * The x component of the vector
-	 * @property x {Number}
-	 */
-	this.x = x;
-	/**
-	 * The y component of the vector
-	 * @property y {Number}
-	 */
-	this.y = y;
-	/**
-	 * The z component of the vector
-	 * @property z {Number}
-	 */
-	this.z = z;
-};
+/*
+ * The constructor, x/y/z and the methods without a function body below are implemented natively (see pvector.c).
+ * Vectors are taken from a pool of preallocated C structs and the arithmetic does not create temporary JS objects.
+ */
+
+/**
+ * The x component of the vector
+ * @property x {Number}
+ */
+/**
+ * The y component of the vector
+ * @property y {Number}
+ */
+/**
+ * The z component of the vector
+ * @property z {Number}
+ */
+exports.PVector = PVector;
 
 /**
  * Returns a string representation of a vector v by calling String(v)
@@ -169,24 +166,6 @@ exports.PVector.prototype.toString = function p5VectorToString() {
  *   pop();
  * }
  */
-exports.PVector.prototype.set = function set(x, y, z) {
-	if (x instanceof PVector) {
-		this.x = x.x || 0;
-		this.y = x.y || 0;
-		this.z = x.z || 0;
-		return this;
-	}
-	if (x instanceof Array) {
-		this.x = x[0] || 0;
-		this.y = x[1] || 0;
-		this.z = x[2] || 0;
-		return this;
-	}
-	this.x = x || 0;
-	this.y = y || 0;
-	this.z = z || 0;
-	return this;
-};
 
 /**
  * Gets a copy of the vector, returns a PVector object.
@@ -199,9 +178,6 @@ exports.PVector.prototype.set = function set(x, y, z) {
  * print(v1.x === v2.x && v1.y === v2.y && v1.z === v2.z);
  * // Prints "true"
  */
-exports.PVector.prototype.copy = function copy() {
-	return new PVector(this.x, this.y, this.z);
-};
 
 /**
  * Adds x, y, and z components to a vector, adds one vector to another, or
@@ -255,24 +231,6 @@ exports.PVector.prototype.copy = function copy() {
  *   pop();
  * }
  */
-exports.PVector.prototype.add = function add(x, y, z) {
-	if (x instanceof PVector) {
-		this.x += x.x || 0;
-		this.y += x.y || 0;
-		this.z += x.z || 0;
-		return this;
-	}
-	if (x instanceof Array) {
-		this.x += x[0] || 0;
-		this.y += x[1] || 0;
-		this.z += x[2] || 0;
-		return this;
-	}
-	this.x += x || 0;
-	this.y += y || 0;
-	this.z += z || 0;
-	return this;
-};
 
 /**
  * Subtracts x, y, and z components from a vector, subtracts one vector from
@@ -327,24 +285,6 @@ exports.PVector.prototype.add = function add(x, y, z) {
  *   pop();
  * }
  */
-exports.PVector.prototype.sub = function sub(x, y, z) {
-	if (x instanceof PVector) {
-		this.x -= x.x || 0;
-		this.y -= x.y || 0;
-		this.z -= x.z || 0;
-		return this;
-	}
-	if (x instanceof Array) {
-		this.x -= x[0] || 0;
-		this.y -= x[1] || 0;
-		this.z -= x[2] || 0;
-		return this;
-	}
-	this.x -= x || 0;
-	this.y -= y || 0;
-	this.z -= z || 0;
-	return this;
-};
 
 /**
  * Multiply the vector by a scalar. The static version of this method
@@ -394,19 +334,6 @@ exports.PVector.prototype.sub = function sub(x, y, z) {
  *   pop();
  * }
  */
-exports.PVector.prototype.mult = function mult(n) {
-	if (!(typeof n === 'number' && isFinite(n))) {
-		Println(
-			'PVector.prototype.mult:',
-			'n is undefined or not a finite number'
-		);
-		return this;
-	}
-	this.x *= n;
-	this.y *= n;
-	this.z *= n;
-	return this;
-};
 
 /**
  * Divide the vector by a scalar. The static version of this method creates a
@@ -455,23 +382,6 @@ exports.PVector.prototype.mult = function mult(n) {
  *   pop();
  * }
  */
-exports.PVector.prototype.div = function div(n) {
-	if (!(typeof n === 'number' && isFinite(n))) {
-		Println(
-			'PVector.prototype.div:',
-			'n is undefined or not a finite number'
-		);
-		return this;
-	}
-	if (n === 0) {
-		Println('PVector.prototype.div:', 'divide by 0');
-		return this;
-	}
-	this.x /= n;
-	this.y /= n;
-	this.z /= n;
-	return this;
-};
 
 /**
  * Calculates the magnitude (length) of the vector and returns the result as
@@ -509,9 +419,6 @@ exports.PVector.prototype.div = function div(n) {
  * let m = v.mag();
  * print(m); // Prints "53.85164807134504"
  */
-exports.PVector.prototype.mag = function mag() {
-	return Math.sqrt(this.magSq());
-};
 
 /**
  * Calculates the squared magnitude of the vector and returns the result
@@ -552,12 +459,6 @@ exports.PVector.prototype.mag = function mag() {
  *   pop();
  * }
  */
-exports.PVector.prototype.magSq = function magSq() {
-	var x = this.x;
-	var y = this.y;
-	var z = this.z;
-	return x * x + y * y + z * z;
-};
 
 /**
  * Calculates the dot product of two vectors. The version of the method
@@ -587,12 +488,6 @@ exports.PVector.prototype.magSq = function magSq() {
  * @param  {PVector} value value component of the vector or a PVector
  * @return {Number}
  */
-exports.PVector.prototype.dot = function dot(x, y, z) {
-	if (x instanceof PVector) {
-		return this.dot(x.x, x.y, x.z);
-	}
-	return this.x * (x || 0) + this.y * (y || 0) + this.z * (z || 0);
-};
 
 /**
  * Calculates and returns a vector composed of the cross product between
@@ -616,13 +511,6 @@ exports.PVector.prototype.dot = function dot(x, y, z) {
  * // crossProduct has components [0, 0, 1]
  * print(crossProduct);
  */
-exports.PVector.prototype.cross = function cross(v) {
-	var x = this.y * v.z - this.z * v.y;
-	var y = this.z * v.x - this.x * v.z;
-	var z = this.x * v.y - this.y * v.x;
-
-	return new PVector(x, y, z);
-};
 
 /**
  * Calculates the Euclidean distance between two points (considering a
@@ -676,12 +564,6 @@ exports.PVector.prototype.cross = function cross(v) {
  *   pop();
  * }
  */
-exports.PVector.prototype.dist = function dist(v) {
-	return v
-		.copy()
-		.sub(this)
-		.mag();
-};
 
 /**
  * Normalize the vector to length 1 (make it a unit vector).
@@ -723,13 +605,6 @@ exports.PVector.prototype.dist = function dist(v) {
  *   pop();
  * }
  */
-exports.PVector.prototype.normalize = function normalize() {
-	var len = this.mag();
-	// here we multiply by the reciprocal instead of calling 'div()'
-	// since div duplicates this zero check.
-	if (len !== 0) this.mult(1 / len);
-	return this;
-};
 
 /**
  * Limit the magnitude of this vector to the value used for the <b>max</b>
@@ -771,14 +646,6 @@ exports.PVector.prototype.normalize = function normalize() {
  *   pop();
  * }
  */
-exports.PVector.prototype.limit = function limit(max) {
-	var mSq = this.magSq();
-	if (mSq > max * max) {
-		this.div(Math.sqrt(mSq)) //normalize it
-			.mult(max);
-	}
-	return this;
-};
 
 /**
  * Set the magnitude of this vector to the value used for the <b>len</b>
@@ -823,9 +690,6 @@ exports.PVector.prototype.limit = function limit(max) {
  *   pop();
  * }
  */
-exports.PVector.prototype.setMag = function setMag(n) {
-	return this.normalize().mult(n);
-};
 
 /**
  * Calculate the angle of rotation for this vector (only 2D vectors)
@@ -1057,15 +921,6 @@ exports.PVector.prototype.angleBetween = function angleBetween(v) {
  *   pop();
  * }
  */
-exports.PVector.prototype.lerp = function lerp(x, y, z, amt) {
-	if (x instanceof PVector) {
-		return this.lerp(x.x, x.y, x.z, y);
-	}
-	this.x += (x - this.x) * amt || 0;
-	this.y += (y - this.y) * amt || 0;
-	this.z += (z - this.z) * amt || 0;
-	return this;
-};
 
 /**
  * Return a representation of this vector as a float array. This is only
@@ -1087,9 +942,6 @@ exports.PVector.prototype.lerp = function lerp(x, y, z, amt) {
  * print(f[1]); // Prints "20.0"
  * print(f[2]); // Prints "30.0"
  */
-exports.PVector.prototype.array = function array() {
-	return [this.x || 0, this.y || 0, this.z || 0];
-};
 
 /**
  * Equality check against a PVector
@@ -1118,23 +970,6 @@ exports.PVector.prototype.array = function array() {
  * @param {PVector|Array} value the vector to compare
  * @return {Boolean}
  */
-exports.PVector.prototype.equals = function equals(x, y, z) {
-	var a, b, c;
-	if (x instanceof PVector) {
-		a = x.x || 0;
-		b = x.y || 0;
-		c = x.z || 0;
-	} else if (x instanceof Array) {
-		a = x[0] || 0;
-		b = x[1] || 0;
-		c = x[2] || 0;
-	} else {
-		a = x || 0;
-		b = y || 0;
-		c = z || 0;
-	}
-	return this.x === a && this.y === b && this.z === c;
-};
 
 // Static Methods
 
@@ -1179,12 +1014,6 @@ exports.PVector.prototype.equals = function equals(x, y, z) {
  *   pop();
  * }
  */
-exports.PVector.fromAngle = function fromAngle(angle, length) {
-	if (typeof length === 'undefined') {
-		length = 1;
-	}
-	return new exports.PVector(length * Math.cos(angle), length * Math.sin(angle), 0);
-};
 
 /**
  * Make a new 3D vector from a pair of ISO spherical angles
@@ -1307,15 +1136,6 @@ exports.PVector.random3D = function random3D() {
  * @param  {PVector} v2 a PVector to add
  * @param  {PVector} target the vector to receive the result
  */
-exports.PVector.add = function add(v1, v2, target) {
-	if (!target) {
-		target = v1.copy();
-	} else {
-		target.set(v1);
-	}
-	target.add(v2);
-	return target;
-};
 
 /**
  * Subtracts one PVector from another and returns a new one.  The second
@@ -1327,15 +1147,6 @@ exports.PVector.add = function add(v1, v2, target) {
  * @param  {PVector} v2 a PVector to subtract
  * @param  {PVector} target if undefined a new vector will be created
  */
-exports.PVector.sub = function sub(v1, v2, target) {
-	if (!target) {
-		target = v1.copy();
-	} else {
-		target.set(v1);
-	}
-	target.sub(v2);
-	return target;
-};
 
 /**
  * Multiplies a vector by a scalar and returns a new vector.
@@ -1346,15 +1157,6 @@ exports.PVector.sub = function sub(v1, v2, target) {
  * @param  {Number}  n
  * @param  {PVector} target if undefined a new vector will be created
  */
-exports.PVector.mult = function mult(v, n, target) {
-	if (!target) {
-		target = v.copy();
-	} else {
-		target.set(v);
-	}
-	target.mult(n);
-	return target;
-};
 
 /**
  * Divides a vector by a scalar and returns a new vector.
@@ -1365,15 +1167,6 @@ exports.PVector.mult = function mult(v, n, target) {
  * @param  {Number}  n
  * @param  {PVector} target if undefined a new vector will be created
  */
-exports.PVector.div = function div(v, n, target) {
-	if (!target) {
-		target = v.copy();
-	} else {
-		target.set(v);
-	}
-	target.div(n);
-	return target;
-};
 
 /**
  * Calculates the dot product of two vectors.
@@ -1384,9 +1177,6 @@ exports.PVector.div = function div(v, n, target) {
  * @param  {PVector} v2 the second PVector
  * @return {Number}     the dot product
  */
-exports.PVector.dot = function dot(v1, v2) {
-	return v1.dot(v2);
-};
 
 /**
  * Calculates the cross product of two vectors.
@@ -1411,9 +1201,6 @@ exports.PVector.cross = function cross(v1, v2) {
  * @param  {PVector} v2 the second PVector
  * @return {Number}     the distance
  */
-exports.PVector.dist = function dist(v1, v2) {
-	return v1.dist(v2);
-};
 
 /**
  * Linear interpolate a vector to another vector and return the result as a
@@ -1442,13 +1229,41 @@ exports.PVector.lerp = function lerp(v1, v2, amt, target) {
  * @return {Number}        the magnitude of vecT
  * @static
  */
-exports.PVector.mag = function mag(vecT) {
-	var x = vecT.x,
-		y = vecT.y,
-		z = vecT.z;
-	var magSq = x * x + y * y + z * z;
-	return Math.sqrt(magSq);
-};
+
+/**
+ * Adds to all vectors of an array in place. If a PVector[] is passed the
+ * vectors are added pairwise, a single PVector or number[] is added to every
+ * entry. This is much faster than calling add() in a JS loop.
+ *
+ * @method addArray
+ * @static
+ * @param {PVector[]} vs the vectors to modify
+ * @param {PVector|PVector[]|Number[]} v the vector(s) to add
+ * @example
+ * // move all particles by their velocity
+ * PVector.addArray(velocities, accelerations);
+ * PVector.limitArray(velocities, maxSpeed);
+ * PVector.addArray(positions, velocities);
+ * PVector.multArray(accelerations, 0);
+ */
+
+/**
+ * Multiplies all vectors of an array in place with a scalar.
+ *
+ * @method multArray
+ * @static
+ * @param {PVector[]} vs the vectors to modify
+ * @param {Number} n the number to multiply with
+ */
+
+/**
+ * Limits the magnitude of all vectors of an array in place.
+ *
+ * @method limitArray
+ * @static
+ * @param {PVector[]} vs the vectors to modify
+ * @param {Number} max the maximum magnitude
+ */
 
 exports.p5 = {};
 exports.p5.Vector = exports.PVector;
@@ -22,7 +22,6 @@ SOFTWARE.
 
 #include <allegro.h>
 #include <dirent.h>
-#include <dpmi.h>
 #include <errno.h>
 #include <math.h>
 #include <mujs.h>
@@ -35,13 +34,39 @@ SOFTWARE.
 #include "DOjS.h"
 #include "a3d.h"
 #include "bitmap.h"
+#include "matrix.h"
+#include "tiled.h"
+#include "zbuffer.h"
 
-//! convert angle in radians to allegro 0..256 representation
-#define RADTOALLEG(x) (x / (2 * M_PI) * 256)
+/*********************
+** static variables **
+*********************/
+static BITMAP *a3d_scene_target = NULL;  //!< the Bitmap passed to clear_scene(), pinned until the scene is destroyed
 
 /*********************
 ** static functions **
 *********************/
+/**
+ * @brief set the render target of the scene. The target is pinned so its optimized form (see Bitmap.Optimize()) is not used while the scene renders into it.
+ *
+ * @param J VM state.
+ * @param bm the new render target or NULL.
+ *
+ * @return true if the target was set, false if it could not be pinned (an error is thrown).
+ */
+static bool a3d_set_scene_target(js_State *J, BITMAP *bm) {
+    Bitmap_unpinTarget(a3d_scene_target);
+    a3d_scene_target = NULL;
+    if (bm) {
+        if (!Bitmap_pinTarget(bm)) {
+            JS_ENOMEM(J);
+            return false;
+        }
+        a3d_scene_target = bm;
+    }
+    return true;
+}
+
 /**
  * @brief free an array of V3D_f.
  *
@@ -173,7 +198,7 @@ static V3D_f **tmp_v3d(js_State *J, int len) {
 static BITMAP *bitmap_or_null(js_State *J, int idx) {
     BITMAP *texture = NULL;
     if (!js_isnull(J, idx) && js_isuserdata(J, idx, TAG_BITMAP)) {
-        texture = js_touserdata(J, idx, TAG_BITMAP);
+        texture = Bitmap_get(J, idx);
     }
     return texture;
 }
@@ -309,21 +334,51 @@ static void f_Clip3D(js_State *J) {
  *
  * @param J VM state.
  */
-static void f__RenderScene(js_State *J) { render_scene(); }
+static void f__RenderScene(js_State *J) {
+    if (tiled_enabled()) {
+        tiled_render();
+
+        // restore the ZBuffer set by the script
+        js_getglobal(J, "__zbuffer");
+        if (js_isuserdata(J, -1, TAG_ZBUFFER)) {
+            set_zbuffer(js_touserdata(J, -1, TAG_ZBUFFER));
+        } else {
+            set_zbuffer(NULL);
+        }
+        js_pop(J, 1);
+    } else {
+        render_scene();
+    }
+}
 
 /**
  * @brief Deallocate memory previously allocated by create_scene. Use this to avoid memory leaks in your program.
  *
  * @param J VM state.
  */
-static void f__DestroyScene(js_State *J) { destroy_scene(); }
+static void f__DestroyScene(js_State *J) {
+    tiled_destroy();
+    destroy_scene();
+    a3d_set_scene_target(J, NULL);
+}
 
 /**
  * @brief Initializes a scene. The bitmap is the bitmap you will eventually render on.
  *
  * @param J VM state.
  */
-static void f__ClearScene(js_State *J) { clear_scene(DOjS.current_bm); }
+static void f__ClearScene(js_State *J) {
+    if (!a3d_set_scene_target(J, DOjS.current_bm)) {
+        return;
+    }
+    if (tiled_enabled()) {
+        if (!tiled_clear(DOjS.current_bm)) {
+            JS_ENOMEM(J);
+        }
+    } else {
+        clear_scene(DOjS.current_bm);
+    }
+}
 
 /**
  * @brief Allocates memory for a scene, `nedge' and `npoly' are your estimates of how many edges and how many polygons you will render (you cannot get over the limit specified
@@ -335,7 +390,15 @@ static void f__CreateScene(js_State *J) {
     int nedge = js_toint16(J, 1);
     int npoly = js_toint16(J, 2);
 
-    if (create_scene(nedge, npoly) < 0) {
+    tiled_destroy();
+    a3d_set_scene_target(J, NULL);
+    if (js_isdefined(J, 3)) {
+        destroy_scene();
+        if (!tiled_create(nedge, npoly, js_toint32(J, 3))) {
+            js_error(J, "Cannot allocate scene");
+            return;
+        }
+    } else if (create_scene(nedge, npoly) < 0) {
         js_error(J, "Cannot allocate scene");
         return;
     }
@@ -368,7 +431,7 @@ static void f__ScenePolygon3D(js_State *J) {
     int vc = 0;
     V3D_f **vtx = v3d_array(J, 3, &vc);
     if (vtx) {
-        scene_polygon3d_f(type, texture, vc, vtx);
+        a3d_scene_polygon3d_f(type, texture, vc, vtx);
     } else {
         js_error(J, "Cannot convert vertices");
     }
@@ -419,7 +482,7 @@ static void print_matrix(MATRIX_f *m) {
  * @param J VM state.
  * @param m the matrix.
  */
-static void return_matrix(js_State *J, MATRIX_f *m) {
+void return_matrix(js_State *J, MATRIX_f *m) {
     js_newobject(J);
     {
         js_newarray(J);
@@ -444,13 +507,19 @@ static void return_matrix(js_State *J, MATRIX_f *m) {
 }
 
 /**
- * @brief helper: Get a matrix parameter.
+ * @brief helper: Get a matrix parameter, either a Matrix() or an object with 'v' and 't'.
  *
  * @param J VM state.
  * @param m where to store the matrix.
  * @param idx stack index.
  */
-static void get_matrix(js_State *J, MATRIX_f *m, int idx) {
+void get_matrix(js_State *J, MATRIX_f *m, int idx) {
+    if (js_isuserdata(J, idx, TAG_MATRIX)) {
+        matrix_t *mat = js_touserdata(J, idx, TAG_MATRIX);
+        *m = mat->m;
+        return;
+    }
+
     js_getproperty(J, idx, "v");
     for (int j = 0; j < 3; j++) {
         js_getindex(J, -1, j);
@@ -730,6 +799,24 @@ static void f_PolygonZNormal(js_State *J) {
 /***********************
 ** exported functions **
 ***********************/
+/**
+ * @brief put a polygon into the current scene, either for render_scene() or the tiled renderer.
+ *
+ * @param type POLYTYPE.
+ * @param texture the texture or NULL.
+ * @param vc number of vertices.
+ * @param vtx the projected vertices.
+ *
+ * @return zero on success, nonzero if the scene is full.
+ */
+int a3d_scene_polygon3d_f(int type, BITMAP *texture, int vc, V3D_f *vtx[]) {
+    if (tiled_enabled()) {
+        return tiled_polygon3d_f(type, texture, vc, vtx);
+    } else {
+        return scene_polygon3d_f(type, texture, vc, vtx);
+    }
+}
+
 /**
  * @brief initialize a3d subsystem.
  *
@@ -743,7 +830,7 @@ void init_a3d(js_State *J) {
     NFUNCDEF(J, _RenderScene, 0);
     NFUNCDEF(J, _DestroyScene, 0);
     NFUNCDEF(J, _ClearScene, 0);
-    NFUNCDEF(J, _CreateScene, 2);
+    NFUNCDEF(J, _CreateScene, 3);
     NFUNCDEF(J, SetSceneGap, 1);
 
     // direct rendering
@@ -30,9 +30,15 @@ SOFTWARE.
 ************/
 #define JSINC_A3D JSBOOT_DIR "a3d.js"  //!< boot script for a3d subsystem
 
+//! convert angle in radians to allegro 0..256 representation
+#define RADTOALLEG(x) (x / (2 * M_PI) * 256)
+
 /***********************
 ** exported functions **
 ***********************/
 extern void init_a3d(js_State *J);
+extern void get_matrix(js_State *J, MATRIX_f *m, int idx);
+extern void return_matrix(js_State *J, MATRIX_f *m);
+extern int a3d_scene_polygon3d_f(int type, BITMAP *texture, int vc, V3D_f *vtx[]);
 
 #endif  // __A3D_H__
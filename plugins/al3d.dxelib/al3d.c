@@ -25,15 +25,14 @@ SOFTWARE.
 
 #include "DOjS.h"
 #include "a3d.h"
+#include "al3d.h"
+#include "matrix.h"
+#include "mesh.h"
+#include "tiled.h"
 #include "util.h"
 #include "zipfile.h"
 #include "zbuffer.h"
 
-/**************
-** prototype **
-**************/
-void init_al3d(js_State *J);
-
 /***********************
 ** exported functions **
 ***********************/
@@ -48,4 +47,12 @@ void init_al3d(js_State *J) {
 
     init_a3d(J);
     init_zbuffer(J);
+    init_mesh(J);
+    init_matrix(J);
+}
+
+void shutdown_al3d() {
+    LOGF("%s\n", __PRETTY_FUNCTION__);
+
+    tiled_destroy();
 }
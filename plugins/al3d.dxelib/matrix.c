@@ -0,0 +1,450 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <allegro.h>
+#include <math.h>
+#include <mujs.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DOjS.h"
+#include "a3d.h"
+#include "matrix.h"
+#include "mesh.h"
+#include "../neural.dxelib/doublearray.h"
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief finalize a matrix and free resources.
+ *
+ * @param J VM state.
+ */
+static void Matrix_Finalize(js_State *J, void *data) {
+    matrix_t *mat = (matrix_t *)data;
+    free(mat->stack);
+    free(mat);
+}
+
+/**
+ * @brief create a new matrix. It is initialized with the identity matrix or a copy of the given matrix.
+ * new Matrix([m:Matrix])
+ *
+ * @param J VM state.
+ */
+static void new_Matrix(js_State *J) {
+    NEW_OBJECT_PREP(J);
+
+    // parse first, get_matrix() throws on invalid parameters
+    MATRIX_f m;
+    if (js_isobject(J, 1)) {
+        get_matrix(J, &m, 1);
+    } else {
+        m = identity_matrix_f;
+    }
+
+    matrix_t *mat = calloc(1, sizeof(matrix_t));
+    if (!mat) {
+        JS_ENOMEM(J);
+        return;
+    }
+    mat->m = m;
+
+    js_currentfunction(J);
+    js_getproperty(J, -1, "prototype");
+    js_newuserdata(J, TAG_MATRIX, mat, Matrix_Finalize);
+}
+
+/**
+ * @brief helper: multiply the transformation in front of the matrix, it is applied to points before the current transformation.
+ *
+ * @param mat the matrix.
+ * @param t the transformation.
+ */
+static void Matrix_PreMulHelper(matrix_t *mat, MATRIX_f *t) {
+    MATRIX_f tmp;
+    matrix_mul_f(t, &mat->m, &tmp);
+    mat->m = tmp;
+}
+
+/**
+ * @brief reset to the identity matrix.
+ * m.Identity():Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_Identity(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    mat->m = identity_matrix_f;
+    js_copy(J, 0);
+}
+
+/**
+ * @brief copy another matrix into this one.
+ * m.Set(m:Matrix):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_Set(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    get_matrix(J, &mat->m, 1);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief get the matrix as object with the 3x3 matrix 'v' and the translation 't'.
+ * m.Get():{v:number[][], t:number[]}
+ *
+ * @param J VM state.
+ */
+static void Matrix_Get(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    return_matrix(J, &mat->m);
+}
+
+/**
+ * @brief replace the matrix with a rotation matrix.
+ * m.SetRotation(x:number, y:number, z:number):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_SetRotation(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    float x = js_tonumber(J, 1);
+    float y = js_tonumber(J, 2);
+    float z = js_tonumber(J, 3);
+
+    get_rotation_matrix_f(&mat->m, RADTOALLEG(x), RADTOALLEG(y), RADTOALLEG(z));
+    js_copy(J, 0);
+}
+
+/**
+ * @brief replace the matrix with a transformation matrix.
+ * m.SetTransformation(scale:number, xrot:number, yrot:number, zrot:number, x:number, y:number, z:number):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_SetTransformation(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    float scale = js_tonumber(J, 1);
+    float xr = js_tonumber(J, 2);
+    float yr = js_tonumber(J, 3);
+    float zr = js_tonumber(J, 4);
+
+    float x = js_tonumber(J, 5);
+    float y = js_tonumber(J, 6);
+    float z = js_tonumber(J, 7);
+
+    get_transformation_matrix_f(&mat->m, scale, RADTOALLEG(xr), RADTOALLEG(yr), RADTOALLEG(zr), x, y, z);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief add a translation.
+ * m.Translate(x:number, y:number, z:number):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_Translate(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    MATRIX_f t;
+
+    get_translation_matrix_f(&t, js_tonumber(J, 1), js_tonumber(J, 2), js_tonumber(J, 3));
+    Matrix_PreMulHelper(mat, &t);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief add a scaling, if only x is given it is used for all axes.
+ * m.Scale(x:number, [y:number, z:number]):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_Scale(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    MATRIX_f t;
+
+    float x = js_tonumber(J, 1);
+    float y = js_isdefined(J, 2) ? js_tonumber(J, 2) : x;
+    float z = js_isdefined(J, 3) ? js_tonumber(J, 3) : x;
+
+    get_scaling_matrix_f(&t, x, y, z);
+    Matrix_PreMulHelper(mat, &t);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief add a rotation around all three axes.
+ * m.Rotate(x:number, y:number, z:number):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_Rotate(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    MATRIX_f t;
+
+    float x = js_tonumber(J, 1);
+    float y = js_tonumber(J, 2);
+    float z = js_tonumber(J, 3);
+
+    get_rotation_matrix_f(&t, RADTOALLEG(x), RADTOALLEG(y), RADTOALLEG(z));
+    Matrix_PreMulHelper(mat, &t);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief add a rotation around the X axis.
+ * m.RotateX(r:number):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_RotateX(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    MATRIX_f t;
+
+    float r = js_tonumber(J, 1);
+
+    get_x_rotate_matrix_f(&t, RADTOALLEG(r));
+    Matrix_PreMulHelper(mat, &t);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief add a rotation around the Y axis.
+ * m.RotateY(r:number):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_RotateY(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    MATRIX_f t;
+
+    float r = js_tonumber(J, 1);
+
+    get_y_rotate_matrix_f(&t, RADTOALLEG(r));
+    Matrix_PreMulHelper(mat, &t);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief add a rotation around the Z axis.
+ * m.RotateZ(r:number):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_RotateZ(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    MATRIX_f t;
+
+    float r = js_tonumber(J, 1);
+
+    get_z_rotate_matrix_f(&t, RADTOALLEG(r));
+    Matrix_PreMulHelper(mat, &t);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief multiply with another matrix, the other matrix is applied to points after this one (same as MatrixMul(this, m)).
+ * m.Mul(m:Matrix):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_Mul(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    MATRIX_f m2, tmp;
+
+    get_matrix(J, &m2, 1);
+    matrix_mul_f(&mat->m, &m2, &tmp);
+    mat->m = tmp;
+    js_copy(J, 0);
+}
+
+/**
+ * @brief multiply with another matrix, the other matrix is applied to points before this one (same as MatrixMul(m, this)).
+ * m.PreMul(m:Matrix):Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_PreMul(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    MATRIX_f m2;
+
+    get_matrix(J, &m2, 1);
+    Matrix_PreMulHelper(mat, &m2);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief save a copy of the current matrix on the stack.
+ * m.Push():Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_Push(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+
+    if (!mat->stack) {
+        mat->stack = malloc(MATRIX_STACK_DEPTH * sizeof(MATRIX_f));
+        if (!mat->stack) {
+            JS_ENOMEM(J);
+            return;
+        }
+    }
+    if (mat->sp >= MATRIX_STACK_DEPTH) {
+        js_error(J, "Matrix stack overflow");
+        return;
+    }
+    mat->stack[mat->sp++] = mat->m;
+    js_copy(J, 0);
+}
+
+/**
+ * @brief restore the last matrix saved with Push().
+ * m.Pop():Matrix
+ *
+ * @param J VM state.
+ */
+static void Matrix_Pop(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+
+    if (mat->sp <= 0) {
+        js_error(J, "Matrix stack underflow");
+        return;
+    }
+    mat->m = mat->stack[--mat->sp];
+    js_copy(J, 0);
+}
+
+/**
+ * @brief transform the x/y/z values of a vertex buffer with six values (x, y, z, u, v, c) per vertex.
+ * The result is written to dst (or back to src), u, v and c are copied unchanged.
+ * m.ApplyBuffer(src:(DoubleArray|number[]), [dst:(DoubleArray|number[])])
+ *
+ * @param J VM state.
+ */
+static void Matrix_ApplyBuffer(js_State *J) {
+    matrix_t *mat = js_touserdata(J, 0, TAG_MATRIX);
+    int dst_idx = js_isdefined(J, 2) ? 2 : 1;
+    float x, y, z;
+
+    if (js_isuserdata(J, 1, TAG_DOUBLE_ARRAY)) {
+        if (!js_isuserdata(J, dst_idx, TAG_DOUBLE_ARRAY)) {
+            js_error(J, "Destination must be a DoubleArray");
+            return;
+        }
+        double_array_t *src = js_touserdata(J, 1, TAG_DOUBLE_ARRAY);
+        double_array_t *dst = js_touserdata(J, dst_idx, TAG_DOUBLE_ARRAY);
+        if (src->size % MESH_VALUES) {
+            js_error(J, "Vertex buffer size must be a multiple of %d", MESH_VALUES);
+            return;
+        }
+        if (dst->size < src->size) {
+            js_error(J, "Destination is too small");
+            return;
+        }
+
+        for (uint32_t i = 0; i < src->size; i += MESH_VALUES) {
+            double *s = &src->data[i];
+            double *d = &dst->data[i];
+            apply_matrix_f(&mat->m, s[0], s[1], s[2], &x, &y, &z);
+            if (d != s) {
+                d[3] = s[3];
+                d[4] = s[4];
+                d[5] = s[5];
+            }
+            d[0] = x;
+            d[1] = y;
+            d[2] = z;
+        }
+    } else if (js_isarray(J, 1)) {
+        if (!js_isarray(J, dst_idx)) {
+            js_error(J, "Destination must be an Array");
+            return;
+        }
+        int len = js_getlength(J, 1);
+        if (len % MESH_VALUES) {
+            js_error(J, "Vertex buffer size must be a multiple of %d", MESH_VALUES);
+            return;
+        }
+
+        for (int i = 0; i < len; i += MESH_VALUES) {
+            js_getindex(J, 1, i + 0);
+            js_getindex(J, 1, i + 1);
+            js_getindex(J, 1, i + 2);
+            apply_matrix_f(&mat->m, js_tonumber(J, -3), js_tonumber(J, -2), js_tonumber(J, -1), &x, &y, &z);
+            js_pop(J, 3);
+
+            js_pushnumber(J, x);
+            js_setindex(J, dst_idx, i + 0);
+            js_pushnumber(J, y);
+            js_setindex(J, dst_idx, i + 1);
+            js_pushnumber(J, z);
+            js_setindex(J, dst_idx, i + 2);
+            if (dst_idx != 1) {
+                for (int j = 3; j < MESH_VALUES; j++) {
+                    js_getindex(J, 1, i + j);
+                    js_setindex(J, dst_idx, i + j);
+                }
+            }
+        }
+    } else {
+        js_error(J, "Vertices must be a DoubleArray or Array");
+    }
+}
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief initialize matrix subsystem.
+ *
+ * @param J VM state.
+ */
+void init_matrix(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    js_newobject(J);
+    {
+        NPROTDEF(J, Matrix, Identity, 0);
+        NPROTDEF(J, Matrix, Set, 1);
+        NPROTDEF(J, Matrix, Get, 0);
+        NPROTDEF(J, Matrix, SetRotation, 3);
+        NPROTDEF(J, Matrix, SetTransformation, 7);
+        NPROTDEF(J, Matrix, Translate, 3);
+        NPROTDEF(J, Matrix, Scale, 3);
+        NPROTDEF(J, Matrix, Rotate, 3);
+        NPROTDEF(J, Matrix, RotateX, 1);
+        NPROTDEF(J, Matrix, RotateY, 1);
+        NPROTDEF(J, Matrix, RotateZ, 1);
+        NPROTDEF(J, Matrix, Mul, 1);
+        NPROTDEF(J, Matrix, PreMul, 1);
+        NPROTDEF(J, Matrix, Push, 0);
+        NPROTDEF(J, Matrix, Pop, 0);
+        NPROTDEF(J, Matrix, ApplyBuffer, 2);
+    }
+    CTORDEF(J, new_Matrix, TAG_MATRIX, 1);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
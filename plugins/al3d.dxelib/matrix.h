@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef __MATRIX_H__
+#define __MATRIX_H__
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define TAG_MATRIX "Matrix"  //!< class name for Matrix()
+
+#define MATRIX_STACK_DEPTH 32  //!< max number of Push() without Pop()
+
+/************
+** structs **
+************/
+//! a native matrix with its own stack for hierarchical transformations
+typedef struct _matrix {
+    MATRIX_f m;       //!< the current matrix
+    int sp;           //!< number of matrices on the stack
+    MATRIX_f *stack;  //!< the stack, allocated on first Push()
+} matrix_t;
+
+/***********************
+** exported functions **
+***********************/
+extern void init_matrix(js_State *J);
+
+#endif  // __MATRIX_H__
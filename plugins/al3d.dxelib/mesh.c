@@ -0,0 +1,419 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <allegro.h>
+#include <mujs.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "DOjS.h"
+#include "a3d.h"
+#include "bitmap.h"
+#include "intarray.h"
+#include "mesh.h"
+#include "../neural.dxelib/doublearray.h"
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief free all memory of a mesh.
+ *
+ * @param m the mesh.
+ */
+static void Mesh_Free(mesh_t *m) {
+    if (m) {
+        free(m->vertices);
+        free(m->xformed);
+        free(m->indices);
+        free(m->clip_data);
+        free(m->vtx);
+        free(m->vout);
+        free(m->vtmp);
+        free(m->out);
+        free(m);
+    }
+}
+
+/**
+ * @brief finalize a mesh and free resources.
+ *
+ * @param J VM state.
+ */
+static void Mesh_Finalize(js_State *J, void *data) { Mesh_Free((mesh_t *)data); }
+
+/**
+ * @brief store one vertex from an array of MESH_VALUES numbers.
+ *
+ * @param v the vertex.
+ * @param d the values.
+ */
+static void Mesh_SetVertex(V3D_f *v, const double *d) {
+    v->x = (float)d[0];
+    v->y = (float)d[1];
+    v->z = (float)d[2];
+    v->u = (float)d[3];
+    v->v = (float)d[4];
+    v->c = (int)d[5];
+}
+
+/**
+ * @brief convert the vertex parameter to the vertex buffer of the mesh.
+ * Accepted are IntArray, DoubleArray and flat JS arrays with MESH_VALUES entries per vertex or JS arrays of vertex arrays.
+ *
+ * @param J VM state.
+ * @param idx stack index of the vertex parameter.
+ * @param m the mesh.
+ *
+ * @return true if the vertices were converted, false if an error was thrown.
+ */
+static bool Mesh_GetVertices(js_State *J, int idx, mesh_t *m) {
+    double d[MESH_VALUES];
+
+    if (js_isuserdata(J, idx, TAG_INT_ARRAY) || js_isuserdata(J, idx, TAG_DOUBLE_ARRAY)) {
+        int_array_t *ia = NULL;
+        double_array_t *da = NULL;
+        uint32_t size;
+        if (js_isuserdata(J, idx, TAG_INT_ARRAY)) {
+            ia = js_touserdata(J, idx, TAG_INT_ARRAY);
+            size = ia->size;
+        } else {
+            da = js_touserdata(J, idx, TAG_DOUBLE_ARRAY);
+            size = da->size;
+        }
+        if (size == 0 || size % MESH_VALUES) {
+            js_error(J, "Vertex buffer size must be a multiple of %d", MESH_VALUES);
+            return false;
+        }
+        m->num_vertices = size / MESH_VALUES;
+        m->vertices = malloc(m->num_vertices * sizeof(V3D_f));
+        if (!m->vertices) {
+            JS_ENOMEM(J);
+            return false;
+        }
+        for (int i = 0; i < m->num_vertices; i++) {
+            for (int j = 0; j < MESH_VALUES; j++) {
+                d[j] = ia ? ia->data[i * MESH_VALUES + j] : da->data[i * MESH_VALUES + j];
+            }
+            Mesh_SetVertex(&m->vertices[i], d);
+        }
+        return true;
+    } else if (js_isarray(J, idx)) {
+        int len = js_getlength(J, idx);
+        bool nested = false;
+        if (len > 0) {
+            js_getindex(J, idx, 0);
+            nested = js_isarray(J, -1);
+            js_pop(J, 1);
+        }
+        if (nested) {
+            m->num_vertices = len;
+        } else if (len > 0 && len % MESH_VALUES == 0) {
+            m->num_vertices = len / MESH_VALUES;
+        } else {
+            js_error(J, "Vertex buffer size must be a multiple of %d", MESH_VALUES);
+            return false;
+        }
+        m->vertices = malloc(m->num_vertices * sizeof(V3D_f));
+        if (!m->vertices) {
+            JS_ENOMEM(J);
+            return false;
+        }
+        for (int i = 0; i < m->num_vertices; i++) {
+            for (int j = 0; j < MESH_VALUES; j++) {
+                if (nested) {
+                    js_getindex(J, idx, i);
+                    js_getindex(J, -1, j);
+                    d[j] = js_tonumber(J, -1);
+                    js_pop(J, 2);
+                } else {
+                    js_getindex(J, idx, i * MESH_VALUES + j);
+                    d[j] = js_tonumber(J, -1);
+                    js_pop(J, 1);
+                }
+            }
+            Mesh_SetVertex(&m->vertices[i], d);
+        }
+        return true;
+    } else {
+        js_error(J, "Vertices must be an IntArray, DoubleArray or Array");
+        return false;
+    }
+}
+
+/**
+ * @brief convert the index parameter to the index buffer of the mesh. If no indices are given the vertices are used in order.
+ *
+ * @param J VM state.
+ * @param idx stack index of the index parameter.
+ * @param m the mesh.
+ *
+ * @return true if the indices were converted, false if an error was thrown.
+ */
+static bool Mesh_GetIndices(js_State *J, int idx, mesh_t *m) {
+    int_array_t *ia = NULL;
+    int len;
+
+    if (js_isuserdata(J, idx, TAG_INT_ARRAY)) {
+        ia = js_touserdata(J, idx, TAG_INT_ARRAY);
+        len = ia->size;
+    } else if (js_isarray(J, idx)) {
+        len = js_getlength(J, idx);
+    } else if (js_isundefined(J, idx) || js_isnull(J, idx)) {
+        len = m->num_vertices - m->num_vertices % m->face_size;
+    } else {
+        js_error(J, "Indices must be an IntArray or Array");
+        return false;
+    }
+    if (len == 0 || len % m->face_size) {
+        js_error(J, "Index buffer size must be a multiple of %d", m->face_size);
+        return false;
+    }
+
+    m->num_faces = len / m->face_size;
+    m->indices = malloc(len * sizeof(int));
+    if (!m->indices) {
+        JS_ENOMEM(J);
+        return false;
+    }
+    for (int i = 0; i < len; i++) {
+        int vi;
+        if (ia) {
+            vi = ia->data[i];
+        } else if (js_isarray(J, idx)) {
+            js_getindex(J, idx, i);
+            vi = js_toint32(J, -1);
+            js_pop(J, 1);
+        } else {
+            vi = i;
+        }
+        if (vi < 0 || vi >= m->num_vertices) {
+            js_error(J, "Index out of range: %d", vi);
+            return false;
+        }
+        m->indices[i] = vi;
+    }
+    return true;
+}
+
+/**
+ * @brief allocate the transformation and clipping buffers.
+ *
+ * @param m the mesh.
+ *
+ * @return true if all memory could be allocated.
+ */
+static bool Mesh_AllocBuffers(mesh_t *m) {
+    m->clip_size = m->face_size * MESH_CLIP_FACTOR;
+
+    m->xformed = malloc(m->num_vertices * sizeof(V3D_f));
+    m->clip_data = malloc(2 * m->clip_size * sizeof(V3D_f));
+    m->vtx = malloc(m->face_size * sizeof(V3D_f *));
+    m->vout = malloc(m->clip_size * sizeof(V3D_f *));
+    m->vtmp = malloc(m->clip_size * sizeof(V3D_f *));
+    m->out = malloc(m->clip_size * sizeof(int));
+    if (!m->xformed || !m->clip_data || !m->vtx || !m->vout || !m->vtmp || !m->out) {
+        return false;
+    }
+
+    for (int i = 0; i < m->clip_size; i++) {
+        m->vout[i] = &m->clip_data[i];
+        m->vtmp[i] = &m->clip_data[m->clip_size + i];
+    }
+    return true;
+}
+
+/**
+ * @brief create a new mesh.
+ * new Mesh(vertices:(IntArray|DoubleArray|number[]|number[][]), [indices:(IntArray|number[])], [faceSize:number])
+ *
+ * @param J VM state.
+ */
+static void new_Mesh(js_State *J) {
+    NEW_OBJECT_PREP(J);
+
+    mesh_t *m = calloc(1, sizeof(mesh_t));
+    if (!m) {
+        JS_ENOMEM(J);
+        return;
+    }
+    m->min_z = 0.1;
+    m->max_z = 1000;
+    m->face_size = js_isdefined(J, 3) ? js_toint32(J, 3) : 3;
+    if (m->face_size < 3 || m->face_size > MESH_MAX_FACE) {
+        Mesh_Free(m);
+        js_error(J, "Face size must be between 3 and %d", MESH_MAX_FACE);
+        return;
+    }
+
+    if (js_try(J)) {
+        Mesh_Free(m);
+        js_throw(J);
+    }
+    if (!Mesh_GetVertices(J, 1, m) || !Mesh_GetIndices(J, 2, m)) {
+        js_endtry(J);
+        Mesh_Free(m);
+        return;
+    }
+    js_endtry(J);
+
+    if (!Mesh_AllocBuffers(m)) {
+        Mesh_Free(m);
+        JS_ENOMEM(J);
+        return;
+    }
+
+    js_currentfunction(J);
+    js_getproperty(J, -1, "prototype");
+    js_newuserdata(J, TAG_MESH, m, Mesh_Finalize);
+
+    // add properties
+    js_pushnumber(J, m->num_vertices);
+    js_defproperty(J, -2, "numVertices", JS_READONLY | JS_DONTCONF);
+
+    js_pushnumber(J, m->num_faces);
+    js_defproperty(J, -2, "numFaces", JS_READONLY | JS_DONTCONF);
+
+    js_pushnumber(J, m->face_size);
+    js_defproperty(J, -2, "faceSize", JS_READONLY | JS_DONTCONF);
+}
+
+/**
+ * @brief transform, clip and project all faces of the mesh and either draw them or put them into the scene.
+ *
+ * @param J VM state.
+ * @param scene true to call scene_polygon3d_f(), false to draw directly to the current bitmap.
+ */
+static void Mesh_Render(js_State *J, bool scene) {
+    mesh_t *m = js_touserdata(J, 0, TAG_MESH);
+
+    MATRIX_f matrix;
+    get_matrix(J, &matrix, 1);
+    int type = js_toint16(J, 2);
+    BITMAP *texture = NULL;
+    if (js_isuserdata(J, 3, TAG_BITMAP)) {
+        texture = Bitmap_get(J, 3);
+    }
+    bool cull = js_toboolean(J, 4);
+
+    // transform every vertex exactly once, faces share them through the index buffer
+    for (int i = 0; i < m->num_vertices; i++) {
+        V3D_f *src = &m->vertices[i];
+        V3D_f *dst = &m->xformed[i];
+        apply_matrix_f(&matrix, src->x, src->y, src->z, &dst->x, &dst->y, &dst->z);
+        dst->u = src->u;
+        dst->v = src->v;
+        dst->c = src->c;
+    }
+
+    int drawn = 0;
+    int *idx = m->indices;
+    for (int f = 0; f < m->num_faces; f++, idx += m->face_size) {
+        for (int i = 0; i < m->face_size; i++) {
+            m->vtx[i] = &m->xformed[idx[i]];
+        }
+
+        int vc = clip3d_f(type, m->min_z, m->max_z, m->face_size, (AL_CONST V3D_f **)m->vtx, m->vout, m->vtmp, m->out);
+        if (vc < 3) {
+            continue;
+        }
+
+        for (int i = 0; i < vc; i++) {
+            persp_project_f(m->vout[i]->x, m->vout[i]->y, m->vout[i]->z, &m->vout[i]->x, &m->vout[i]->y);
+        }
+        if (cull && polygon_z_normal_f(m->vout[0], m->vout[1], m->vout[2]) <= 0) {
+            continue;
+        }
+
+        if (scene) {
+            if (a3d_scene_polygon3d_f(type, texture, vc, m->vout) != 0) {
+                break;  // scene is full
+            }
+        } else {
+            polygon3d_f(DOjS.current_bm, type, texture, vc, m->vout);
+        }
+        drawn++;
+    }
+
+    if (scene && texture) {
+        // make sure texture bitmap is not garbage collected until RenderScene() has been called!
+        js_getglobal(J, "_bitmap_array");
+        js_getproperty(J, -1, "push");
+        js_rot2(J);
+        js_copy(J, 3);
+        js_call(J, 1);
+        js_pop(J, 1);
+    }
+
+    js_pushnumber(J, drawn);
+}
+
+/**
+ * @brief draw the mesh to the current bitmap.
+ * mesh.Draw(matrix:Matrix, type:POLYTYPE, texture:Bitmap, [cull:boolean]):number
+ *
+ * @param J VM state.
+ */
+static void Mesh_Draw(js_State *J) { Mesh_Render(J, false); }
+
+/**
+ * @brief put the mesh into the current scene.
+ * mesh.SceneDraw(matrix:Matrix, type:POLYTYPE, texture:Bitmap, [cull:boolean]):number
+ *
+ * @param J VM state.
+ */
+static void Mesh_SceneDraw(js_State *J) { Mesh_Render(J, true); }
+
+/**
+ * @brief set the near and far clipping planes.
+ * mesh.SetClip(min_z:number, max_z:number)
+ *
+ * @param J VM state.
+ */
+static void Mesh_SetClip(js_State *J) {
+    mesh_t *m = js_touserdata(J, 0, TAG_MESH);
+    m->min_z = (float)js_tonumber(J, 1);
+    m->max_z = (float)js_tonumber(J, 2);
+}
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief initialize mesh subsystem.
+ *
+ * @param J VM state.
+ */
+void init_mesh(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    js_newobject(J);
+    {
+        NPROTDEF(J, Mesh, Draw, 4);
+        NPROTDEF(J, Mesh, SceneDraw, 4);
+        NPROTDEF(J, Mesh, SetClip, 2);
+    }
+    CTORDEF(J, new_Mesh, TAG_MESH, 3);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
@@ -0,0 +1,65 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef __MESH_H__
+#define __MESH_H__
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define TAG_MESH "Mesh"  //!< class name for Mesh()
+
+#define MESH_VALUES 6        //!< number of values per vertex (x, y, z, u, v, c)
+#define MESH_MAX_FACE 32     //!< max number of vertices per face
+#define MESH_CLIP_FACTOR 12  //!< size of the clipping buffers (multiplied with the face size), see Clip3D()
+
+/************
+** structs **
+************/
+//! a mesh with vertex and index buffers and scratch memory for drawing
+typedef struct _mesh {
+    int num_vertices;  //!< number of vertices
+    V3D_f *vertices;   //!< the vertices as uploaded
+    V3D_f *xformed;    //!< the vertices after the last transformation
+    int face_size;     //!< number of vertices per face
+    int num_faces;     //!< number of faces
+    int *indices;      //!< vertex indices, face_size entries per face
+    float min_z;       //!< near clipping plane
+    float max_z;       //!< far clipping plane
+    int clip_size;     //!< size of the clipping buffers
+    V3D_f *clip_data;  //!< storage for the clipping buffers
+    V3D_f **vtx;       //!< input vertices of the current face
+    V3D_f **vout;      //!< clipping output
+    V3D_f **vtmp;      //!< clipping temporary buffer
+    int *out;          //!< clipping output flags
+} mesh_t;
+
+/***********************
+** exported functions **
+***********************/
+extern void init_mesh(js_State *J);
+
+#endif  // __MESH_H__
@@ -0,0 +1,470 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <allegro.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if LINUX == 1
+#include <pthread.h>
+#endif
+
+#include "DOjS.h"
+#include "tiled.h"
+
+/************
+** structs **
+************/
+//! a polygon put into the scene
+typedef struct _tiled_poly {
+    int type;         //!< POLYTYPE
+    BITMAP *texture;  //!< texture or NULL
+    int first;        //!< index of the first vertex in tiled_vertices
+    int vc;           //!< number of vertices
+    int group;        //!< rasterizer group, see tiled_drawer_group()
+} tiled_poly_t;
+
+//! a tile of the target bitmap with the polygons touching it
+typedef struct _tiled_tile {
+    BITMAP *bm;       //!< sub-bitmap of the target, clipped to the tile
+    bool visible;     //!< false if the tile is outside the clip rectangle of the target
+    int x1, y1;       //!< top left corner (inclusive)
+    int x2, y2;       //!< bottom right corner (inclusive)
+    int *polys;       //!< indices into tiled_polys
+    int num_polys;    //!< number of polygons in this tile
+    int alloc_polys;  //!< allocated size of polys
+    int next;         //!< index into polys of the next polygon to render
+} tiled_tile_t;
+
+/************
+** globals **
+************/
+static bool tiled_active = false;         //!< true if the current scene uses the tiled renderer
+static BITMAP *tiled_target = NULL;       //!< the bitmap the tiles were created for
+static ZBUFFER *tiled_zbuf = NULL;        //!< z-buffer for the target, every tile only touches its own area
+static tiled_tile_t *tiled_tiles = NULL;  //!< the tiles
+static int tiled_cols = 0;                //!< number of tile columns
+static int tiled_rows = 0;                //!< number of tile rows
+
+static tiled_poly_t *tiled_polys = NULL;  //!< polygons of the scene
+static int tiled_num_polys = 0;           //!< number of polygons in the scene
+static int tiled_max_polys = 0;           //!< max number of polygons
+
+static V3D_f *tiled_vertices = NULL;  //!< vertices of all polygons of the scene
+static int tiled_num_vertices = 0;    //!< number of used vertices
+static int tiled_max_vertices = 0;    //!< max number of vertices
+
+#if LINUX == 1
+static pthread_mutex_t tiled_mutex = PTHREAD_MUTEX_INITIALIZER;  //!< protects the tile counters
+static pthread_cond_t tiled_work = PTHREAD_COND_INITIALIZER;     //!< signalled when tiles are ready to be rendered
+static pthread_cond_t tiled_done = PTHREAD_COND_INITIALIZER;     //!< signalled when the last tile was rendered
+static pthread_t tiled_threads[TILED_MAX_THREADS];               //!< the render threads
+static int tiled_num_threads = 0;                                //!< number of running render threads
+static int tiled_num_tiles = 0;                                  //!< number of tiles of the current render call
+static int tiled_next_tile = 0;                                  //!< next tile to render
+static int tiled_tiles_done = 0;                                 //!< number of rendered tiles
+static int tiled_pass_end = 0;                                   //!< tiles render their polygons up to this index of tiled_polys
+static bool tiled_quit = false;                                  //!< true to stop the render threads
+#endif
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief free all tiles and the z-buffer.
+ */
+static void tiled_free_tiles(void) {
+    if (tiled_tiles) {
+        for (int i = 0; i < tiled_cols * tiled_rows; i++) {
+            if (tiled_tiles[i].bm) {
+                destroy_bitmap(tiled_tiles[i].bm);
+            }
+            free(tiled_tiles[i].polys);
+        }
+        free(tiled_tiles);
+        tiled_tiles = NULL;
+    }
+    if (tiled_zbuf) {
+        destroy_zbuffer(tiled_zbuf);
+        tiled_zbuf = NULL;
+    }
+    tiled_target = NULL;
+    tiled_cols = tiled_rows = 0;
+}
+
+/**
+ * @brief create the tiles for a bitmap, nothing is done if the tiles already match the bitmap.
+ *
+ * @param bm the target bitmap.
+ *
+ * @return true if the tiles are ready, false if memory was exhausted.
+ */
+static bool tiled_setup_tiles(BITMAP *bm) {
+    if (tiled_target == bm && tiled_tiles && tiled_tiles[0].bm->w == bm->w && tiled_tiles[0].bm->h == bm->h && tiled_tiles[0].bm->line[0] == bm->line[0]) {
+        return true;
+    }
+    tiled_free_tiles();
+
+    tiled_cols = (bm->w + TILED_SIZE - 1) / TILED_SIZE;
+    tiled_rows = (bm->h + TILED_SIZE - 1) / TILED_SIZE;
+    tiled_tiles = calloc(tiled_cols * tiled_rows, sizeof(tiled_tile_t));
+    tiled_zbuf = create_zbuffer(bm);
+    if (!tiled_tiles || !tiled_zbuf) {
+        tiled_free_tiles();
+        return false;
+    }
+
+    // every tile draws through its own full size sub-bitmap so the clip rectangles do not interfere
+    for (int i = 0; i < tiled_cols * tiled_rows; i++) {
+        tiled_tile_t *t = &tiled_tiles[i];
+        t->bm = create_sub_bitmap(bm, 0, 0, bm->w, bm->h);
+        if (!t->bm) {
+            tiled_free_tiles();
+            return false;
+        }
+    }
+    tiled_target = bm;
+    return true;
+}
+
+/**
+ * @brief get the rasterizer group of a POLYTYPE.
+ * triangle3d_f() stores the affine filler of the perspective correct POLYTYPEs in the global _optim_alternative_drawer and reads it back while
+ * drawing (all other POLYTYPEs store NULL and never read it). Polygons can only be rasterized in parallel if they store the same value, so
+ * every perspective correct POLYTYPE is a group of its own and all other POLYTYPEs share one group.
+ *
+ * @param type POLYTYPE without POLYTYPE_ZBUF.
+ *
+ * @return the group.
+ */
+static int tiled_drawer_group(int type) {
+    switch (type) {
+        case POLYTYPE_PTEX:
+        case POLYTYPE_PTEX_MASK:
+        case POLYTYPE_PTEX_LIT:
+        case POLYTYPE_PTEX_MASK_LIT:
+        case POLYTYPE_PTEX_TRANS:
+        case POLYTYPE_PTEX_MASK_TRANS:
+            return type;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief render the polygons of one tile up to the given polygon index. The tile continues where the last call stopped.
+ *
+ * @param t the tile.
+ * @param end index into tiled_polys, polygons from here on are left for the next call.
+ */
+static void tiled_render_tile(tiled_tile_t *t, int end) {
+    if (!t->visible || t->next >= t->num_polys || t->polys[t->next] >= end) {
+        return;
+    }
+
+    // clear this tiles area of the z-buffer before the first polygon
+    if (t->next == 0) {
+        for (int y = t->y1; y <= t->y2; y++) {
+            memset(((float *)tiled_zbuf->line[y]) + t->x1, 0, (t->x2 - t->x1 + 1) * sizeof(float));
+        }
+    }
+
+    // polygon3d_f() shares a global scratch buffer and can't be used here, see tiled_drawer_group() for triangle3d_f()
+    for (; t->next < t->num_polys && t->polys[t->next] < end; t->next++) {
+        tiled_poly_t *p = &tiled_polys[t->polys[t->next]];
+        V3D_f *v = &tiled_vertices[p->first];
+        for (int j = 1; j < p->vc - 1; j++) {
+            triangle3d_f(t->bm, p->type | POLYTYPE_ZBUF, p->texture, &v[0], &v[j], &v[j + 1]);
+        }
+    }
+}
+
+#if LINUX == 1
+/**
+ * @brief render thread, renders tiles until tiled_quit is set.
+ *
+ * @param arg unused.
+ *
+ * @return always NULL.
+ */
+static void *tiled_worker(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&tiled_mutex);
+    while (!tiled_quit) {
+        if (tiled_next_tile >= tiled_num_tiles) {
+            pthread_cond_wait(&tiled_work, &tiled_mutex);
+            continue;
+        }
+        tiled_tile_t *t = &tiled_tiles[tiled_next_tile++];
+        int end = tiled_pass_end;
+        pthread_mutex_unlock(&tiled_mutex);
+
+        tiled_render_tile(t, end);
+
+        pthread_mutex_lock(&tiled_mutex);
+        tiled_tiles_done++;
+        if (tiled_tiles_done == tiled_num_tiles) {
+            pthread_cond_signal(&tiled_done);
+        }
+    }
+    pthread_mutex_unlock(&tiled_mutex);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief add a polygon to a tile.
+ *
+ * @param t the tile.
+ * @param idx index of the polygon.
+ *
+ * @return true if the polygon was added, false if memory was exhausted.
+ */
+static bool tiled_add(tiled_tile_t *t, int idx) {
+    if (t->num_polys >= t->alloc_polys) {
+        int new_size = t->alloc_polys ? t->alloc_polys * 2 : 64;
+        int *new_polys = realloc(t->polys, new_size * sizeof(int));
+        if (!new_polys) {
+            return false;
+        }
+        t->polys = new_polys;
+        t->alloc_polys = new_size;
+    }
+    t->polys[t->num_polys++] = idx;
+    return true;
+}
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief create a scene for the tiled renderer.
+ *
+ * @param nvert max number of vertices in the scene.
+ * @param npoly max number of polygons in the scene.
+ * @param threads number of render threads (ignored on DOS).
+ *
+ * @return true if the scene was created, false if memory was exhausted.
+ */
+bool tiled_create(int nvert, int npoly, int threads) {
+    tiled_destroy();
+
+    tiled_polys = malloc(npoly * sizeof(tiled_poly_t));
+    tiled_vertices = malloc(nvert * sizeof(V3D_f));
+    if (!tiled_polys || !tiled_vertices) {
+        tiled_destroy();
+        return false;
+    }
+    tiled_max_polys = npoly;
+    tiled_max_vertices = nvert;
+    tiled_num_polys = tiled_num_vertices = 0;
+
+#if LINUX == 1
+    threads = MID(0, threads, TILED_MAX_THREADS);
+    tiled_quit = false;
+    tiled_num_tiles = tiled_next_tile = tiled_tiles_done = 0;
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&tiled_threads[i], NULL, tiled_worker, NULL) != 0) {
+            LOGF("Could only start %d render threads\n", i);
+            break;
+        }
+        tiled_num_threads++;
+    }
+#else
+    (void)threads;
+#endif
+
+    tiled_active = true;
+    return true;
+}
+
+/**
+ * @brief stop the render threads and free all memory of the tiled renderer.
+ */
+void tiled_destroy(void) {
+#if LINUX == 1
+    if (tiled_num_threads) {
+        pthread_mutex_lock(&tiled_mutex);
+        tiled_quit = true;
+        pthread_cond_broadcast(&tiled_work);
+        pthread_mutex_unlock(&tiled_mutex);
+
+        for (int i = 0; i < tiled_num_threads; i++) {
+            pthread_join(tiled_threads[i], NULL);
+        }
+        tiled_num_threads = 0;
+    }
+#endif
+
+    tiled_free_tiles();
+    free(tiled_polys);
+    free(tiled_vertices);
+    tiled_polys = NULL;
+    tiled_vertices = NULL;
+    tiled_max_polys = tiled_max_vertices = 0;
+    tiled_num_polys = tiled_num_vertices = 0;
+    tiled_active = false;
+}
+
+/**
+ * @brief check if the current scene uses the tiled renderer.
+ *
+ * @return true for the tiled renderer, false for render_scene().
+ */
+bool tiled_enabled(void) { return tiled_active; }
+
+/**
+ * @brief initialize the scene for rendering to the given bitmap.
+ *
+ * @param bm the target bitmap.
+ *
+ * @return true if the scene is ready, false if memory was exhausted.
+ */
+bool tiled_clear(BITMAP *bm) {
+    if (!tiled_setup_tiles(bm)) {
+        return false;
+    }
+
+    int cx1, cy1, cx2, cy2;
+    get_clip_rect(bm, &cx1, &cy1, &cx2, &cy2);
+    for (int y = 0; y < tiled_rows; y++) {
+        for (int x = 0; x < tiled_cols; x++) {
+            tiled_tile_t *t = &tiled_tiles[y * tiled_cols + x];
+            t->x1 = MAX(x * TILED_SIZE, cx1);
+            t->y1 = MAX(y * TILED_SIZE, cy1);
+            t->x2 = MIN((x + 1) * TILED_SIZE - 1, cx2);
+            t->y2 = MIN((y + 1) * TILED_SIZE - 1, cy2);
+            t->visible = t->x1 <= t->x2 && t->y1 <= t->y2;
+            if (t->visible) {
+                set_clip_rect(t->bm, t->x1, t->y1, t->x2, t->y2);
+            }
+            t->num_polys = 0;
+        }
+    }
+    tiled_num_polys = tiled_num_vertices = 0;
+    return true;
+}
+
+/**
+ * @brief put a polygon into the scene. The polygon is added to every tile its bounding box touches.
+ *
+ * @param type POLYTYPE.
+ * @param texture the texture or NULL.
+ * @param vc number of vertices.
+ * @param vtx the projected vertices.
+ *
+ * @return zero on success, negative if the scene is full.
+ */
+int tiled_polygon3d_f(int type, BITMAP *texture, int vc, V3D_f *vtx[]) {
+    if (!tiled_tiles || vc < 3) {
+        return 0;
+    }
+    if (tiled_num_polys >= tiled_max_polys || tiled_num_vertices + vc > tiled_max_vertices) {
+        return -1;
+    }
+
+    float minx = vtx[0]->x, maxx = vtx[0]->x;
+    float miny = vtx[0]->y, maxy = vtx[0]->y;
+    for (int i = 1; i < vc; i++) {
+        minx = MIN(minx, vtx[i]->x);
+        maxx = MAX(maxx, vtx[i]->x);
+        miny = MIN(miny, vtx[i]->y);
+        maxy = MAX(maxy, vtx[i]->y);
+    }
+    if (maxx < 0 || maxy < 0 || minx >= tiled_target->w || miny >= tiled_target->h) {
+        return 0;
+    }
+    int tx1 = MAX((int)minx, 0) / TILED_SIZE;
+    int ty1 = MAX((int)miny, 0) / TILED_SIZE;
+    int tx2 = MIN((int)maxx + 1, tiled_target->w - 1) / TILED_SIZE;
+    int ty2 = MIN((int)maxy + 1, tiled_target->h - 1) / TILED_SIZE;
+
+    int idx = tiled_num_polys++;
+    tiled_poly_t *p = &tiled_polys[idx];
+    p->type = type & ~POLYTYPE_ZBUF;
+    p->texture = texture;
+    p->first = tiled_num_vertices;
+    p->vc = vc;
+    p->group = tiled_drawer_group(p->type);
+    for (int i = 0; i < vc; i++) {
+        tiled_vertices[tiled_num_vertices++] = *vtx[i];
+    }
+
+    for (int y = ty1; y <= ty2; y++) {
+        for (int x = tx1; x <= tx2; x++) {
+            tiled_tile_t *t = &tiled_tiles[y * tiled_cols + x];
+            if (t->visible && !tiled_add(t, idx)) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief render all polygons of the scene. The tiles are distributed over the render threads, the call returns when all tiles are done.
+ * Consecutive polygons of the same rasterizer group are rendered in one parallel pass, so the polygons of every tile are drawn in the order they
+ * were put into the scene. This changes the current z-buffer.
+ */
+void tiled_render(void) {
+    if (!tiled_tiles) {
+        return;
+    }
+    set_zbuffer(tiled_zbuf);
+    for (int i = 0; i < tiled_cols * tiled_rows; i++) {
+        tiled_tiles[i].next = 0;
+    }
+
+#if LINUX == 1
+    // only memory bitmaps can be drawn to from several threads
+    if (tiled_num_threads && is_memory_bitmap(tiled_target)) {
+        int first = 0;
+        while (first < tiled_num_polys) {
+            int end = first + 1;
+            while (end < tiled_num_polys && tiled_polys[end].group == tiled_polys[first].group) {
+                end++;
+            }
+
+            pthread_mutex_lock(&tiled_mutex);
+            tiled_pass_end = end;
+            tiled_num_tiles = tiled_cols * tiled_rows;
+            tiled_next_tile = tiled_tiles_done = 0;
+            pthread_cond_broadcast(&tiled_work);
+            while (tiled_tiles_done < tiled_num_tiles) {
+                pthread_cond_wait(&tiled_done, &tiled_mutex);
+            }
+            tiled_num_tiles = tiled_next_tile = 0;
+            pthread_mutex_unlock(&tiled_mutex);
+
+            first = end;
+        }
+        return;
+    }
+#endif
+
+    for (int i = 0; i < tiled_cols * tiled_rows; i++) {
+        tiled_render_tile(&tiled_tiles[i], tiled_num_polys);
+    }
+}
@@ -0,0 +1,48 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef __TILED_H__
+#define __TILED_H__
+
+#include <stdbool.h>
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define TILED_SIZE 64         //!< width and height of a tile
+#define TILED_MAX_THREADS 16  //!< max number of render threads
+
+/***********************
+** exported functions **
+***********************/
+extern bool tiled_create(int nvert, int npoly, int threads);
+extern void tiled_destroy(void);
+extern bool tiled_enabled(void);
+extern bool tiled_clear(BITMAP *bm);
+extern int tiled_polygon3d_f(int type, BITMAP *texture, int vc, V3D_f *vtx[]);
+extern void tiled_render(void);
+
+#endif  // __TILED_H__
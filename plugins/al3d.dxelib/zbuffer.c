@@ -55,7 +55,7 @@ static void new_ZBuffer(js_State *J) {
     NEW_OBJECT_PREP(J);
     BITMAP *bm;
     if (js_isuserdata(J, 1, TAG_BITMAP)) {
-        bm = js_touserdata(J, 1, TAG_BITMAP);
+        bm = Bitmap_get(J, 1);
     } else {
         bm = DOjS.current_bm;
     }
@@ -479,7 +479,7 @@ static void PG_AddRgb(js_State *J) {
     float h = js_tonumber(J, 4);
 
     if (js_isuserdata(J, 5, TAG_BITMAP)) {
-        BITMAP *bm = js_touserdata(J, 5, TAG_BITMAP);
+        BITMAP *bm = Bitmap_get(J, 5);
 
         // allocate memory
         size_t imageSize = bm->w * bm->h * 3;
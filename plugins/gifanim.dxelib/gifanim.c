@@ -42,12 +42,27 @@ void init_gifanim(js_State *J);
 /************
 ** structs **
 ************/
+//! a composited frame in the cache
+typedef struct __gifanim_frame {
+    BITMAP *bm;  //!< the canvas after this frame was decoded
+    int delay;   //!< delay for the next frame, -1 for the last frame
+} gifanim_frame_t;
+
 //! file userdata definition
 typedef struct __gifanim {
-    GIFIMAGE gif;   //!< the gif
-    bool is_open;   //!< open flag
-    uint16_t x, y;  //!< draw position
-    bool skip;      //!< skip this frame.
+    GIFIMAGE gif;              //!< the gif
+    bool is_open;              //!< open flag
+    uint16_t x, y;             //!< draw position
+    bool skip;                 //!< skip this frame.
+    bool new_frame;            //!< the next line is the first one of a frame, the palette must be converted
+    uint32_t palette[256];     //!< palette of the current frame in the color depth of 'target'
+    BITMAP *target;            //!< bitmap the frame is decoded into
+    int dx, dy;                //!< position of the canvas in 'target'
+    int frame;                 //!< index of the next frame
+    int num_frames;            //!< number of frames in the file
+    BITMAP *canvas;            //!< frames are composited here while the cache is filled
+    gifanim_frame_t *frames;   //!< cached frames, NULL if the cache is disabled
+    bool complete;             //!< all frames are cached, no decoding is needed anymore
 } gifanim_t;
 
 /*********************
@@ -55,50 +70,164 @@ typedef struct __gifanim {
 *********************/
 
 /**
- * @brief draw a RGB565 pixel as RGB8888
- *
- * @param x
- * @param y
- * @param color
- * @param gif
- */
-static void GIF_drawPixel(uint32_t x, uint32_t y, uint16_t color, gifanim_t *gif) {
-    int r = (color >> 8) & 0xFF;
-    int g = (color >> 3) & 0xFC;
-    int b = (color << 3) & 0xFF;
-
-    putpixel(DOjS.current_bm, x + gif->x, y + gif->y, makeacol32(r, g, b, 255));
-}
-
-/**
- * @brief render current frame
+ * @brief render one line of the current frame. 32bit memory bitmaps are written directly, others with putpixel().
  *
  * @param pDraw callback struct from AnimatedGIF
  */
 static void GIF_DrawCallback(GIFDRAW *pDraw) {
     gifanim_t *user = (gifanim_t *)pDraw->pUser;
 
-    if (!user->skip) {
-        int y = pDraw->iY + pDraw->y;  // current line
-
-        uint8_t *s = pDraw->pPixels;
+    if (user->skip) {
+        return;
+    }
 
-        uint16_t *usPalette = pDraw->pPalette;
+    BITMAP *bm = user->target;
+
+    // convert the palette once per frame (local palettes may change with every frame)
+    if (user->new_frame) {
+        int depth = bitmap_color_depth(bm);
+        uint8_t *p = pDraw->pPalette24;
+        for (int i = 0; i < 256; i++, p += 3) {
+            if (depth == 32) {
+                user->palette[i] = makeacol32(p[0], p[1], p[2], 255);
+            } else {
+                user->palette[i] = makecol_depth(depth, p[0], p[1], p[2]);
+            }
+            // the canvas is cleared to the mask color, opaque pixels of that color are shifted by one bit so they stay visible
+            if (bm == user->canvas && user->palette[i] == bitmap_mask_color(bm)) {
+                user->palette[i] ^= 1;
+            }
+        }
+        user->new_frame = false;
+    }
+    int y = user->dy + pDraw->iY + pDraw->y;  // current line
+    if (y < bm->ct || y >= bm->cb) {
+        return;
+    }
+    int x0 = user->dx + pDraw->iX;
+    int start = MAX(0, bm->cl - x0);
+    int end = MIN(pDraw->iWidth, bm->cr - x0);
+
+    uint8_t *s = pDraw->pPixels;
+    uint32_t *pal = user->palette;
+    if (is_memory_bitmap(bm) && bitmap_color_depth(bm) == 32) {
+        uint32_t *d = (uint32_t *)bm->line[y] + x0;
         if (pDraw->ucHasTransparency) {  // if transparency used
-            for (int x = 0; x < pDraw->iWidth; x++) {
-                int c = *s++;
-                if (c != pDraw->ucTransparent) {
-                    GIF_drawPixel(x, y, usPalette[c], user);
+            uint8_t t = pDraw->ucTransparent;
+            for (int x = start; x < end; x++) {
+                if (s[x] != t) {
+                    d[x] = pal[s[x]];
                 }
             }
         } else {
-            for (int x = 0; x < pDraw->iWidth; x++) {
-                GIF_drawPixel(x, y, usPalette[*s++], user);
+            for (int x = start; x < end; x++) {
+                d[x] = pal[s[x]];
+            }
+        }
+    } else {
+        for (int x = start; x < end; x++) {
+            if (!pDraw->ucHasTransparency || s[x] != pDraw->ucTransparent) {
+                putpixel(bm, x0 + x, y, pal[s[x]]);
             }
         }
     }
 } /* GIFDraw() */
 
+/**
+ * @brief free all cached frames and disable the cache.
+ *
+ * @param g the gif.
+ */
+static void GIF_dropCache(gifanim_t *g) {
+    if (g->frames) {
+        for (int i = 0; i < g->num_frames; i++) {
+            if (g->frames[i].bm) {
+                destroy_bitmap(g->frames[i].bm);
+            }
+        }
+        free(g->frames);
+        g->frames = NULL;
+    }
+    if (g->canvas) {
+        destroy_bitmap(g->canvas);
+        g->canvas = NULL;
+    }
+    g->complete = false;
+}
+
+/**
+ * @brief decode (or fetch from the cache) the next frame.
+ *
+ * @param J VM state.
+ * @param g the gif.
+ * @param draw true to draw the frame to the current bitmap.
+ */
+static void GIF_nextFrame(js_State *J, gifanim_t *g, bool draw) {
+    int nextDelay;
+
+    // all frames are cached, just blit them
+    if (g->complete) {
+        gifanim_frame_t *f = &g->frames[g->frame];
+        if (draw) {
+            masked_blit(f->bm, DOjS.current_bm, 0, 0, g->x, g->y, f->bm->w, f->bm->h);
+        }
+        g->frame = f->delay < 0 ? 0 : g->frame + 1;
+        js_pushnumber(J, f->delay);
+        return;
+    }
+
+    // frames are composited on the canvas when the cache is filled, even when skipped
+    if (g->frames) {
+        g->target = g->canvas;
+        g->dx = g->dy = 0;
+        g->skip = false;
+    } else {
+        g->target = DOjS.current_bm;
+        g->dx = g->x;
+        g->dy = g->y;
+        g->skip = !draw;
+    }
+    g->new_frame = true;
+
+    int res = GIF_playFrame(&g->gif, &nextDelay, g);
+    if (res < 0) {
+        js_error(J, "Error decoding frame");
+        return;
+    }
+    if (res == 0) {
+        nextDelay = -1;
+    }
+
+    if (g->frames) {
+        if (draw) {
+            masked_blit(g->canvas, DOjS.current_bm, 0, 0, g->x, g->y, g->canvas->w, g->canvas->h);
+        }
+
+        BITMAP *copy = g->frame < g->num_frames ? create_bitmap_ex(bitmap_color_depth(g->canvas), g->canvas->w, g->canvas->h) : NULL;
+        if (copy) {
+            blit(g->canvas, copy, 0, 0, 0, 0, copy->w, copy->h);
+            g->frames[g->frame].bm = copy;
+            g->frames[g->frame].delay = nextDelay;
+
+            // the canvas is not needed anymore when the last frame was cached
+            if (res == 0 && g->frame == g->num_frames - 1) {
+                destroy_bitmap(g->canvas);
+                g->canvas = NULL;
+                g->complete = true;
+            } else if (res == 0) {
+                LOGF("GIF has %d frames instead of %d, cache disabled\n", g->frame + 1, g->num_frames);
+                GIF_dropCache(g);
+            }
+        } else {
+            LOGF("GIF frame %d could not be cached, cache disabled\n", g->frame);
+            GIF_dropCache(g);
+        }
+    }
+
+    g->frame = res == 0 ? 0 : g->frame + 1;
+    js_pushnumber(J, nextDelay);
+}
+
 /**
  * @brief finalize a file and free resources.
  *
@@ -111,6 +240,7 @@ static void GIF_Finalize(js_State *J, void *data) {
         GIF_close(&g->gif);
         g->is_open = false;
     }
+    GIF_dropCache(g);
     free(g);
 }
 
@@ -132,6 +262,7 @@ static void new_GIF(js_State *J) {
     }
 
     const char *fname = js_tostring(J, 1);
+    GIF_begin(&g->gif, GIF_PALETTE_RGB888);
     if (!GIF_openFile(&g->gif, fname, GIF_DrawCallback)) {
         js_error(J, "Could not open GIF '%s'.", fname);
         free(g);
@@ -144,6 +275,7 @@ static void new_GIF(js_State *J) {
     js_newuserdata(J, TAG_GIF, g, GIF_Finalize);
 
     GIF_getInfo(&g->gif, &info);
+    g->num_frames = info.iFrameCount;
 
     // add properties
     js_pushstring(J, fname);
@@ -208,21 +340,12 @@ static void GIF_GetComment(js_State *J) {
  * @param J VM state.
  */
 static void GIF_PlayFrame(js_State *J) {
-    int nextDelay;
     gifanim_t *g = js_touserdata(J, 0, TAG_GIF);
 
     g->x = js_toint16(J, 1);
     g->y = js_toint16(J, 2);
 
-    g->skip = false;
-    int res = GIF_playFrame(&g->gif, &nextDelay, g);
-    if (res < 0) {
-        js_error(J, "Error decoding frame");
-    } else if (res == 0) {
-        js_pushnumber(J, -1);
-    } else {
-        js_pushnumber(J, nextDelay);
-    }
+    GIF_nextFrame(J, g, true);
 }
 
 /**
@@ -232,19 +355,60 @@ static void GIF_PlayFrame(js_State *J) {
  * @param J VM state.
  */
 static void GIF_SkipFrame(js_State *J) {
-    int nextDelay;
     gifanim_t *g = js_touserdata(J, 0, TAG_GIF);
 
-    g->skip = true;
-    int res = GIF_playFrame(&g->gif, &nextDelay, g);
-    if (res < 0) {
-        js_error(J, "Error decoding frame");
-    } else if (res == 0) {
-        js_pushnumber(J, -1);
-    } else {
-        js_pushnumber(J, nextDelay);
+    GIF_nextFrame(J, g, false);
+}
+
+/**
+ * @brief cache the composited frames so the animation is only decoded once. The animation restarts with the first frame.
+ * gif.EnableCache(maxBytes:number):boolean
+ *
+ * @param J VM state.
+ */
+static void GIF_EnableCache(js_State *J) {
+    gifanim_t *g = js_touserdata(J, 0, TAG_GIF);
+    double max_bytes = js_tonumber(J, 1);
+
+    GIF_dropCache(g);
+
+    // masked_blit() needs the same color depth for source and destination
+    int depth = bitmap_color_depth(DOjS.current_bm);
+    int w = GIF_getCanvasWidth(&g->gif);
+    int h = GIF_getCanvasHeight(&g->gif);
+    double needed = (double)(g->num_frames + 1) * w * h * ((depth + 7) / 8);
+    if (!g->is_open || g->num_frames < 1 || needed > max_bytes) {
+        js_pushboolean(J, false);
+        return;
+    }
+
+    g->frames = calloc(g->num_frames, sizeof(gifanim_frame_t));
+    g->canvas = create_bitmap_ex(depth, w, h);
+    if (!g->frames || !g->canvas) {
+        GIF_dropCache(g);
+        JS_ENOMEM(J);
+        return;
     }
+    clear_to_color(g->canvas, bitmap_mask_color(g->canvas));
+
+    GIF_reset(&g->gif);
+    g->frame = 0;
+
+    js_pushboolean(J, true);
 }
+
+/**
+ * @brief check if all frames are served from the cache.
+ * gif.IsCached():boolean
+ *
+ * @param J VM state.
+ */
+static void GIF_IsCached(js_State *J) {
+    gifanim_t *g = js_touserdata(J, 0, TAG_GIF);
+
+    js_pushboolean(J, g->complete);
+}
+
 /*********************
 ** public functions **
 *********************/
@@ -262,6 +426,8 @@ void init_gifanim(js_State *J) {
         NPROTDEF(J, GIF, GetComment, 0);
         NPROTDEF(J, GIF, PlayFrame, 2);
         NPROTDEF(J, GIF, SkipFrame, 0);
+        NPROTDEF(J, GIF, EnableCache, 1);
+        NPROTDEF(J, GIF, IsCached, 0);
     }
     CTORDEF(J, new_GIF, TAG_GIF, 1);
 }
@@ -28,6 +28,7 @@ SOFTWARE.
 #include <setjmp.h>
 
 #include "DOjS.h"
+#include "asyncload.h"
 #include "bitmap.h"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -128,6 +129,21 @@ static void *load_from_datafile(PACKFILE *f, long size) {
     return load_jpg_pf(f, 0);
 }
 
+/**
+ * @brief decode JPEG data for Bitmap.LoadAsync().
+ *
+ * @param data the file contents.
+ * @param size size of the file contents.
+ * @param img the decoded image is stored here.
+ * @return true if the image was decoded, else false
+ */
+static bool decode_jpg(const uint8_t *data, size_t size, asyncload_image_t *img) {
+    int channels_in_file;
+    img->rgba = stbi_load_from_memory(data, size, &img->width, &img->height, &channels_in_file, NUM_CHANNELS);
+    img->free_rgba = stbi_image_free;
+    return img->rgba != NULL;
+}
+
 /**
  * @brief load from file system
  *
@@ -165,4 +181,5 @@ void init_jpeg(js_State *J) {
 
     register_bitmap_file_type("jpg", load_jpg, NULL, load_jpg_pf);
     register_datafile_object(DAT_ID('J', 'P', 'G', ' '), load_from_datafile, (void (*)(void *))destroy_bitmap);
+    asyncload_register("jpg", decode_jpg);
 }
@@ -26,6 +26,10 @@ SOFTWARE.
 #include <string.h>
 #include <time.h>
 
+#if LINUX == 1
+#include <pthread.h>
+#endif
+
 #include "DOjS.h"
 
 #define PLM_AUDIO_SEPARATE_CHANNELS
@@ -37,32 +41,325 @@ void init_mpeg1(js_State *J);
 /************
 ** defines **
 ************/
-#define MPEG1_NUM_SEGMENTS 16
+#define MPEG1_NUM_SEGMENTS 16     //!< number of audio segments in the looped sample
+#define MPEG1_VIDEO_QUEUE 4       //!< number of decoded video frames buffered ahead
+#define MPEG1_AUDIO_QUEUE 32      //!< number of decoded audio segments buffered ahead
+#define MPEG1_MAX_DECODE_STEPS 8  //!< maximum number of decode steps per Play() without a decoder thread
+
+#define MPEG1_CLAMP_OFFSET 384  //!< offset of 0 in the clamp table
+#define MPEG1_CLAMP_SIZE 1024   //!< size of the clamp table
 
 #define TAG_MPEG1 "MPEG1"  //!< pointer tag
 
+#if LINUX == 1
+#define MPEG1_LOCK(m) pthread_mutex_lock(&(m)->mutex)       //!< lock the queues
+#define MPEG1_UNLOCK(m) pthread_mutex_unlock(&(m)->mutex)   //!< unlock the queues
+#define MPEG1_SIGNAL(m) pthread_cond_broadcast(&(m)->cond)  //!< wake up the decoder thread or a waiting callback
+#else
+#define MPEG1_LOCK(m)
+#define MPEG1_UNLOCK(m)
+#define MPEG1_SIGNAL(m)
+#endif
+
 /************
 ** structs **
 ************/
+//! a decoded video frame
+typedef struct {
+    uint8_t *y;   //!< luma plane
+    uint8_t *cb;  //!< blue chroma plane
+    uint8_t *cr;  //!< red chroma plane
+    double time;  //!< presentation time in seconds
+} mpeg1_frame_t;
+
+//! a decoded audio segment
+typedef struct {
+    uint16_t data[PLM_AUDIO_SAMPLES_PER_FRAME];  //!< unsigned 16bit mono samples
+    double time;                                 //!< presentation time in seconds
+} mpeg1_audio_t;
+
+//! playback statistics
+typedef struct {
+    unsigned long decoded;  //!< number of frames put into the queue
+    unsigned long shown;    //!< number of frames drawn
+    unsigned long dropped;  //!< number of frames not drawn because they were late
+} mpeg1_stats_t;
+
 //! file userdata definition
 typedef struct __mpeg1 {
     plm_t *plm;               //!< mpeg pointer
-    uint16_t x;               //!< x start coordinate
-    uint16_t y;               //!< y start coordinate
+    int x;                    //!< x start coordinate
+    int y;                    //!< y start coordinate
+    int w;                    //!< width of the scaled video
+    int h;                    //!< height of the scaled video
+    bool bilinear;            //!< use bilinear filtering for scaling
     unsigned long last_call;  //!< time of last call
-    BITMAP *video_buffer;     //!< color conversion buffer
+    double clock;             //!< presentation clock in seconds
+    double frame_time;        //!< duration of one frame in seconds
+    double lead_time;         //!< time the audio is written ahead of the clock
     bool do_sound;            //!< do audio decoding?
     SAMPLE *stream;
     int voice;
     int segment;
+
+    int width;                               //!< visible width of the video
+    int height;                              //!< visible height of the video
+    int y_stride;                            //!< width of the luma plane
+    int y_height;                            //!< height of the luma plane
+    int c_stride;                            //!< width of the chroma planes
+    int c_height;                            //!< height of the chroma planes
+    int *xtab;                               //!< per column source offsets/weights for the conversion
+    int xtab_size;                           //!< number of entries allocated in xtab
+    BITMAP *scratch;                         //!< conversion target for destinations that are not 32bpp memory bitmaps
+    mpeg1_frame_t video[MPEG1_VIDEO_QUEUE];  //!< ring of decoded frames
+    int v_head;                              //!< oldest frame in the ring
+    int v_count;                             //!< number of frames in the ring
+    mpeg1_audio_t audio[MPEG1_AUDIO_QUEUE];  //!< ring of decoded audio segments
+    int a_head;                              //!< oldest segment in the ring
+    int a_count;                             //!< number of segments in the ring
+    bool ended;                              //!< the decoder reached the end of the file
+    mpeg1_stats_t stats;                     //!< playback statistics
+
+#if LINUX == 1
+    pthread_mutex_t mutex;  //!< protects the rings, the clock and the statistics
+    pthread_cond_t cond;    //!< signalled when a ring changes or the thread shall stop
+    pthread_t thread;       //!< the decoder thread
+    bool running;           //!< the decoder thread is running (only used by the main thread)
+    bool worker_active;     //!< the decode callbacks run on the decoder thread and may wait
+    bool stop;              //!< the decoder thread shall stop
+#endif
 } mpeg1_t;
 
+/*********************
+** static variables **
+*********************/
+static int mpeg1_y_tab[256];                       //!< luma scaled to 0..255
+static int mpeg1_rv_tab[256];                      //!< red contribution of Cr
+static int mpeg1_gu_tab[256];                      //!< green contribution of Cb (16.16 fixed point)
+static int mpeg1_gv_tab[256];                      //!< green contribution of Cr (16.16 fixed point)
+static int mpeg1_bu_tab[256];                      //!< blue contribution of Cb
+static uint8_t mpeg1_clamp_tab[MPEG1_CLAMP_SIZE];  //!< clamps (value + MPEG1_CLAMP_OFFSET) to 0..255
+
 /*********************
 ** static functions **
 *********************/
+/**
+ * @brief fill the conversion tables (YCbCr following BT.601, same constants as pl_mpeg).
+ */
+static void MPEG1_initTables(void) {
+    for (int i = 0; i < 256; i++) {
+        mpeg1_y_tab[i] = ((i - 16) * 76309) >> 16;
+        mpeg1_rv_tab[i] = ((i - 128) * 104597) >> 16;
+        mpeg1_gu_tab[i] = (i - 128) * 25674;
+        mpeg1_gv_tab[i] = (i - 128) * 53278;
+        mpeg1_bu_tab[i] = ((i - 128) * 132201) >> 16;
+    }
+    for (int i = 0; i < MPEG1_CLAMP_SIZE; i++) {
+        int v = i - MPEG1_CLAMP_OFFSET;
+        mpeg1_clamp_tab[i] = v < 0 ? 0 : (v > 255 ? 255 : v);
+    }
+}
+
+/**
+ * @brief convert one YCbCr sample to a 32bpp pixel.
+ *
+ * @param y luma
+ * @param cb blue chroma
+ * @param cr red chroma
+ *
+ * @return the pixel in the current 32bpp pixel format.
+ */
+static inline uint32_t MPEG1_pixel(int y, int cb, int cr) {
+    const uint8_t *c = &mpeg1_clamp_tab[MPEG1_CLAMP_OFFSET + mpeg1_y_tab[y]];
+    return ((uint32_t)c[mpeg1_rv_tab[cr]] << _rgb_r_shift_32) | ((uint32_t)c[-((mpeg1_gu_tab[cb] + mpeg1_gv_tab[cr]) >> 16)] << _rgb_g_shift_32) | ((uint32_t)c[mpeg1_bu_tab[cb]] << _rgb_b_shift_32) |
+           (0xFFu << _rgb_a_shift_32);
+}
+
+/**
+ * @brief map destination columns/rows to source positions.
+ * The position is returned as 16.16 fixed point of the pixel center in source pixels.
+ *
+ * @param d destination offset relative to the start of the scaled video
+ * @param src size of the source
+ * @param dst size of the destination
+ *
+ * @return source position of the pixel center
+ */
+static inline int MPEG1_srcPos(int d, int src, int dst) { return (int)(((int64_t)(2 * d + 1) * src << 15) / dst); }
+
+/**
+ * @brief calculate the sample index and weight for bilinear filtering.
+ *
+ * @param center pixel center in 16.16 source coordinates
+ * @param max maximum index
+ * @param idx the left/upper index is stored here
+ *
+ * @return the 8bit weight of the right/lower sample.
+ */
+static inline int MPEG1_bilinear(int center, int max, int *idx) {
+    int pos = center - 0x8000;
+    if (pos < 0) {
+        pos = 0;
+    } else if (pos > (max << 16)) {
+        pos = max << 16;
+    }
+    *idx = pos >> 16;
+    return *idx < max ? (pos >> 8) & 0xFF : 0;
+}
+
+/**
+ * @brief interpolate a sample from a plane.
+ * The right sample is only read for a weight > 0, MPEG1_bilinear() returns 0 for the last column so nothing past the plane is read.
+ */
+static inline int MPEG1_lerp(const uint8_t *r0, const uint8_t *r1, int x, int fx, int fy) {
+    int x1 = x + (fx != 0);
+    int a = (r0[x] << 8) + (r0[x1] - r0[x]) * fx;
+    int b = (r1[x] << 8) + (r1[x1] - r1[x]) * fx;
+    return ((a << 8) + (b - a) * fy + 0x8000) >> 16;
+}
+
+/**
+ * @brief convert a queued frame and write it directly into a 32bpp memory bitmap.
+ * The frame is scaled to w*h and clipped to the clipping rectangle of the bitmap.
+ *
+ * @param m the MPEG playback struct
+ * @param f the frame to draw
+ * @param bm the destination
+ * @param x x position in the destination
+ * @param y y position in the destination
+ * @param w width of the scaled video
+ * @param h height of the scaled video
+ * @param bilinear true for bilinear filtering, false for nearest neighbour
+ *
+ * @return false if the column table could not be allocated.
+ */
+static bool MPEG1_convert(mpeg1_t *m, mpeg1_frame_t *f, BITMAP *bm, int x, int y, int w, int h, bool bilinear) {
+    int x0 = MAX(x, bm->cl);
+    int x1 = MIN(x + w, bm->cr);
+    int y0 = MAX(y, bm->ct);
+    int y1 = MIN(y + h, bm->cb);
+    int cols = x1 - x0;
+    if (cols <= 0 || y1 <= y0) {
+        return true;
+    }
+
+    // four entries per column: luma index/weight and chroma index/weight
+    if (m->xtab_size < cols * 4) {
+        int *t = realloc(m->xtab, cols * 4 * sizeof(int));
+        if (!t) {
+            return false;
+        }
+        m->xtab = t;
+        m->xtab_size = cols * 4;
+    }
+    int c_w = (m->width + 1) / 2;
+    int c_h = (m->height + 1) / 2;
+    int *t = m->xtab;
+    for (int i = 0; i < cols; i++) {
+        int c = MPEG1_srcPos(x0 - x + i, m->width, w);
+        if (bilinear) {
+            t[i * 4 + 1] = MPEG1_bilinear(c, m->width - 1, &t[i * 4 + 0]);
+            t[i * 4 + 3] = MPEG1_bilinear(c / 2, c_w - 1, &t[i * 4 + 2]);
+        } else {
+            t[i * 4 + 0] = c >> 16;
+            t[i * 4 + 2] = c >> 17;
+        }
+    }
+
+    for (int dy = y0; dy < y1; dy++) {
+        uint32_t *d = (uint32_t *)bm->line[dy] + x0;
+        int c = MPEG1_srcPos(dy - y, m->height, h);
+        if (bilinear) {
+            int sy, cy;
+            int fy = MPEG1_bilinear(c, m->height - 1, &sy);
+            int fcy = MPEG1_bilinear(c / 2, c_h - 1, &cy);
+            const uint8_t *y0r = f->y + sy * m->y_stride;
+            const uint8_t *y1r = y0r + (fy ? m->y_stride : 0);
+            const uint8_t *cb0 = f->cb + cy * m->c_stride;
+            const uint8_t *cb1 = cb0 + (fcy ? m->c_stride : 0);
+            const uint8_t *cr0 = f->cr + cy * m->c_stride;
+            const uint8_t *cr1 = cr0 + (fcy ? m->c_stride : 0);
+            for (int i = 0; i < cols; i++, t += 4) {
+                d[i] = MPEG1_pixel(MPEG1_lerp(y0r, y1r, t[0], t[1], fy), MPEG1_lerp(cb0, cb1, t[2], t[3], fcy), MPEG1_lerp(cr0, cr1, t[2], t[3], fcy));
+            }
+        } else {
+            const uint8_t *yr = f->y + (c >> 16) * m->y_stride;
+            const uint8_t *cbr = f->cb + (c >> 17) * m->c_stride;
+            const uint8_t *crr = f->cr + (c >> 17) * m->c_stride;
+            for (int i = 0; i < cols; i++, t += 4) {
+                d[i] = MPEG1_pixel(yr[t[0]], cbr[t[2]], crr[t[2]]);
+            }
+        }
+        t = m->xtab;
+    }
+    return true;
+}
+
+/**
+ * @brief draw a queued frame into a bitmap.
+ * 32bpp memory bitmaps are written directly, all others are converted into a scratch bitmap first.
+ *
+ * @param m the MPEG playback struct
+ * @param f the frame to draw
+ * @param bm the destination
+ * @param x x position in the destination
+ * @param y y position in the destination
+ * @param w width of the scaled video
+ * @param h height of the scaled video
+ * @param bilinear true for bilinear filtering, false for nearest neighbour
+ *
+ * @return false if memory allocation failed.
+ */
+static bool MPEG1_draw(mpeg1_t *m, mpeg1_frame_t *f, BITMAP *bm, int x, int y, int w, int h, bool bilinear) {
+    if (is_memory_bitmap(bm) && bitmap_color_depth(bm) == 32) {
+        return MPEG1_convert(m, f, bm, x, y, w, h, bilinear);
+    }
+
+    if (!m->scratch || m->scratch->w != w || m->scratch->h != h) {
+        if (m->scratch) {
+            destroy_bitmap(m->scratch);
+        }
+        m->scratch = create_bitmap_ex(32, w, h);
+        if (!m->scratch) {
+            return false;
+        }
+    }
+    if (!MPEG1_convert(m, f, m->scratch, 0, 0, w, h, bilinear)) {
+        return false;
+    }
+    blit(m->scratch, bm, 0, 0, x, y, w, h);
+    return true;
+}
+
 
 /**
- * @brief called for audio playback
+ * @brief check if the decode callbacks may wait for free slots (they are running on the decoder thread), must be called with the lock held.
+ *
+ * @param m the MPEG playback struct
+ *
+ * @return true if waiting is possible, false if the oldest entry must be dropped instead.
+ */
+static bool MPEG1_canWait(mpeg1_t *m) {
+#if LINUX == 1
+    return m->worker_active && !m->stop;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief wait until the queues changed (decoder thread only).
+ *
+ * @param m the MPEG playback struct
+ */
+static void MPEG1_wait(mpeg1_t *m) {
+#if LINUX == 1
+    pthread_cond_wait(&m->cond, &m->mutex);
+#endif
+}
+
+/**
+ * @brief called for audio playback, the samples are converted and queued.
  *
  * @param self the MPEG data
  * @param samples sound data
@@ -75,22 +372,37 @@ static void MPEG1_audio_decode_callback(plm_t *self, plm_samples_t *samples, voi
         return;
     }
 
-    // get current buffer part, copy data and switch to next buffer part
-    uint16_t *buf = &(((uint16_t *)m->stream->data)[PLM_AUDIO_SAMPLES_PER_FRAME * m->segment]);
+    MPEG1_LOCK(m);
+    while (m->a_count == MPEG1_AUDIO_QUEUE) {
+        if (MPEG1_canWait(m)) {
+            MPEG1_wait(m);
+        } else {
+            m->a_head = (m->a_head + 1) % MPEG1_AUDIO_QUEUE;
+            m->a_count--;
+        }
+    }
+#if LINUX == 1
+    if (m->stop) {
+        MPEG1_UNLOCK(m);
+        return;
+    }
+#endif
+    mpeg1_audio_t *a = &m->audio[(m->a_head + m->a_count) % MPEG1_AUDIO_QUEUE];
+    MPEG1_UNLOCK(m);
 
+    // the slot after the last one is only touched by the decoder
     for (int i = 0; i < PLM_AUDIO_SAMPLES_PER_FRAME; i++) {
-        buf[i] = ((signed short)(samples->left[i] + samples->left[i] * (0x7FFF / 2))) ^ 0x8000;
+        a->data[i] = ((signed short)(samples->left[i] + samples->left[i] * (0x7FFF / 2))) ^ 0x8000;
     }
+    a->time = samples->time;
 
-    m->segment = (m->segment + 1) % MPEG1_NUM_SEGMENTS;
-
-    if (voice_get_position(m->voice) == -1) {
-        voice_start(m->voice);
-    }
+    MPEG1_LOCK(m);
+    m->a_count++;
+    MPEG1_UNLOCK(m);
 }
 
 /**
- * @brief called for every video frame
+ * @brief called for every video frame, the planes are copied into the queue. Frames that are already late are dropped without copying.
  *
  * @param self the MPEG data
  * @param frame frame data
@@ -99,9 +411,153 @@ static void MPEG1_audio_decode_callback(plm_t *self, plm_samples_t *samples, voi
 static void MPEG1_video_decode_callback(plm_t *self, plm_frame_t *frame, void *user) {
     mpeg1_t *m = (mpeg1_t *)user;
 
-    plm_frame_to_bgra(frame, (uint8_t *)m->video_buffer->dat, frame->width * sizeof(uint32_t));
+    MPEG1_LOCK(m);
+    if (frame->time + m->frame_time < m->clock) {
+        m->stats.dropped++;
+        MPEG1_UNLOCK(m);
+        return;
+    }
+    while (m->v_count == MPEG1_VIDEO_QUEUE) {
+        if (MPEG1_canWait(m)) {
+            MPEG1_wait(m);
+        } else {
+            m->v_head = (m->v_head + 1) % MPEG1_VIDEO_QUEUE;
+            m->v_count--;
+            m->stats.dropped++;
+        }
+    }
+#if LINUX == 1
+    if (m->stop) {
+        MPEG1_UNLOCK(m);
+        return;
+    }
+#endif
+    mpeg1_frame_t *f = &m->video[(m->v_head + m->v_count) % MPEG1_VIDEO_QUEUE];
+    MPEG1_UNLOCK(m);
+
+    // the slot after the last one is only touched by the decoder, the planes are converted when the frame is drawn
+    memcpy(f->y, frame->y.data, MIN(frame->y.width * frame->y.height, m->y_stride * m->y_height));
+    memcpy(f->cb, frame->cb.data, MIN(frame->cb.width * frame->cb.height, m->c_stride * m->c_height));
+    memcpy(f->cr, frame->cr.data, MIN(frame->cr.width * frame->cr.height, m->c_stride * m->c_height));
+    f->time = frame->time;
+
+    MPEG1_LOCK(m);
+    m->v_count++;
+    m->stats.decoded++;
+    MPEG1_UNLOCK(m);
+}
 
-    blit(m->video_buffer, DOjS.current_bm, 0, 0, m->x, m->y, frame->width, frame->height);
+/**
+ * @brief decode one frame worth of data.
+ *
+ * @param m the MPEG playback struct
+ */
+static void MPEG1_decodeStep(mpeg1_t *m) {
+    plm_decode(m->plm, m->frame_time);
+
+    MPEG1_LOCK(m);
+    if (plm_has_ended(m->plm)) {
+        m->ended = true;
+    }
+    MPEG1_UNLOCK(m);
+}
+
+#if LINUX == 1
+/**
+ * @brief decoder thread, keeps the video queue filled.
+ *
+ * @param arg the MPEG playback struct
+ *
+ * @return always NULL
+ */
+static void *MPEG1_worker(void *arg) {
+    mpeg1_t *m = (mpeg1_t *)arg;
+
+    MPEG1_LOCK(m);
+    while (!m->stop) {
+        if (m->ended || m->v_count == MPEG1_VIDEO_QUEUE) {
+            MPEG1_wait(m);
+            continue;
+        }
+        MPEG1_UNLOCK(m);
+        MPEG1_decodeStep(m);
+        MPEG1_LOCK(m);
+    }
+    MPEG1_UNLOCK(m);
+
+    return NULL;
+}
+#endif
+
+/**
+ * @brief start decoding in the background (Linux).
+ *
+ * @param m the MPEG playback struct
+ */
+static void MPEG1_startWorker(mpeg1_t *m) {
+#if LINUX == 1
+    // the worker may fill the queues before pthread_create() returns, so it must see these already
+    MPEG1_LOCK(m);
+    m->stop = false;
+    m->worker_active = true;
+    MPEG1_UNLOCK(m);
+
+    m->running = pthread_create(&m->thread, NULL, MPEG1_worker, m) == 0;
+    if (!m->running) {
+        MPEG1_LOCK(m);
+        m->worker_active = false;
+        MPEG1_UNLOCK(m);
+        LOG("MPEG1: could not start decoder thread, decoding in Play()\n");
+    }
+#endif
+}
+
+/**
+ * @brief stop the decoder thread, the decoder may be used by the caller afterwards.
+ *
+ * @param m the MPEG playback struct
+ */
+static void MPEG1_stopWorker(mpeg1_t *m) {
+#if LINUX == 1
+    if (m->running) {
+        MPEG1_LOCK(m);
+        m->stop = true;
+        MPEG1_SIGNAL(m);
+        MPEG1_UNLOCK(m);
+        pthread_join(m->thread, NULL);
+        m->running = false;
+
+        MPEG1_LOCK(m);
+        m->worker_active = false;
+        MPEG1_UNLOCK(m);
+    }
+#endif
+}
+
+/**
+ * @brief check if a decoder thread is filling the queues.
+ *
+ * @param m the MPEG playback struct
+ *
+ * @return true if a thread is running.
+ */
+static bool MPEG1_threaded(mpeg1_t *m) {
+#if LINUX == 1
+    return m->running;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief drop all queued frames and audio segments.
+ *
+ * @param m the MPEG playback struct
+ */
+static void MPEG1_flush(mpeg1_t *m) {
+    m->v_head = m->v_count = 0;
+    m->a_head = m->a_count = 0;
+    m->ended = false;
 }
 
 /**
@@ -110,13 +566,28 @@ static void MPEG1_video_decode_callback(plm_t *self, plm_frame_t *frame, void *u
  * @param m the MPEG playback struct
  */
 static void MPEG1_cleanup(mpeg1_t *m) {
-    if (m->plm) {
-        voice_stop(m->voice);
-        deallocate_voice(m->voice);
+    MPEG1_stopWorker(m);
+    if (m->stream) {
+        if (m->voice >= 0) {
+            voice_stop(m->voice);
+            deallocate_voice(m->voice);
+            m->voice = -1;
+        }
         destroy_sample(m->stream);
         m->stream = NULL;
-        destroy_bitmap(m->video_buffer);
-        m->video_buffer = NULL;
+    }
+    for (int i = 0; i < MPEG1_VIDEO_QUEUE; i++) {
+        free(m->video[i].y);
+        m->video[i].y = m->video[i].cb = m->video[i].cr = NULL;
+    }
+    if (m->scratch) {
+        destroy_bitmap(m->scratch);
+        m->scratch = NULL;
+    }
+    free(m->xtab);
+    m->xtab = NULL;
+    m->xtab_size = 0;
+    if (m->plm) {
         plm_destroy(m->plm);
         m->plm = NULL;
     }
@@ -142,6 +613,10 @@ static void MPEG1_silence(mpeg1_t *m) {
 static void MPEG1_Finalize(js_State *J, void *data) {
     mpeg1_t *m = (mpeg1_t *)data;
     MPEG1_cleanup(m);
+#if LINUX == 1
+    pthread_mutex_destroy(&m->mutex);
+    pthread_cond_destroy(&m->cond);
+#endif
     free(m);
 }
 
@@ -159,18 +634,22 @@ static void new_MPEG1(js_State *J) {
         JS_ENOMEM(J);
         return;
     }
-    bzero(m, sizeof(mpeg1_t));
+    m->voice = -1;
+#if LINUX == 1
+    pthread_mutex_init(&m->mutex, NULL);
+    pthread_cond_init(&m->cond, NULL);
+#endif
 
     const char *fname = js_tostring(J, 1);
     m->plm = plm_create_with_filename(fname);
     if (!m->plm) {
-        free(m);
+        MPEG1_Finalize(J, m);
         js_error(J, "Could not open '%s'", fname);
         return;
     }
 
     if (!plm_has_headers(m->plm)) {
-        free(m);
+        MPEG1_Finalize(J, m);
         js_error(J, "MPEG1 header not found in '%s'", fname);
         return;
     }
@@ -179,22 +658,35 @@ static void new_MPEG1(js_State *J) {
     int width = plm_get_width(m->plm);
     int height = plm_get_height(m->plm);
     int samplerate = plm_get_samplerate(m->plm);
-
-    // allocate buffer for RGBA decoding
-    m->video_buffer = create_bitmap_ex(32, width, height);
-    if (!m->video_buffer) {
-        plm_destroy(m->plm);
-        free(m);
-        JS_ENOMEM(J);
-        return;
+    double framerate = plm_get_framerate(m->plm);
+    double duration = plm_get_duration(m->plm);
+    bool has_video = plm_get_num_video_streams(m->plm) > 0;
+    m->frame_time = 1.0 / (framerate > 0 ? framerate : 25.0);
+
+    // allocate the queued planes, the decoder works on whole macroblocks
+    m->width = width;
+    m->height = height;
+    m->y_stride = ((width + 15) >> 4) << 4;
+    m->y_height = ((height + 15) >> 4) << 4;
+    m->c_stride = m->y_stride >> 1;
+    m->c_height = m->y_height >> 1;
+    for (int i = 0; i < MPEG1_VIDEO_QUEUE; i++) {
+        int y_size = m->y_stride * m->y_height;
+        int c_size = m->c_stride * m->c_height;
+        m->video[i].y = malloc(y_size + 2 * c_size);
+        if (!m->video[i].y) {
+            MPEG1_Finalize(J, m);
+            JS_ENOMEM(J);
+            return;
+        }
+        m->video[i].cb = m->video[i].y + y_size;
+        m->video[i].cr = m->video[i].cb + c_size;
     }
 
     // allocate buffer for audio (multiple segments of "audio per frame" length)
     m->stream = create_sample(16, false, samplerate, PLM_AUDIO_SAMPLES_PER_FRAME * MPEG1_NUM_SEGMENTS);
     if (!m->stream) {
-        free(m->video_buffer);
-        plm_destroy(m->plm);
-        free(m);
+        MPEG1_Finalize(J, m);
         JS_ENOMEM(J);
         return;
     }
@@ -205,10 +697,7 @@ static void new_MPEG1(js_State *J) {
     // play the sample in looped mode
     m->voice = allocate_voice(m->stream);
     if (m->voice < 0) {
-        destroy_sample(m->stream);
-        free(m->video_buffer);
-        plm_destroy(m->plm);
-        free(m);
+        MPEG1_Finalize(J, m);
         JS_ENOMEM(J);
         return;
     }
@@ -218,7 +707,8 @@ static void new_MPEG1(js_State *J) {
     voice_set_pan(m->voice, 128);
 
     // set lead time to buffer size
-    plm_set_audio_lead_time(m->plm, (double)PLM_AUDIO_SAMPLES_PER_FRAME * MPEG1_NUM_SEGMENTS / (double)samplerate);
+    m->lead_time = samplerate > 0 ? (double)PLM_AUDIO_SAMPLES_PER_FRAME * MPEG1_NUM_SEGMENTS / (double)samplerate : 0;
+    plm_set_audio_lead_time(m->plm, m->lead_time);
 
     // set callback functions
     plm_set_video_decode_callback(m->plm, MPEG1_video_decode_callback, m);
@@ -240,17 +730,20 @@ static void new_MPEG1(js_State *J) {
     js_pushnumber(J, height);
     js_defproperty(J, -2, "height", JS_READONLY | JS_DONTCONF);
 
-    js_pushnumber(J, plm_get_framerate(m->plm));
+    js_pushnumber(J, framerate);
     js_defproperty(J, -2, "framerate", JS_READONLY | JS_DONTCONF);
 
     js_pushnumber(J, samplerate);
     js_defproperty(J, -2, "samplerate", JS_READONLY | JS_DONTCONF);
 
-    js_pushnumber(J, plm_get_duration(m->plm));
+    js_pushnumber(J, duration);
     js_defproperty(J, -2, "duration", JS_READONLY | JS_DONTCONF);
 
-    js_pushboolean(J, plm_get_num_video_streams(m->plm));
+    js_pushboolean(J, has_video);
     js_defproperty(J, -2, "has_video", JS_READONLY | JS_DONTCONF);
+
+    // from here on the decoder belongs to the worker, all metadata must be queried before
+    MPEG1_startWorker(m);
 }
 
 /**
@@ -278,9 +771,13 @@ static void MPEG1_Rewind(js_State *J) {
         return;
     }
 
+    MPEG1_stopWorker(m);
     MPEG1_silence(m);
     plm_rewind(m->plm);
+    MPEG1_flush(m);
+    m->clock = 0;
     m->last_call = 0;
+    MPEG1_startWorker(m);
 }
 
 /**
@@ -297,12 +794,17 @@ static void MPEG1_HasEnded(js_State *J) {
         return;
     }
 
-    js_pushboolean(J, plm_has_ended(m->plm));
+    MPEG1_LOCK(m);
+    bool ended = m->ended && m->v_count == 0 && m->a_count == 0;
+    MPEG1_UNLOCK(m);
+
+    js_pushboolean(J, ended);
 }
 
 /**
  * @brief play a video at position x, y. videos are rendered directly to the screen, there is no direct access to the pixels of a video.
- * m.Play(x:number, y:number)
+ * The frames are decoded by a background thread (Linux), this only converts the frame matching the current time directly into the render bitmap.
+ * m.Play(x:number, y:number[, w:number, h:number[, bilinear:boolean]])
  *
  * @param J VM state.
  */
@@ -321,14 +823,80 @@ static void MPEG1_Play(js_State *J) {
     // remember play position
     m->x = js_toint16(J, 1);
     m->y = js_toint16(J, 2);
+    m->w = js_isnumber(J, 3) ? js_toint16(J, 3) : m->width;
+    m->h = js_isnumber(J, 4) ? js_toint16(J, 4) : m->height;
+    m->bilinear = js_toboolean(J, 5);
+    if (m->w <= 0 || m->h <= 0) {
+        js_error(J, "Video size must be > 0");
+        return;
+    }
 
-    // calculate time delta and decode
-    double time = (DOjS.sys_ticks - m->last_call) / 1000.0;
+    // advance the presentation clock
+    MPEG1_LOCK(m);
+    m->clock += (DOjS.sys_ticks - m->last_call) / 1000.0;
+    MPEG1_UNLOCK(m);
     m->last_call = DOjS.sys_ticks;
-    plm_decode(m->plm, time);
+
+    // without a decoder thread decode until a frame for the current time is available
+    if (!MPEG1_threaded(m)) {
+        for (int i = 0; i < MPEG1_MAX_DECODE_STEPS && !m->ended; i++) {
+            if (m->v_count > 0 && m->video[(m->v_head + m->v_count - 1) % MPEG1_VIDEO_QUEUE].time + m->frame_time > m->clock) {
+                break;
+            }
+            MPEG1_decodeStep(m);
+        }
+    }
+
+    // copy the audio segments that are due into the looped sample
+    MPEG1_LOCK(m);
+    bool audio = false;
+    while (m->a_count > 0 && m->audio[m->a_head].time < m->clock + m->lead_time) {
+        uint16_t *buf = &(((uint16_t *)m->stream->data)[PLM_AUDIO_SAMPLES_PER_FRAME * m->segment]);
+        memcpy(buf, m->audio[m->a_head].data, sizeof(m->audio[m->a_head].data));
+        m->segment = (m->segment + 1) % MPEG1_NUM_SEGMENTS;
+
+        m->a_head = (m->a_head + 1) % MPEG1_AUDIO_QUEUE;
+        m->a_count--;
+        audio = true;
+    }
+
+    // drop frames that are superseded by a newer frame that is due, then pick the newest due frame
+    while (m->v_count > 1 && m->video[(m->v_head + 1) % MPEG1_VIDEO_QUEUE].time <= m->clock) {
+        m->v_head = (m->v_head + 1) % MPEG1_VIDEO_QUEUE;
+        m->v_count--;
+        m->stats.dropped++;
+    }
+    mpeg1_frame_t *f = NULL;
+    if (m->v_count > 0 && m->video[m->v_head].time <= m->clock) {
+        f = &m->video[m->v_head];
+    }
+    bool ended = m->ended && m->v_count == 0;
+    MPEG1_SIGNAL(m);
+    MPEG1_UNLOCK(m);
+
+    if (audio && voice_get_position(m->voice) == -1) {
+        voice_start(m->voice);
+    }
+
+    // the head slot is not touched by the decoder until it is released
+    if (f) {
+        bool ok = MPEG1_draw(m, f, DOjS.current_bm, m->x, m->y, m->w, m->h, m->bilinear);
+
+        MPEG1_LOCK(m);
+        m->v_head = (m->v_head + 1) % MPEG1_VIDEO_QUEUE;
+        m->v_count--;
+        m->stats.shown++;
+        MPEG1_SIGNAL(m);
+        MPEG1_UNLOCK(m);
+
+        if (!ok) {
+            JS_ENOMEM(J);
+            return;
+        }
+    }
 
     // silence audio if end of video
-    if (plm_has_ended(m->plm)) {
+    if (ended) {
         MPEG1_silence(m);
     }
 }
@@ -345,7 +913,14 @@ static void MPEG1_Seek(js_State *J) {
         return;
     }
 
-    if (!plm_seek(m->plm, js_tonumber(J, 1), true)) {
+    MPEG1_stopWorker(m);
+    MPEG1_flush(m);
+    m->clock = 0;  // the frame found by seeking must not be dropped
+    bool ok = plm_seek(m->plm, js_tonumber(J, 1), true);
+    m->clock = plm_get_time(m->plm);
+    MPEG1_startWorker(m);
+
+    if (!ok) {
         js_error(J, "Seek failed");
         return;
     }
@@ -363,7 +938,43 @@ static void MPEG1_CurrentTime(js_State *J) {
         return;
     }
 
-    js_pushnumber(J, plm_get_time(m->plm));
+    MPEG1_LOCK(m);
+    double clock = m->clock;
+    MPEG1_UNLOCK(m);
+
+    js_pushnumber(J, clock);
+}
+
+/**
+ * @brief get playback statistics.
+ * m.GetStats():{decoded:number, shown:number, dropped:number, queued:number, audioQueued:number}
+ *
+ * @param J VM state.
+ */
+static void MPEG1_GetStats(js_State *J) {
+    mpeg1_t *m = js_touserdata(J, 0, TAG_MPEG1);
+
+    MPEG1_LOCK(m);
+    mpeg1_stats_t stats = m->stats;
+    int queued = m->v_count;
+    int audio_queued = m->a_count;
+    MPEG1_UNLOCK(m);
+
+    js_newobject(J);
+    {
+        js_pushnumber(J, stats.decoded);
+        js_setproperty(J, -2, "decoded");
+        js_pushnumber(J, stats.shown);
+        js_setproperty(J, -2, "shown");
+        js_pushnumber(J, stats.dropped);
+        js_setproperty(J, -2, "dropped");
+        js_pushnumber(J, queued);
+        js_setproperty(J, -2, "queued");
+        js_pushnumber(J, audio_queued);
+        js_setproperty(J, -2, "audioQueued");
+        js_pushboolean(J, MPEG1_threaded(m));
+        js_setproperty(J, -2, "threaded");
+    }
 }
 
 /*********************
@@ -377,14 +988,17 @@ static void MPEG1_CurrentTime(js_State *J) {
 void init_mpeg1(js_State *J) {
     LOGF("%s\n", __PRETTY_FUNCTION__);
 
+    MPEG1_initTables();
+
     js_newobject(J);
     {
         NPROTDEF(J, MPEG1, Close, 0);
         NPROTDEF(J, MPEG1, Rewind, 0);
         NPROTDEF(J, MPEG1, HasEnded, 0);
-        NPROTDEF(J, MPEG1, Play, 2);
+        NPROTDEF(J, MPEG1, Play, 5);
         NPROTDEF(J, MPEG1, Seek, 1);
         NPROTDEF(J, MPEG1, CurrentTime, 0);
+        NPROTDEF(J, MPEG1, GetStats, 0);
     }
     CTORDEF(J, new_MPEG1, TAG_MPEG1, 2);
 }
@@ -46,7 +46,7 @@ static void Bitmap_RenderSVG(js_State *J) {
     NSVGimage *image = NULL;
     NSVGrasterizer *rast = NULL;
     unsigned char *img = NULL;
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     const char *fname = js_tostring(J, 1);
 
     image = nsvgParseFromFile(fname, "px", 96.0f);
@@ -20,7 +20,13 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "../neural.dxelib/doublearray.h"
 #include "bitmap.h"
+#include "intarray.h"
 #include "ogl.h"
 
 #if LINUX != 1
@@ -29,6 +35,12 @@ SOFTWARE.
 #include <GL/glut.h>
 
 #include <GL/fxmesa.h>
+#elif USE_OSMESA == 1
+#include <GL/osmesa.h>
+
+#include <GL/gl.h>
+#include <GL/glu.h>
+#include <GL/glut.h>
 #else
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -106,6 +118,9 @@ SOFTWARE.
 //! OpenGL context from the used library
 #if LINUX != 1
 static fxMesaContext fc = NULL;
+#elif USE_OSMESA == 1
+static OSMesaContext osmesa = NULL;
+static BITMAP *osmesa_bm = NULL;  //!< the BITMAP OSMesa renders into, pinned as render target
 #else
 static GLFWwindow *window;
 #endif
@@ -113,6 +128,173 @@ static GLFWwindow *window;
 void init_ogl(js_State *J);
 void shutdown_ogl(void);
 
+//! number of Bitmaps whose textures are kept by glBitmapTexture()
+#define OGL_TEXTURE_CACHE 16
+
+//! pixel data of a Bitmap region prepared for glTexImage*()/glDrawPixels()
+typedef struct {
+    const GLvoid *pixels;  //!< first pixel of the region
+    GLenum format;         //!< GL_BGRA for unconverted 32bpp bitmaps, else GL_RGBA
+    void *buffer;          //!< converted copy that must be freed, NULL if 'pixels' points into the BITMAP
+} ogl_pixels_t;
+
+//! a texture uploaded by glBitmapTexture(), the Bitmap is kept alive in the registry
+typedef struct {
+    BITMAP *bm;         //!< BITMAP that was uploaded, the Bitmap object may have been copied on write since
+    GLuint tex;         //!< texture name, 0 for an unused entry
+    uint32_t last_use;  //!< value of ogl_texture_clock when the entry was last used
+} ogl_texture_t;
+
+static ogl_texture_t ogl_textures[OGL_TEXTURE_CACHE];
+static uint32_t ogl_texture_clock = 0;
+
+/**
+ * @brief prepare a region of a Bitmap for uploading. 32bpp memory bitmaps are passed to GL as they are (ARGB in memory is GL_BGRA),
+ * GL_UNPACK_ROW_LENGTH is set to the pitch of the bitmap in that case. Everything else is converted to RGBA row by row.
+ * ogl_release_pixels() must be called after the upload.
+ *
+ * @param bm the bitmap.
+ * @param x left of the region.
+ * @param y top of the region.
+ * @param w width of the region.
+ * @param h height of the region.
+ * @param packed the rows must follow each other without gaps (GL_UNPACK_ROW_LENGTH is ignored for 1D textures).
+ * @param px the prepared data is stored here.
+ *
+ * @return false if the memory for the conversion could not be allocated.
+ */
+static bool ogl_get_pixels(BITMAP *bm, int x, int y, int w, int h, bool packed, ogl_pixels_t *px) {
+    bool argb = is_memory_bitmap(bm) && bitmap_color_depth(bm) == 32;
+
+#ifdef GL_BGRA
+    if (argb && _rgb_r_shift_32 == 16 && _rgb_g_shift_32 == 8 && _rgb_b_shift_32 == 0 && _rgb_a_shift_32 == 24) {
+        int pitch = h > 1 ? (int)(bm->line[y + 1] - bm->line[y]) : w * (int)sizeof(uint32_t);
+        if (!packed || pitch == w * (int)sizeof(uint32_t)) {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / sizeof(uint32_t));
+            px->pixels = bm->line[y] + x * sizeof(uint32_t);
+            px->format = GL_BGRA;
+            px->buffer = NULL;
+            return true;
+        }
+    }
+#endif
+
+    uint8_t *data = malloc(w * h * sizeof(uint32_t));
+    if (!data) {
+        return false;
+    }
+
+    // convert bitmap into new memory (argb ->rgba)
+    uint8_t *p = data;
+    for (int yy = y; yy < y + h; yy++) {
+        if (argb) {
+            uint32_t *line = (uint32_t *)bm->line[yy] + x;
+            for (int xx = 0; xx < w; xx++) {
+                uint32_t c = line[xx];
+                *p++ = getr32(c);
+                *p++ = getg32(c);
+                *p++ = getb32(c);
+                *p++ = geta32(c);
+            }
+        } else {
+            for (int xx = x; xx < x + w; xx++) {
+                uint32_t argb = getpixel(bm, xx, yy);
+
+                *p++ = (argb >> 16) & 0xFF;  // R
+                *p++ = (argb >> 8) & 0xFF;   // G
+                *p++ = (argb >> 0) & 0xFF;   // B
+                *p++ = (argb >> 24) & 0xFF;  // A
+            }
+        }
+    }
+    px->pixels = data;
+    px->format = GL_RGBA;
+    px->buffer = data;
+    return true;
+}
+
+/**
+ * @brief free the memory of ogl_get_pixels() and restore the unpack state.
+ *
+ * @param px the data returned by ogl_get_pixels().
+ */
+static void ogl_release_pixels(ogl_pixels_t *px) {
+    if (px->buffer) {
+        free(px->buffer);
+        px->buffer = NULL;
+    } else {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+}
+
+/**
+ * @brief upload a Bitmap to the bound 2D texture.
+ *
+ * @param J VM state.
+ * @param bm the bitmap.
+ * @param lvl mipmap level.
+ * @param intform internal format.
+ * @param border texture border.
+ */
+static void ogl_tex_image(js_State *J, BITMAP *bm, GLint lvl, GLint intform, GLint border) {
+    ogl_pixels_t px;
+    if (!ogl_get_pixels(bm, 0, 0, bm->w, bm->h, false, &px)) {
+        JS_ENOMEM(J);
+        return;
+    }
+    glTexImage2D(GL_TEXTURE_2D, lvl, intform, bm->w, bm->h, border, px.format, GL_UNSIGNED_BYTE, px.pixels);
+    ogl_release_pixels(&px);
+}
+
+/**
+ * @brief replace a region of the bound 2D texture with a region of a Bitmap.
+ *
+ * @param J VM state.
+ * @param bm the bitmap.
+ * @param lvl mipmap level.
+ * @param xoff left of the region in the texture.
+ * @param yoff top of the region in the texture.
+ * @param x left of the region in the bitmap.
+ * @param y top of the region in the bitmap.
+ * @param w width of the region.
+ * @param h height of the region.
+ */
+static void ogl_tex_subimage(js_State *J, BITMAP *bm, GLint lvl, GLint xoff, GLint yoff, int x, int y, int w, int h) {
+    ogl_pixels_t px;
+    if (!ogl_get_pixels(bm, x, y, w, h, false, &px)) {
+        JS_ENOMEM(J);
+        return;
+    }
+    glTexSubImage2D(GL_TEXTURE_2D, lvl, xoff, yoff, w, h, px.format, GL_UNSIGNED_BYTE, px.pixels);
+    ogl_release_pixels(&px);
+}
+
+/**
+ * @brief forget all textures of glBitmapTexture().
+ *
+ * @param J VM state or NULL if the registry shall not be touched (on shutdown).
+ * @param free_textures delete the GL textures as well.
+ */
+static void ogl_clear_textures(js_State *J, bool free_textures) {
+    char key[32];
+
+    for (int i = 0; i < OGL_TEXTURE_CACHE; i++) {
+        ogl_texture_t *t = &ogl_textures[i];
+        if (t->tex) {
+            if (free_textures) {
+                glDeleteTextures(1, &t->tex);
+            }
+            if (J) {
+                snprintf(key, sizeof(key), "ogl_texture_%d", i);
+                js_delregistry(J, key);
+            }
+        }
+        t->bm = NULL;
+        t->tex = 0;
+        t->last_use = 0;
+    }
+}
+
 /*********************
 ** static functions **
 *********************/
@@ -144,6 +326,71 @@ static void f_glInit(js_State *J) {
     LOGF("  OpenGL Extensions: %s\n", glGetString(GL_EXTENSIONS));
     LOGF("  GLU Version      : %s\n", gluGetString(GLU_VERSION));
     LOGF("  GLU Extensions   : %s\n", gluGetString(GLU_EXTENSIONS));
+#elif USE_OSMESA == 1
+    // render into the given Bitmap or the DOjS render buffer, GL and 2D drawing share the same memory
+    BITMAP *bm;
+    if (js_isuserdata(J, 1, TAG_BITMAP)) {
+        bm = Bitmap_writable(J, 1);
+        if (!bm) {
+            return;
+        }
+    } else {
+        bm = DOjS.render_bm;
+    }
+    if (!is_memory_bitmap(bm) || bitmap_color_depth(bm) != 32 || (bm->h > 1 && bm->line[1] - bm->line[0] < bm->w * (int)sizeof(uint32_t))) {
+        js_error(J, "OSMesa needs a 32bpp memory bitmap");
+        return;
+    }
+
+    if (osmesa) {
+        OSMesaDestroyContext(osmesa);
+        osmesa = NULL;
+    }
+    Bitmap_unpinTarget(osmesa_bm);
+    osmesa_bm = NULL;
+    osmesa = OSMesaCreateContextExt(OSMESA_BGRA, 24, 8, 0, NULL);
+    if (!osmesa) {
+        js_error(J, "OSMesa: No context");
+        return;
+    }
+    if (!OSMesaMakeCurrent(osmesa, bm->line[0], GL_UNSIGNED_BYTE, bm->w, bm->h)) {
+        OSMesaDestroyContext(osmesa);
+        osmesa = NULL;
+        js_error(J, "OSMesa: could not bind bitmap");
+        return;
+    }
+    OSMesaPixelStore(OSMESA_Y_UP, 0);  // first row is the top, same as Allegro
+    if (bm->h > 1) {
+        OSMesaPixelStore(OSMESA_ROW_LENGTH, (bm->line[1] - bm->line[0]) / sizeof(uint32_t));
+    }
+
+    // keep a Bitmap alive while GL renders into it and don't use its optimized form
+    if (!Bitmap_pinTarget(bm)) {
+        OSMesaDestroyContext(osmesa);
+        osmesa = NULL;
+        JS_ENOMEM(J);
+        return;
+    }
+    osmesa_bm = bm;
+    if (js_isuserdata(J, 1, TAG_BITMAP)) {
+        js_copy(J, 1);
+    } else {
+        js_pushnull(J);
+    }
+    js_setregistry(J, "ogl_osmesa_bitmap");
+
+    // the viewport size is the size of the bitmap
+    js_getglobal(J, "GL");
+    js_pushnumber(J, bm->w);
+    js_setproperty(J, -2, "WIDTH");
+    js_pushnumber(J, bm->h);
+    js_setproperty(J, -2, "HEIGHT");
+    js_pop(J, 1);
+
+    LOGF("OSMesa offscreen OpenGL module initialized (%dx%d)\n", bm->w, bm->h);
+    LOGF("  OpenGL Vendor    : %s\n", glGetString(GL_VENDOR));
+    LOGF("  OpenGL Renderer  : %s\n", glGetString(GL_RENDERER));
+    LOGF("  OpenGL Version   : %s\n", glGetString(GL_VERSION));
 #else
     glewExperimental = true;  // Needed for core profile
     if (!glfwInit()) {
@@ -171,13 +418,13 @@ static void f_glInit(js_State *J) {
 #endif
 }
 
-static void f_glShutdown(js_State *J) { shutdown_ogl(); }
-
 static void f_glFlush(js_State *J) {
     glFlush();
 
 #if LINUX != 1
     fxMesaSwapBuffers();
+#elif USE_OSMESA == 1
+    glFinish();  // the Bitmap must be complete before it is used for 2D drawing
 #else
     glfwSwapBuffers(window);
 #endif
@@ -312,30 +559,15 @@ static void f_glDrawPixels(js_State *J) {
         js_error(J, "parameter must be a bitmap");
         return;
     }
-    BITMAP *bm = js_touserdata(J, 1, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 1);
 
-    // allocate memory
-    size_t tx_size = bm->w * bm->h * sizeof(uint32_t);
-    void *tx_data = malloc(tx_size);
-    if (!tx_data) {
+    ogl_pixels_t px;
+    if (!ogl_get_pixels(bm, 0, 0, bm->w, bm->h, false, &px)) {
         JS_ENOMEM(J);
         return;
     }
-
-    // convert bitmap into new memory (argb ->rgba)
-    int p = 0;
-    for (int y = 0; y < bm->h; y++) {
-        for (int x = 0; x < bm->w; x++) {
-            uint32_t argb = getpixel(bm, x, y);
-
-            ((uint8_t *)tx_data)[p++] = (argb >> 16) & 0xFF;  // R
-            ((uint8_t *)tx_data)[p++] = (argb >> 8) & 0xFF;   // G
-            ((uint8_t *)tx_data)[p++] = (argb >> 0) & 0xFF;   // B
-            ((uint8_t *)tx_data)[p++] = (argb >> 24) & 0xFF;  // A
-        }
-    }
-    glDrawPixels(bm->w, bm->h, GL_RGBA, GL_UNSIGNED_BYTE, tx_data);
-    free(tx_data);
+    glDrawPixels(bm->w, bm->h, px.format, GL_UNSIGNED_BYTE, px.pixels);
+    ogl_release_pixels(&px);
 }
 
 static void f_glutWireCube(js_State *J) { glutWireCube(js_tonumber(J, 1)); }
@@ -644,30 +876,7 @@ static void f_glTexImage2D(js_State *J) {
         js_error(J, "parameter must be a bitmap");
         return;
     }
-    BITMAP *bm = js_touserdata(J, 4, TAG_BITMAP);
-
-    // allocate memory
-    size_t tx_size = bm->w * bm->h * sizeof(uint32_t);
-    void *tx_data = malloc(tx_size);
-    if (!tx_data) {
-        JS_ENOMEM(J);
-        return;
-    }
-
-    // convert bitmap into new memory (argb ->rgba)
-    int p = 0;
-    for (int y = 0; y < bm->h; y++) {
-        for (int x = 0; x < bm->w; x++) {
-            uint32_t argb = getpixel(bm, x, y);
-
-            ((uint8_t *)tx_data)[p++] = (argb >> 16) & 0xFF;  // R
-            ((uint8_t *)tx_data)[p++] = (argb >> 8) & 0xFF;   // G
-            ((uint8_t *)tx_data)[p++] = (argb >> 0) & 0xFF;   // B
-            ((uint8_t *)tx_data)[p++] = (argb >> 24) & 0xFF;  // A
-        }
-    }
-    glTexImage2D(GL_TEXTURE_2D, lvl, intform, bm->w, bm->h, border, GL_RGBA, GL_UNSIGNED_BYTE, tx_data);
-    free(tx_data);
+    ogl_tex_image(J, Bitmap_get(J, 4), lvl, intform, border);
 }
 
 static void f_glTexImage1D(js_State *J) {
@@ -679,38 +888,117 @@ static void f_glTexImage1D(js_State *J) {
         js_error(J, "parameter must be an bitmap");
         return;
     }
-    BITMAP *bm = js_touserdata(J, 4, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 4);
 
     if (bm->w > 1 && bm->h > 1) {
         js_error(J, "one dimension of the bitmap must be 1");
         return;
     }
 
-    // allocate memory
-    size_t tx_size = bm->w * bm->h * sizeof(uint32_t);
-    void *tx_data = malloc(tx_size);
-    if (!tx_data) {
+    ogl_pixels_t px;
+    if (!ogl_get_pixels(bm, 0, 0, bm->w, bm->h, true, &px)) {
         JS_ENOMEM(J);
         return;
     }
+    glTexImage1D(GL_TEXTURE_1D, lvl, intform, bm->w * bm->h, border, px.format, GL_UNSIGNED_BYTE, px.pixels);
+    ogl_release_pixels(&px);
+}
 
-    // convert bitmap into new memory (argb ->rgba)
-    int p = 0;
-    for (int y = 0; y < bm->h; y++) {
-        for (int x = 0; x < bm->w; x++) {
-            uint32_t argb = getpixel(bm, x, y);
-
-            ((uint8_t *)tx_data)[p++] = (argb >> 16) & 0xFF;  // R
-            ((uint8_t *)tx_data)[p++] = (argb >> 8) & 0xFF;   // G
-            ((uint8_t *)tx_data)[p++] = (argb >> 0) & 0xFF;   // B
-            ((uint8_t *)tx_data)[p++] = (argb >> 24) & 0xFF;  // A
+static void f_glTexSubImage2D(js_State *J) {
+    GLint lvl = js_toint32(J, 1);
+    GLint xoff = js_toint32(J, 2);
+    GLint yoff = js_toint32(J, 3);
+
+    if (!js_isuserdata(J, 4, TAG_BITMAP)) {
+        js_error(J, "parameter must be a bitmap");
+        return;
+    }
+    BITMAP *bm = Bitmap_get(J, 4);
+
+    int x = js_isdefined(J, 5) ? js_toint32(J, 5) : 0;
+    int y = js_isdefined(J, 6) ? js_toint32(J, 6) : 0;
+    int w = js_isdefined(J, 7) ? js_toint32(J, 7) : bm->w - x;
+    int h = js_isdefined(J, 8) ? js_toint32(J, 8) : bm->h - y;
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > bm->w || y + h > bm->h) {
+        js_error(J, "region %d,%d %dx%d is outside of the bitmap", x, y, w, h);
+        return;
+    }
+    ogl_tex_subimage(J, bm, lvl, xoff, yoff, x, y, w, h);
+}
+
+static void f_glBitmapTexture(js_State *J) {
+    char key[32];
+
+    if (!js_isuserdata(J, 1, TAG_BITMAP)) {
+        js_error(J, "parameter must be a bitmap");
+        return;
+    }
+    BITMAP *bm = Bitmap_get(J, 1);
+    bool update = js_toboolean(J, 2);
+
+    // search for the Bitmap object, remember the least recently used entry in case it is not found
+    ogl_texture_t *t = NULL;
+    ogl_texture_t *lru = &ogl_textures[0];
+    int idx = 0;
+    for (int i = 0; i < OGL_TEXTURE_CACHE; i++) {
+        ogl_texture_t *e = &ogl_textures[i];
+        if (!e->tex) {
+            if (lru->tex) {
+                lru = e;
+                idx = i;
+            }
+            continue;
+        }
+        snprintf(key, sizeof(key), "ogl_texture_%d", i);
+        js_getregistry(J, key);
+        js_copy(J, 1);
+        bool found = js_strictequal(J);
+        js_pop(J, 2);
+        if (found) {
+            t = e;
+            idx = i;
+            break;
+        }
+        if (lru->tex && e->last_use < lru->last_use) {
+            lru = e;
+            idx = i;
         }
     }
 
-    glTexImage1D(GL_TEXTURE_1D, lvl, intform, bm->w * bm->h, border, GL_RGBA, GL_UNSIGNED_BYTE, tx_data);
-    free(tx_data);
+    if (t) {
+        glBindTexture(GL_TEXTURE_2D, t->tex);
+        if (t->bm != bm) {
+            // the Bitmap got a new BITMAP (copy on write), the size is the same
+            ogl_tex_subimage(J, bm, 0, 0, 0, 0, 0, bm->w, bm->h);
+            t->bm = bm;
+        } else if (update) {
+            ogl_tex_subimage(J, bm, 0, 0, 0, 0, 0, bm->w, bm->h);
+        }
+    } else {
+        t = lru;
+        if (t->tex) {
+            glDeleteTextures(1, &t->tex);
+            t->tex = 0;
+        }
+        glGenTextures(1, &t->tex);
+        glBindTexture(GL_TEXTURE_2D, t->tex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        ogl_tex_image(J, bm, 0, GL_RGBA, 0);
+        t->bm = bm;
+
+        // keep the Bitmap alive as long as its texture is cached
+        snprintf(key, sizeof(key), "ogl_texture_%d", idx);
+        js_copy(J, 1);
+        js_setregistry(J, key);
+    }
+    t->last_use = ++ogl_texture_clock;
+
+    js_pushnumber(J, t->tex);
 }
 
+static void f_glClearTextureCache(js_State *J) { ogl_clear_textures(J, true); }
+
 static void f_glReadPixels(js_State *J) {
     GLint x = js_touint32(J, 1);
     GLint y = js_touint32(J, 2);
@@ -812,6 +1100,262 @@ static void f_gluLookAt(js_State *J) {
               js_tonumber(J, 9));
 }
 
+//////
+// vertex arrays
+
+//! client side arrays that can be bound with gl*Pointer()
+enum { OGL_ARRAY_VERTEX, OGL_ARRAY_COLOR, OGL_ARRAY_NORMAL, OGL_ARRAY_TEXCOORD, OGL_ARRAY_MAX };
+
+//! a client side array, the JS buffer is kept alive in the registry so GL can read it directly
+typedef struct {
+    const char *reg;      //!< registry key for the bound DoubleArray/IntArray
+    GLenum cap;           //!< client state that enables this array
+    GLint size;           //!< number of components per vertex
+    GLsizei stride;       //!< distance between two vertices in elements (0 for tightly packed)
+    uint32_t offset;      //!< index of the first element used
+    bool bound;           //!< a buffer is bound
+    bool native;          //!< buffer is a DoubleArray/IntArray, else a converted JS array in 'copy'
+    GLfloat *copy;        //!< converted JS array
+    uint32_t copy_size;   //!< number of valid entries in 'copy'
+    uint32_t copy_alloc;  //!< number of allocated entries in 'copy'
+} ogl_array_t;
+
+static ogl_array_t ogl_arrays[OGL_ARRAY_MAX] = {
+    {.reg = "ogl_vertex_array", .cap = GL_VERTEX_ARRAY},
+    {.reg = "ogl_color_array", .cap = GL_COLOR_ARRAY},
+    {.reg = "ogl_normal_array", .cap = GL_NORMAL_ARRAY, .size = 3},
+    {.reg = "ogl_texcoord_array", .cap = GL_TEXTURE_COORD_ARRAY},
+};
+
+/**
+ * @brief bind a buffer to a client side array. DoubleArray and IntArray are used without copying, JS arrays are converted to float.
+ *
+ * @param J VM state.
+ * @param a the array to bind.
+ * @param size number of components per vertex.
+ * @param idx stack index of the buffer, followed by the optional stride and offset (in elements).
+ */
+static void ogl_bind_array(js_State *J, ogl_array_t *a, GLint size, int idx) {
+    GLsizei stride = js_isdefined(J, idx + 1) ? js_toint32(J, idx + 1) : 0;
+    int offset = js_isdefined(J, idx + 2) ? js_toint32(J, idx + 2) : 0;
+
+    if (size < 1 || size > 4) {
+        js_error(J, "size must be 1..4: %d", size);
+        return;
+    }
+    if ((stride != 0 && stride < size) || offset < 0) {
+        js_error(J, "stride must be 0 or >= size and offset must be positive");
+        return;
+    }
+
+    if (js_isuserdata(J, idx, TAG_DOUBLE_ARRAY) || js_isuserdata(J, idx, TAG_INT_ARRAY)) {
+        js_copy(J, idx);
+        js_setregistry(J, a->reg);
+        a->native = true;
+    } else if (js_isarray(J, idx)) {
+        uint32_t len = js_getlength(J, idx);
+        if (len > a->copy_alloc) {
+            GLfloat *copy = realloc(a->copy, len * sizeof(GLfloat));
+            if (!copy) {
+                JS_ENOMEM(J);
+                return;
+            }
+            a->copy = copy;
+            a->copy_alloc = len;
+        }
+        for (uint32_t i = 0; i < len; i++) {
+            js_getindex(J, idx, i);
+            a->copy[i] = js_tonumber(J, -1);
+            js_pop(J, 1);
+        }
+        a->copy_size = len;
+        js_delregistry(J, a->reg);
+        a->native = false;
+    } else if (js_isundefined(J, idx) || js_isnull(J, idx)) {
+        js_delregistry(J, a->reg);
+        a->bound = false;
+        return;
+    } else {
+        js_error(J, "buffer must be a DoubleArray, IntArray or an array of numbers");
+        return;
+    }
+
+    a->size = size;
+    a->stride = stride;
+    a->offset = offset;
+    a->bound = true;
+}
+
+/**
+ * @brief pass the current data pointer of an array to GL. This is done before every draw call because DoubleArray/IntArray may reallocate their memory when they grow.
+ *
+ * @param J VM state.
+ * @param a the array.
+ *
+ * @return the number of complete vertices in the array.
+ */
+static uint32_t ogl_apply_array(js_State *J, ogl_array_t *a) {
+    const uint8_t *data;
+    uint32_t len;
+    GLenum type;
+    size_t elem;
+
+    if (a->native) {
+        js_getregistry(J, a->reg);
+        if (js_isuserdata(J, -1, TAG_DOUBLE_ARRAY)) {
+            double_array_t *da = js_touserdata(J, -1, TAG_DOUBLE_ARRAY);
+            data = (const uint8_t *)da->data;
+            len = da->size;
+            type = GL_DOUBLE;
+            elem = sizeof(DA_TYPE);
+        } else {
+            int_array_t *ia = js_touserdata(J, -1, TAG_INT_ARRAY);
+            data = (const uint8_t *)ia->data;
+            len = ia->size;
+            type = GL_INT;
+            elem = sizeof(IA_TYPE);
+        }
+        js_pop(J, 1);
+    } else {
+        data = (const uint8_t *)a->copy;
+        len = a->copy_size;
+        type = GL_FLOAT;
+        elem = sizeof(GLfloat);
+    }
+
+    GLsizei stride = a->stride * elem;
+    const GLvoid *ptr = data + a->offset * elem;
+    switch (a->cap) {
+        case GL_VERTEX_ARRAY:
+            glVertexPointer(a->size, type, stride, ptr);
+            break;
+        case GL_COLOR_ARRAY:
+            glColorPointer(a->size, type, stride, ptr);
+            break;
+        case GL_NORMAL_ARRAY:
+            glNormalPointer(type, stride, ptr);
+            break;
+        case GL_TEXTURE_COORD_ARRAY:
+            glTexCoordPointer(a->size, type, stride, ptr);
+            break;
+    }
+
+    if (len < a->offset + a->size) {
+        return 0;
+    }
+    return (len - a->offset - a->size) / (a->stride ? a->stride : a->size) + 1;
+}
+
+/**
+ * @brief update all enabled arrays before drawing.
+ *
+ * @param J VM state.
+ *
+ * @return the number of vertices that can be drawn with the enabled arrays.
+ */
+static uint32_t ogl_prepare_arrays(js_State *J) {
+    uint32_t avail = UINT32_MAX;
+
+    for (int i = 0; i < OGL_ARRAY_MAX; i++) {
+        ogl_array_t *a = &ogl_arrays[i];
+        if (!glIsEnabled(a->cap)) {
+            continue;
+        }
+        if (!a->bound) {
+            js_error(J, "client state %d is enabled but no buffer was bound", a->cap);
+            return 0;
+        }
+        avail = MIN(avail, ogl_apply_array(J, a));
+    }
+    return avail;
+}
+
+static void f_glVertexPointer(js_State *J) { ogl_bind_array(J, &ogl_arrays[OGL_ARRAY_VERTEX], js_toint32(J, 1), 2); }
+static void f_glColorPointer(js_State *J) { ogl_bind_array(J, &ogl_arrays[OGL_ARRAY_COLOR], js_toint32(J, 1), 2); }
+static void f_glNormalPointer(js_State *J) { ogl_bind_array(J, &ogl_arrays[OGL_ARRAY_NORMAL], 3, 1); }
+static void f_glTexCoordPointer(js_State *J) { ogl_bind_array(J, &ogl_arrays[OGL_ARRAY_TEXCOORD], js_toint32(J, 1), 2); }
+
+static void f_glShutdown(js_State *J) {
+    // release the Bitmaps and arrays kept alive for GL, shutdown_ogl() can't do that as the JS state may already be gone when it is called
+    ogl_clear_textures(J, false);  // the textures are freed with the context
+    for (int i = 0; i < OGL_ARRAY_MAX; i++) {
+        js_delregistry(J, ogl_arrays[i].reg);
+    }
+#if LINUX == 1 && USE_OSMESA == 1
+    js_delregistry(J, "ogl_osmesa_bitmap");
+#endif
+
+    shutdown_ogl();
+}
+
+static void f_glDrawArrays(js_State *J) {
+    GLenum mode = js_touint32(J, 1);
+    int first = js_toint32(J, 2);
+    int count = js_toint32(J, 3);
+
+    uint32_t avail = ogl_prepare_arrays(J);
+    if (first < 0 || count < 0 || (uint32_t)first + count > avail) {
+        js_error(J, "vertex range %d..%d exceeds the bound arrays (%u vertices)", first, first + count, avail);
+        return;
+    }
+    glDrawArrays(mode, first, count);
+}
+
+static void f_glDrawElements(js_State *J) {
+    GLenum mode = js_touint32(J, 1);
+    const GLuint *indices;
+    GLuint *copy = NULL;
+    uint32_t len;
+
+    if (js_isuserdata(J, 2, TAG_INT_ARRAY)) {
+        int_array_t *ia = js_touserdata(J, 2, TAG_INT_ARRAY);
+        indices = (const GLuint *)ia->data;
+        len = ia->size;
+    } else if (js_isarray(J, 2)) {
+        len = js_getlength(J, 2);
+        copy = malloc(len * sizeof(GLuint) + 1);
+        if (!copy) {
+            JS_ENOMEM(J);
+            return;
+        }
+        for (uint32_t i = 0; i < len; i++) {
+            js_getindex(J, 2, i);
+            copy[i] = js_touint32(J, -1);
+            js_pop(J, 1);
+        }
+        indices = copy;
+    } else {
+        js_error(J, "indices must be an IntArray or an array of numbers");
+        return;
+    }
+
+    int count = js_isdefined(J, 3) ? js_toint32(J, 3) : (int)len;
+    if (count < 0 || (uint32_t)count > len) {
+        free(copy);
+        js_error(J, "count must be 0..%u: %d", len, count);
+        return;
+    }
+
+    // every index is checked so GL never reads beyond the bound buffers
+    uint32_t avail = 0;
+    if (js_try(J)) {
+        free(copy);
+        js_throw(J);
+    }
+    avail = ogl_prepare_arrays(J);
+    js_endtry(J);
+    for (int i = 0; i < count; i++) {
+        if (indices[i] >= avail) {
+            free(copy);
+            js_error(J, "index %u at %d exceeds the bound arrays (%u vertices)", indices[i], i, avail);
+            return;
+        }
+    }
+
+    glDrawElements(mode, count, GL_UNSIGNED_INT, indices);
+    free(copy);
+}
+
 /**
  * @brief initialize OpenGL (dummy).
  *
@@ -847,9 +1391,10 @@ void init_ogl(js_State *J) {
         // define global functions
 #endif
         // 0 param
-        NFUNCDEF(J, glInit, 0);
+        NFUNCDEF(J, glInit, 1);
         NFUNCDEF(J, glShutdown, 0);
         NFUNCDEF(J, glFlush, 0);
+        NFUNCDEF(J, glClearTextureCache, 0);
         NFUNCDEF(J, glFinish, 0);
         NFUNCDEF(J, glEnd, 0);
         NFUNCDEF(J, glLoadIdentity, 0);
@@ -921,6 +1466,7 @@ void init_ogl(js_State *J) {
         NFUNCDEF(J, glDeleteLists, 2);
         NFUNCDEF(J, glNewList, 2);
         NFUNCDEF(J, glBindTexture, 2);
+        NFUNCDEF(J, glBitmapTexture, 2);
         NFUNCDEF(J, glTexCoord2, 2);
         NFUNCDEF(J, glRasterPos2, 2);
         NFUNCDEF(J, glPolygonOffset, 2);
@@ -965,6 +1511,7 @@ void init_ogl(js_State *J) {
         NFUNCDEF(J, glStencilFunc, 3);
         NFUNCDEF(J, glStencilOp, 3);
         NFUNCDEF(J, glTexImage1D, 3);
+        NFUNCDEF(J, glTexSubImage2D, 8);
         NFUNCDEF(J, glTexEnv, 3);
         NFUNCDEF(J, glTexGen, 3);
         NFUNCDEF(J, glGetTexLevelParameter, 3);
@@ -1010,6 +1557,15 @@ void init_ogl(js_State *J) {
         // 9 param
         NFUNCDEF(J, gluLookAt, 9);
 
+        //////
+        // vertex arrays
+        NFUNCDEF(J, glVertexPointer, 4);
+        NFUNCDEF(J, glColorPointer, 4);
+        NFUNCDEF(J, glNormalPointer, 3);
+        NFUNCDEF(J, glTexCoordPointer, 4);
+        NFUNCDEF(J, glDrawArrays, 3);
+        NFUNCDEF(J, glDrawElements, 3);
+
         // opengl constants
         ogl_create_constants(J);
 #if LINUX != 1
@@ -1020,11 +1576,26 @@ void init_ogl(js_State *J) {
 }
 
 void shutdown_ogl() {
+    for (int i = 0; i < OGL_ARRAY_MAX; i++) {
+        free(ogl_arrays[i].copy);
+        ogl_arrays[i].copy = NULL;
+        ogl_arrays[i].copy_alloc = ogl_arrays[i].copy_size = 0;
+        ogl_arrays[i].bound = false;
+    }
+    ogl_clear_textures(NULL, false);  // the textures are freed with the context
+
 #if LINUX != 1
     if (fc) {
         fxMesaDestroyContext(fc);
         fc = NULL;
     }
+#elif USE_OSMESA == 1
+    if (osmesa) {
+        OSMesaDestroyContext(osmesa);
+        osmesa = NULL;
+    }
+    Bitmap_unpinTarget(osmesa_bm);
+    osmesa_bm = NULL;
 #else
     glfwTerminate();
 #endif
@@ -1036,26 +1607,14 @@ void shutdown_ogl() {
 //  * Vertex Arrays  (1.1)
 //  */
 
-// GLAPI void GLAPIENTRY glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr);
-
-// GLAPI void GLAPIENTRY glNormalPointer(GLenum type, GLsizei stride, const GLvoid *ptr);
-
-// GLAPI void GLAPIENTRY glColorPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr);
-
 // GLAPI void GLAPIENTRY glIndexPointer(GLenum type, GLsizei stride, const GLvoid *ptr);
 
-// GLAPI void GLAPIENTRY glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr);
-
 // GLAPI void GLAPIENTRY glEdgeFlagPointer(GLsizei stride, const GLvoid *ptr);
 
 // GLAPI void GLAPIENTRY glGetPointerv(GLenum pname, void **params);
 
 // GLAPI void GLAPIENTRY glArrayElement(GLint i);
 
-// GLAPI void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count);
-
-// GLAPI void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices);
-
 // GLAPI void GLAPIENTRY glInterleavedArrays(GLenum format, GLsizei stride, const GLvoid *pointer);
 
 // /*
@@ -1074,8 +1633,6 @@ void shutdown_ogl() {
 
 // GLAPI void GLAPIENTRY glTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const GLvoid *pixels);
 
-// GLAPI void GLAPIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels);
-
 // GLAPI void GLAPIENTRY glCopyTexImage1D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border);
 
 // GLAPI void GLAPIENTRY glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border);
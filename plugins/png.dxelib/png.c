@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include "DOjS.h"
 #include "bitmap.h"
+#include "recorder.h"
 
 void init_png(js_State *J);
 
@@ -54,7 +55,7 @@ static void f_SavePngImage(js_State *J) {
  * @param J the JS context.
  */
 static void Bitmap_SavePngImage(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     const char *fname = js_tostring(J, 1);
 
     PALETTE pal;
@@ -65,6 +66,32 @@ static void Bitmap_SavePngImage(js_State *J) {
     }
 }
 
+/**
+ * @brief encode a frame for the recorder. There are no threads on DOS, so Allegro can be used here.
+ *
+ * @param fname the file to write.
+ * @param rgba RGBA pixel data.
+ * @param width width of the image.
+ * @param height height of the image.
+ * @return true if the image was written, else false
+ */
+static bool encode_png(const char *fname, const uint8_t *rgba, int width, int height) {
+    BITMAP *bm = create_bitmap_ex(32, width, height);
+    if (!bm) {
+        return false;
+    }
+    for (int y = 0; y < height; y++) {
+        uint32_t *dst = (uint32_t *)bm->line[y];
+        for (int x = 0; x < width; x++) {
+            *dst++ = makeacol32(rgba[0], rgba[1], rgba[2], rgba[3]);
+            rgba += 4;
+        }
+    }
+    bool ret = save_png(fname, bm, NULL) == 0;
+    destroy_bitmap(bm);
+    return ret;
+}
+
 /**
  * @brief initialize PNG loading/saving.
  *
@@ -75,6 +102,7 @@ void init_png(js_State *J) {
 
     /* Make Allegro aware of PNG file format. */
     alpng_init();
+    recorder_register("png", encode_png);
 
     NFUNCDEF(J, SavePngImage, 1);
 
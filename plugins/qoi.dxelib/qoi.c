@@ -28,7 +28,9 @@ SOFTWARE.
 #include <setjmp.h>
 
 #include "DOjS.h"
+#include "asyncload.h"
 #include "bitmap.h"
+#include "recorder.h"
 
 #define QOI_IMPLEMENTATION
 #include "qoi.h"
@@ -129,6 +131,39 @@ static void *load_from_datafile(PACKFILE *f, long size) {
     return load_qoi_pf(f, 0);
 }
 
+/**
+ * @brief decode QOI data for Bitmap.LoadAsync().
+ *
+ * @param data the file contents.
+ * @param size size of the file contents.
+ * @param img the decoded image is stored here.
+ * @return true if the image was decoded, else false
+ */
+static bool decode_qoi(const uint8_t *data, size_t size, asyncload_image_t *img) {
+    qoi_desc desc;
+    img->rgba = qoi_decode(data, size, &desc, NUM_CHANNELS);
+    if (!img->rgba) {
+        return false;
+    }
+    img->width = desc.width;
+    img->height = desc.height;
+    img->free_rgba = free;
+    return true;
+}
+
+/**
+ * @brief encode a frame for the recorder.
+ *
+ * @param fname the file to write.
+ * @param rgba RGBA pixel data.
+ * @param width width of the image.
+ * @param height height of the image.
+ * @return true if the image was written, else false
+ */
+static bool encode_qoi(const char *fname, const uint8_t *rgba, int width, int height) {
+    return qoi_write(fname, rgba, &(qoi_desc){.width = width, .height = height, .channels = NUM_CHANNELS, .colorspace = QOI_SRGB}) != 0;
+}
+
 /**
  * @brief load from file system
  *
@@ -217,7 +252,7 @@ static void f_SaveQoiImage(js_State *J) {
  * @param J the JS context.
  */
 static void Bitmap_SaveQoiImage(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     const char *fname = js_tostring(J, 1);
 
     if (!save_qoi(bm, fname)) {
@@ -243,6 +278,8 @@ void init_qoi(js_State *J) {
     register_bitmap_file_type("qoi", load_qoi, NULL, load_qoi_pf);
 #endif
     register_datafile_object(DAT_ID('Q', 'O', 'I', ' '), load_from_datafile, (void (*)(void *))destroy_bitmap);
+    asyncload_register("qoi", decode_qoi);
+    recorder_register("qoi", encode_qoi);
 
     NFUNCDEF(J, SaveQoiImage, 1);
 
@@ -19,9 +19,8 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 
-TODO: vorbis playback only works with mono downmixing.
-If I request 2 channels using stb_vorbis_get_samples_short_interleaved() the system crashes.
-I'll keep it that way for now.
+Playback is always stereo: the AUDIOSTREAM is allocated as stereo so its buffers hold
+two shorts per sample, mono files are duplicated to both channels by stb_vorbis.
 */
 
 #include <errno.h>
@@ -31,6 +30,10 @@ I'll keep it that way for now.
 #include <string.h>
 #include <time.h>
 
+#if LINUX == 1
+#include <pthread.h>
+#endif
+
 #include "DOjS.h"
 
 // #define STB_VORBIS_MAX_CHANNELS 2
@@ -45,32 +48,209 @@ void init_vorbis(js_State *J);
 ************/
 #define TAG_VORBIS "Ogg"  //!< pointer tag
 
+#define VORBIS_RING_BUFFERS 8        //!< the ring holds at least this many stream buffers of decoded audio
+#define VORBIS_DECODE_CHUNK 1024     //!< maximum number of samples decoded at once
+#define VORBIS_IDLE_NS 2000000       //!< time the decoder thread sleeps when the ring is full
+#define VORBIS_MAX_BUFFER (1 << 20)  //!< maximum stream buffer size in samples, keeps the ring size in range
+
+#define VORBIS_LOAD(v) __atomic_load_n(&(v), __ATOMIC_ACQUIRE)            //!< read a value shared between producer and consumer
+#define VORBIS_STORE(v, x) __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)  //!< publish a value shared between producer and consumer
+
 /************
 ** structs **
 ************/
+//! playback statistics
+typedef struct {
+    uint32_t underruns;  //!< number of stream buffers that could not be filled completely
+    uint32_t decoded;    //!< number of samples decoded into the ring
+    uint32_t played;     //!< number of samples passed to the AUDIOSTREAM since the last seek
+} vorbis_stats_t;
+
 //! file userdata definition
 typedef struct __vorbis {
     stb_vorbis *ogg;  //!< ogg pointer
     AUDIOSTREAM *stream;
     uint32_t buffer_size;
+    uint32_t num_samples;  //!< length of the file in samples, cached before any decoding starts
+    bool playing;          //!< Play() was called and Stop() was not
+
+    int16_t *ring;         //!< single producer/single consumer ring of interleaved stereo samples
+    uint32_t ring_size;    //!< number of stereo samples in the ring, a power of two
+    uint32_t write_pos;    //!< free running write position, only changed by the producer
+    uint32_t read_pos;     //!< free running read position, only changed by the consumer
+    uint32_t ended;        //!< the producer reached the end of the file
+    uint32_t seek_offset;  //!< sample index of the last seek
+    vorbis_stats_t stats;  //!< playback statistics
+    bool feeding;          //!< the timer callback feeds the AUDIOSTREAM
+
+#if LINUX == 1
+    pthread_t thread;  //!< the decoder thread
+    bool running;      //!< the decoder thread is running
+    uint32_t stop;     //!< the decoder thread shall stop
+#endif
 } vorbis_t;
 
 /*********************
 ** static functions **
 *********************/
 
+/**
+ * @brief decode as many samples as fit into the ring (producer).
+ *
+ * @param ov the vorbis_t to decode.
+ *
+ * @return true if samples were decoded, false if the ring is full or the file has ended.
+ */
+static bool VORBIS_decode(vorbis_t *ov) {
+    bool decoded = false;
+
+    while (!VORBIS_LOAD(ov->ended)) {
+        uint32_t wr = ov->write_pos;
+        uint32_t space = ov->ring_size - (wr - VORBIS_LOAD(ov->read_pos));
+        uint32_t idx = wr & (ov->ring_size - 1);
+        uint32_t len = MIN(MIN(space, ov->ring_size - idx), VORBIS_DECODE_CHUNK);
+        if (len == 0) {
+            break;
+        }
+
+        int num = stb_vorbis_get_samples_short_interleaved(ov->ogg, 2, &ov->ring[idx * 2], len * 2);
+        if (num <= 0) {
+            VORBIS_STORE(ov->ended, 1);
+            break;
+        }
+        VORBIS_STORE(ov->write_pos, wr + num);
+        __atomic_add_fetch(&ov->stats.decoded, num, __ATOMIC_RELAXED);
+        decoded = true;
+    }
+    return decoded;
+}
+
+/**
+ * @brief copy decoded samples into the AUDIOSTREAM if it needs data (consumer).
+ *
+ * @param param the vorbis_t to play.
+ */
+static void VORBIS_feed(void *param) {
+    vorbis_t *ov = (vorbis_t *)param;
+
+    while (true) {
+        uint16_t *buf = get_audio_stream_buffer(ov->stream);
+        if (!buf) {
+            break;
+        }
+
+        uint32_t rd = ov->read_pos;
+        uint32_t avail = MIN(VORBIS_LOAD(ov->write_pos) - rd, ov->buffer_size);
+        for (uint32_t i = 0; i < avail; i++) {
+            int16_t *src = &ov->ring[((rd + i) & (ov->ring_size - 1)) * 2];
+            buf[i * 2 + 0] = src[0] ^ 0x8000;
+            buf[i * 2 + 1] = src[1] ^ 0x8000;
+        }
+        for (uint32_t i = avail * 2; i < ov->buffer_size * 2; i++) {
+            buf[i] = 0x8000;
+        }
+        if (avail < ov->buffer_size && !VORBIS_LOAD(ov->ended)) {
+            __atomic_add_fetch(&ov->stats.underruns, 1, __ATOMIC_RELAXED);
+        }
+        VORBIS_STORE(ov->read_pos, rd + avail);
+        __atomic_add_fetch(&ov->stats.played, avail, __ATOMIC_RELAXED);
+
+        free_audio_stream_buffer(ov->stream);
+    }
+}
+
+#if LINUX == 1
+/**
+ * @brief decoder thread, keeps the ring filled.
+ *
+ * @param arg the vorbis_t to decode.
+ *
+ * @return always NULL
+ */
+static void *VORBIS_worker(void *arg) {
+    vorbis_t *ov = (vorbis_t *)arg;
+    struct timespec idle = {0, VORBIS_IDLE_NS};
+
+    while (!VORBIS_LOAD(ov->stop)) {
+        if (!VORBIS_decode(ov)) {
+            nanosleep(&idle, NULL);
+        }
+    }
+    return NULL;
+}
+#endif
+
+/**
+ * @brief start background decoding and feeding (Linux). The AUDIOSTREAM is fed from an Allegro timer, the decoder runs in its own thread.
+ *
+ * @param ov the vorbis_t to play.
+ */
+static void VORBIS_start(vorbis_t *ov) {
+#if LINUX == 1
+    VORBIS_STORE(ov->stop, 0);
+    ov->running = pthread_create(&ov->thread, NULL, VORBIS_worker, ov) == 0;
+    if (!ov->running) {
+        LOG("Ogg: could not start decoder thread, decoding in Play()\n");
+        return;
+    }
+
+    // feed the stream four times per buffer
+    int ms = MAX(1, (int)(ov->buffer_size * 1000 / ov->stream->samp->freq / 4));
+    ov->feeding = install_param_int(VORBIS_feed, ov, ms) == 0;
+    if (!ov->feeding) {
+        LOG("Ogg: could not install feeder timer, feeding in Play()\n");
+    }
+#endif
+}
+
+/**
+ * @brief stop background decoding and feeding, the decoder may be used by the caller afterwards.
+ *
+ * @param ov the vorbis_t to stop.
+ */
+static void VORBIS_stop(vorbis_t *ov) {
+    if (ov->feeding) {
+        remove_param_int(VORBIS_feed, ov);
+        ov->feeding = false;
+    }
+#if LINUX == 1
+    if (ov->running) {
+        VORBIS_STORE(ov->stop, 1);
+        pthread_join(ov->thread, NULL);
+        ov->running = false;
+    }
+#endif
+}
+
+/**
+ * @brief drop all decoded samples, producer and consumer must be stopped.
+ *
+ * @param ov the vorbis_t to reset.
+ */
+static void VORBIS_reset(vorbis_t *ov) {
+    ov->read_pos = ov->write_pos = 0;
+    ov->ended = 0;
+    ov->stats.played = 0;
+    ov->seek_offset = stb_vorbis_get_sample_offset(ov->ogg);
+}
+
 /**
  * @brief free ressources.
  *
  * @param ov the vorbis_t with the ressources to free.
  */
 static void VORBIS_cleanup(vorbis_t *ov) {
-    if (ov->ogg) {
+    VORBIS_stop(ov);
+    if (ov->stream) {
         stop_audio_stream(ov->stream);
         ov->stream = NULL;
+    }
+    if (ov->ogg) {
         stb_vorbis_close(ov->ogg);
         ov->ogg = NULL;
     }
+    free(ov->ring);
+    ov->ring = NULL;
 }
 
 /**
@@ -109,24 +289,45 @@ static void new_Ogg(js_State *J) {
         return;
     }
 
+    // query the length before the decoder is shared with the worker, stb_vorbis seeks around the file to find it
+    ov->num_samples = stb_vorbis_stream_length_in_samples(ov->ogg);
+    float duration = stb_vorbis_stream_length_in_seconds(ov->ogg);
+
     if (js_isnumber(J, 2)) {
         ov->buffer_size = js_touint32(J, 2);
     } else {
         ov->buffer_size = 1024 * 16;
     }
+    if (ov->buffer_size == 0 || ov->buffer_size > VORBIS_MAX_BUFFER) {
+        VORBIS_Finalize(J, ov);
+        js_error(J, "Buffer size must be > 0 and <= %d", VORBIS_MAX_BUFFER);
+        return;
+    }
+
+    // allocate the ring, a power of two so the positions can wrap around freely
+    ov->ring_size = 1;
+    while (ov->ring_size < ov->buffer_size * VORBIS_RING_BUFFERS) {
+        ov->ring_size <<= 1;
+    }
+    ov->ring = malloc(ov->ring_size * 2 * sizeof(int16_t));
+    if (!ov->ring) {
+        VORBIS_Finalize(J, ov);
+        JS_ENOMEM(J);
+        return;
+    }
 
     // get metadata
     stb_vorbis_info info = stb_vorbis_get_info(ov->ogg);
     stb_vorbis_comment comment = stb_vorbis_get_comment(ov->ogg);
 
-    // allocate stream
-    ov->stream = play_audio_stream(ov->buffer_size, 16, false, info.sample_rate, 255, 128);
+    // allocate stream, it stays silent until the first Play()
+    ov->stream = play_audio_stream(ov->buffer_size, 16, true, info.sample_rate, 255, 128);
     if (!ov->stream) {
-        stb_vorbis_close(ov->ogg);
-        free(ov);
+        VORBIS_Finalize(J, ov);
         JS_ENOMEM(J);
         return;
     }
+    voice_stop(ov->stream->voice);
 
     js_currentfunction(J);
     js_getproperty(J, -1, "prototype");
@@ -139,10 +340,10 @@ static void new_Ogg(js_State *J) {
     js_pushnumber(J, info.channels);
     js_defproperty(J, -2, "channels", JS_READONLY | JS_DONTCONF);
 
-    js_pushnumber(J, stb_vorbis_stream_length_in_samples(ov->ogg));
+    js_pushnumber(J, ov->num_samples);
     js_defproperty(J, -2, "numsamples", JS_READONLY | JS_DONTCONF);
 
-    js_pushnumber(J, stb_vorbis_stream_length_in_seconds(ov->ogg));
+    js_pushnumber(J, duration);
     js_defproperty(J, -2, "duration", JS_READONLY | JS_DONTCONF);
 
     js_pushnumber(J, info.sample_rate);
@@ -177,7 +378,7 @@ static void VORBIS_Close(js_State *J) {
 }
 
 /**
- * @brief get current play time
+ * @brief get current play time, this is the last sample passed to the AUDIOSTREAM, the decoder may be ahead of it.
  *
  * @param J VM state.
  */
@@ -188,7 +389,7 @@ static void VORBIS_CurrentSample(js_State *J) {
         return;
     }
 
-    js_pushnumber(J, stb_vorbis_get_sample_offset(ov->ogg));
+    js_pushnumber(J, ov->seek_offset + VORBIS_LOAD(ov->stats.played));
 }
 
 /**
@@ -203,11 +404,18 @@ static void VORBIS_Rewind(js_State *J) {
         return;
     }
 
+    VORBIS_stop(ov);
     stb_vorbis_seek_start(ov->ogg);
+    VORBIS_reset(ov);
+    if (ov->playing) {
+        VORBIS_start(ov);
+    }
 }
 
 /**
- * @brief play stream
+ * @brief play stream.
+ * The first call starts (or resumes) playback and the decoder thread and feeder timer (Linux). Without them the ring is filled and passed to the
+ * AUDIOSTREAM here.
  *
  * @param J VM state.
  */
@@ -218,22 +426,39 @@ static void VORBIS_Play(js_State *J) {
         return;
     }
 
-    while (true) {
-        short *mem_chunk = get_audio_stream_buffer(ov->stream);
-        if (mem_chunk != NULL) {
-            int num_decoded = stb_vorbis_get_samples_short(ov->ogg, 1, &mem_chunk, ov->buffer_size);
-            for (int i = 0; i < ov->buffer_size; i++) {
-                if (i < num_decoded) {
-                    mem_chunk[i] = mem_chunk[i] ^ 0x8000;
-                } else {
-                    mem_chunk[i] = 0x00;
-                }
-            }
-            free_audio_stream_buffer(ov->stream);
-        } else {
-            break;
-        }
+    if (!ov->playing) {
+        ov->playing = true;
+        voice_start(ov->stream->voice);
+        VORBIS_start(ov);
+    }
+
+#if LINUX == 1
+    if (!ov->running) {
+        VORBIS_decode(ov);
+    }
+#else
+    VORBIS_decode(ov);
+#endif
+    if (!ov->feeding) {
+        VORBIS_feed(ov);
+    }
+}
+
+/**
+ * @brief stop (pause) playback, the next Play() continues at the current position.
+ *
+ * @param J VM state.
+ */
+static void VORBIS_Stop(js_State *J) {
+    vorbis_t *ov = js_touserdata(J, 0, TAG_VORBIS);
+    if (!ov->ogg) {
+        js_error(J, "OGG is closed");
+        return;
     }
+
+    VORBIS_stop(ov);
+    voice_stop(ov->stream->voice);
+    ov->playing = false;
 }
 
 /**
@@ -250,13 +475,42 @@ static void VORBIS_Seek(js_State *J) {
 
     int32_t idx = js_toint32(J, 1);
 
-    if (idx >= 0 && idx < stb_vorbis_stream_length_in_samples(ov->ogg)) {
+    if (idx >= 0 && idx < ov->num_samples) {
+        VORBIS_stop(ov);
         stb_vorbis_seek(ov->ogg, idx);
+        VORBIS_reset(ov);
+        if (ov->playing) {
+            VORBIS_start(ov);
+        }
     } else {
         js_error(J, "Index out of range: %ld", idx);
     }
 }
 
+/**
+ * @brief get playback statistics.
+ * ov.GetStats():{underruns:number, decoded:number, played:number, buffered:number, threaded:boolean}
+ *
+ * @param J VM state.
+ */
+static void VORBIS_GetStats(js_State *J) {
+    vorbis_t *ov = js_touserdata(J, 0, TAG_VORBIS);
+
+    js_newobject(J);
+    {
+        js_pushnumber(J, VORBIS_LOAD(ov->stats.underruns));
+        js_setproperty(J, -2, "underruns");
+        js_pushnumber(J, VORBIS_LOAD(ov->stats.decoded));
+        js_setproperty(J, -2, "decoded");
+        js_pushnumber(J, VORBIS_LOAD(ov->stats.played));
+        js_setproperty(J, -2, "played");
+        js_pushnumber(J, VORBIS_LOAD(ov->write_pos) - VORBIS_LOAD(ov->read_pos));
+        js_setproperty(J, -2, "buffered");
+        js_pushboolean(J, ov->feeding);
+        js_setproperty(J, -2, "threaded");
+    }
+}
+
 /*********************
 ** public functions **
 *********************/
@@ -274,7 +528,9 @@ void init_vorbis(js_State *J) {
         NPROTDEF(J, VORBIS, CurrentSample, 0);
         NPROTDEF(J, VORBIS, Rewind, 0);
         NPROTDEF(J, VORBIS, Play, 0);
+        NPROTDEF(J, VORBIS, Stop, 0);
         NPROTDEF(J, VORBIS, Seek, 1);
+        NPROTDEF(J, VORBIS, GetStats, 0);
     }
     CTORDEF(J, new_Ogg, TAG_VORBIS, 2);
 }
@@ -21,6 +21,7 @@ SOFTWARE.
 */
 
 #include "DOjS.h"
+#include "asyncload.h"
 #include "bitmap.h"
 #include "webp.h"
 
@@ -124,6 +125,21 @@ static void *load_from_datafile(PACKFILE *f, long size) {
     return load_webp_pf(f, 0);
 }
 
+/**
+ * @brief decode WEBP data for Bitmap.LoadAsync().
+ *
+ * @param data the file contents.
+ * @param size size of the file contents.
+ * @param img the decoded image is stored here.
+ *
+ * @return true if the image was decoded, else false
+ */
+static bool decode_webp(const uint8_t *data, size_t size, asyncload_image_t *img) {
+    img->rgba = WebPDecodeRGBA(data, size, &img->width, &img->height);
+    img->free_rgba = WebPFree;
+    return img->rgba != NULL;
+}
+
 /**
  * @brief load from file system
  *
@@ -230,7 +246,7 @@ static void f_SaveWebpImage(js_State *J) {
  * @param J the JS context.
  */
 static void Bitmap_SaveWebpImage(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     const char *fname = js_tostring(J, 1);
 
     if (!save_webp(bm, fname)) {
@@ -262,6 +278,9 @@ void init_webp(js_State *J) {
     register_datafile_object(DAT_ID('W', 'E', 'P', ' '), load_from_datafile, (void (*)(void *))destroy_bitmap);
     register_datafile_object(DAT_ID('W', 'E', 'B', ' '), load_from_datafile, (void (*)(void *))destroy_bitmap);
     register_datafile_object(DAT_ID('W', 'E', 'B', 'P'), load_from_datafile, (void (*)(void *))destroy_bitmap);
+    asyncload_register("webp", decode_webp);
+    asyncload_register("web", decode_webp);
+    asyncload_register("wep", decode_webp);
 
     NFUNCDEF(J, SaveWebpImage, 1);
 
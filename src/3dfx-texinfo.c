@@ -114,7 +114,7 @@ static void new_Texinfo(js_State *J) {
 
     const char *fname = "<<bitmap>>";
     if (js_isuserdata(J, 1, TAG_BITMAP)) {
-        BITMAP *bm = js_touserdata(J, 1, TAG_BITMAP);
+        BITMAP *bm = Bitmap_get(J, 1);
 
         // check source bitmap for sanity
         char *err = NULL;
@@ -25,6 +25,7 @@ SOFTWARE.
 #if LINUX == 1
 #include "linux/conio.h"
 #include "linux/glue.h"
+#include "loadpng.h"
 #else
 #include <conio.h>
 #include <glide.h>
@@ -35,6 +36,7 @@ SOFTWARE.
 #include "lowlevel.h"
 #endif
 
+#include <errno.h>
 #include <jsi.h>
 #include <signal.h>
 #include <stdlib.h>
@@ -42,6 +44,8 @@ SOFTWARE.
 #include <strings.h>
 #include <dlfcn.h>
 
+#include "asyncload.h"
+#include "atlas.h"
 #include "bitmap.h"
 #include "color.h"
 #include "edit.h"
@@ -50,10 +54,18 @@ SOFTWARE.
 #include "flic.h"
 #include "funcs.h"
 #include "gfx.h"
+#include "imgcache.h"
 #include "joystick.h"
 #include "midiplay.h"
 #include "socket.h"
 #include "sound.h"
+#include "textcache.h"
+#include "profiler.h"
+#include "recorder.h"
+#include "timing.h"
+#include "pixels.h"
+#include "pvector.h"
+#include "transform.h"
 #include "util.h"
 #include "watt.h"
 #include "zip.h"
@@ -102,6 +114,8 @@ static void usage() {
     fputs("    -j <file>      : Redirect JSLOG.TXT to <file>.\n", stderr);
 #if LINUX == 1
     fputs("    -u             : Use fullscreen instead of window.\n", stderr);
+    fputs("    -H <frames>    : Headless: render <frames> frames into memory as fast as possible.\n", stderr);
+    fputs("    -D <f1,f2,...> : Save the given frames as FRAME<n>.PNG in headless mode.\n", stderr);
 #endif
     fputs("\n", stderr);
     fputs("This is DOjS " DOSJS_VERSION_STR "\n", stderr);
@@ -200,6 +214,9 @@ static bool callInput(js_State *J) {
     if (keypressed()) {
         key = readkey();
         ret = ((key >> 8) == DOjS.exit_key);
+        if ((key >> 8) == PROFILER_OVERLAY_KEY) {
+            profiler_toggle_overlay();
+        }
     } else {
         key = -1;
         ret = false;
@@ -250,6 +267,55 @@ static bool callInput(js_State *J) {
     return ret;
 }
 
+#if LINUX == 1
+/**
+ * @brief check if a frame shall be saved in headless mode.
+ *
+ * @param frame the frame number.
+ *
+ * @return true if the frame is in the list given with '-D'.
+ */
+static bool headless_dump_wanted(int frame) {
+    const char *p = DOjS.params.dump;
+    while (p && *p) {
+        char *end;
+        long n = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        if (n == frame) {
+            return true;
+        }
+        if (*end != ',') {
+            break;
+        }
+        p = end + 1;
+    }
+    return false;
+}
+
+/**
+ * @brief finish a headless frame: save it if requested and stop the script after the wanted number of frames.
+ *
+ * @param frame the frame number, starting with 0.
+ */
+static void headless_frame(int frame) {
+    if (headless_dump_wanted(frame)) {
+        char fname[32];
+        PALETTE pal;
+
+        snprintf(fname, sizeof(fname), "FRAME%05d.PNG", frame);
+        get_palette(pal);
+        if (save_png(fname, DOjS.render_bm, (const struct RGB *)&pal) != 0) {
+            LOGF("Could not save frame %d to %s\n", frame, fname);
+        }
+    }
+    if (frame + 1 >= DOjS.params.headless) {
+        DOjS.keep_running = false;
+    }
+}
+#endif
+
 /**
  * @brief load and parse a javascript file from ZIP.
  *
@@ -437,6 +503,12 @@ static bool check_functions(js_State *J, const char *fname) {
         DOjS.onexit_available = false;
     }
 
+    if (js_hasproperty(J, 0, CB_UPDATE)) {
+        DOjS.update_available = true;
+    } else {
+        DOjS.update_available = false;
+    }
+
     if (!js_hasproperty(J, 0, CB_LOOP)) {
         set_last_error("Script has no " CB_LOOP "() function");
         LOG("Script has no " CB_LOOP "() function\n");
@@ -503,20 +575,26 @@ static void run_script(int argc, char **argv, int args) {
 #endif
 
     // detect hardware and initialize subsystems
-    allegro_init();
-    install_timer();
-    LOCK_VARIABLE(DOjS.sys_ticks);
-    LOCK_FUNCTION(tick_handler);
-    install_int(tick_handler, TICK_DELAY);
-    install_keyboard();
-    if (install_mouse() >= 0) {
-        LOGF("Mouse detected: %s\n", mouse_driver->name);
-        enable_hardware_cursor();
-        select_mouse_cursor(MOUSE_CURSOR_ARROW);
-        DOjS.mouse_available = true;
-        DOjS.mouse_visible = true;
+    if (DOjS.params.headless) {
+        // no display, timer or input devices. sys_ticks follows the virtual clock
+        install_allegro(SYSTEM_NONE, &errno, atexit);
+        LOGF("Headless mode, rendering %d frames\n", DOjS.params.headless);
     } else {
-        LOGF("NO Mouse detected: %s\n", allegro_error);
+        allegro_init();
+        install_timer();
+        LOCK_VARIABLE(DOjS.sys_ticks);
+        LOCK_FUNCTION(tick_handler);
+        install_int(tick_handler, TICK_DELAY);
+        install_keyboard();
+        if (install_mouse() >= 0) {
+            LOGF("Mouse detected: %s\n", mouse_driver->name);
+            enable_hardware_cursor();
+            select_mouse_cursor(MOUSE_CURSOR_ARROW);
+            DOjS.mouse_available = true;
+            DOjS.mouse_visible = true;
+        } else {
+            LOGF("NO Mouse detected: %s\n", allegro_error);
+        }
     }
     PROPDEF_B(J, DOjS.mouse_available, "MOUSE_AVAILABLE");
     init_sound(J);  // sound init must be before midi init!
@@ -525,6 +603,16 @@ static void run_script(int argc, char **argv, int args) {
     init_gfx(J);
     init_color(J);
     init_bitmap(J);
+    init_atlas(J);
+    init_imgcache(J);
+    init_asyncload(J);
+    init_textcache(J);
+    init_transform(J);
+    init_pvector(J);
+    init_pixels(J);
+    init_timing(J);
+    init_profiler(J);
+    init_recorder(J);
     init_font(J);
     init_file(J);
     init_joystick(J);
@@ -555,35 +643,45 @@ static void run_script(int argc, char **argv, int args) {
 #else
     int gfx_mode = GFX_AUTODETECT;
 #endif
-    while (true) {
+    if (DOjS.params.headless) {
+        // render into a memory bitmap only
         set_color_depth(DOjS.params.bpp);
-        if (DOjS.params.width == DOJS_FULL_WIDTH) {
-            if (set_gfx_mode(gfx_mode, DOJS_FULL_WIDTH, DOJS_FULL_HEIGHT, 0, 0) != 0) {
-                LOGF("Couldn't set a %d bit color resolution at 640x480: %s\n", DOjS.params.bpp, allegro_error);
+    } else {
+        while (true) {
+            set_color_depth(DOjS.params.bpp);
+            if (DOjS.params.width == DOJS_FULL_WIDTH) {
+                if (set_gfx_mode(gfx_mode, DOJS_FULL_WIDTH, DOJS_FULL_HEIGHT, 0, 0) != 0) {
+                    LOGF("Couldn't set a %d bit color resolution at 640x480: %s\n", DOjS.params.bpp, allegro_error);
+                } else {
+                    break;
+                }
             } else {
-                break;
+                if (set_gfx_mode(gfx_mode, DOJS_HALF_WIDTH, DOJS_HALF_HEIGHT, 0, 0) != 0) {
+                    LOGF("Couldn't set a %d bit color resolution at 320x240: %s\n", DOjS.params.bpp, allegro_error);
+                } else {
+                    break;
+                }
             }
-        } else {
-            if (set_gfx_mode(gfx_mode, DOJS_HALF_WIDTH, DOJS_HALF_HEIGHT, 0, 0) != 0) {
-                LOGF("Couldn't set a %d bit color resolution at 320x240: %s\n", DOjS.params.bpp, allegro_error);
+            if (DOjS.params.bpp == 32) {
+                DOjS.params.bpp = 24;
+                LOG("32 bit color resolution not available, trying 24 bit fallback...\n");
             } else {
+                screenSuccess = false;
                 break;
             }
         }
-        if (DOjS.params.bpp == 32) {
-            DOjS.params.bpp = 24;
-            LOG("32 bit color resolution not available, trying 24 bit fallback...\n");
-        } else {
-            screenSuccess = false;
-            break;
-        }
     }
     if (DOjS.params.bpp < 24) {
         DOjS.params.no_alpha = true;
         LOG("BPP < 24, disabling alpha\n");
     }
     if (screenSuccess) {
-        DOjS.render_bm = DOjS.current_bm = create_bitmap(SCREEN_W, SCREEN_H);
+        if (DOjS.params.headless) {
+            DOjS.render_bm = create_bitmap(DOjS.params.width, DOjS.params.width == DOJS_FULL_WIDTH ? DOJS_FULL_HEIGHT : DOJS_HALF_HEIGHT);
+        } else {
+            DOjS.render_bm = create_bitmap(SCREEN_W, SCREEN_H);
+        }
+        DOjS.current_bm = DOjS.render_bm;
         clear_bitmap(DOjS.render_bm);
         DOjS.transparency_available = DOjS.params.no_alpha ? BLEND_REPLACE : BLEND_ALPHA;
         dojs_update_transparency();
@@ -606,8 +704,11 @@ static void run_script(int argc, char **argv, int args) {
 #endif
                 if (callGlobal(J, CB_SETUP)) {
                     // call loop() until someone calls Stop()
+                    int frame = 0;
+                    uint64_t start = timing_now();
+                    timing_start();
+                    profiler_start();
                     while (DOjS.keep_running) {
-                        long start = DOjS.sys_ticks;
                         if (DOjS.num_allocs > 1000) {
 #ifdef MEMDEBUG
                             js_gc(J, 1);
@@ -616,39 +717,59 @@ static void run_script(int argc, char **argv, int args) {
 #endif
                             DOjS.num_allocs = 0;
                         }
+                        profiler_mark(PROFILE_GC);
                         tick_socket();
+                        profiler_mark(PROFILE_SOCKET);
+                        if (DOjS.update_available) {
+                            bool update_ok = true;
+                            for (int steps = timing_update_steps(); steps > 0 && update_ok; steps--) {
+                                update_ok = callGlobal(J, CB_UPDATE);
+                            }
+                            if (!update_ok) {
+                                break;
+                            }
+                        }
+                        profiler_mark(PROFILE_UPDATE);
                         if (!callGlobal(J, CB_LOOP)) {
                             if (!DOjS.lastError) {
                                 set_last_error("Loop() not found.");
                             }
                             break;
                         }
-                        if (callInput(J)) {
+                        profiler_mark(PROFILE_LOOP);
+                        if (!DOjS.params.headless && callInput(J)) {
                             DOjS.keep_running = false;
                         }
+                        profiler_mark(PROFILE_INPUT);
 #if LINUX != 1
                         if (DOjS.glide_enabled) {
                             grBufferSwap(1);
                         } else {
+#else
+                        if (DOjS.params.headless) {
+                            headless_frame(frame);
+                        } else {
 #endif
                             show_mouse(NULL);
                             blit(DOjS.render_bm, screen, 0, 0, 0, 0, SCREEN_W, SCREEN_H);
+                            if (profiler_overlay_enabled()) {
+                                profiler_draw_overlay(screen);
+                            }
                             if (DOjS.mouse_visible) {
                                 show_mouse(screen);
                             }
-#if LINUX != 1
                         }
-#endif
-                        long end = DOjS.sys_ticks;
-                        long runtime = (end - start) + 1;
-                        DOjS.current_frame_rate = 1000 / runtime;
-                        if (DOjS.current_frame_rate > DOjS.wanted_frame_rate) {
-                            unsigned int delay = (1000 / DOjS.wanted_frame_rate) - runtime;
-                            rest(delay);
-                        }
-                        end = DOjS.sys_ticks;
-                        runtime = (end - start) + 1;
-                        DOjS.current_frame_rate = 1000 / runtime;
+                        recorder_capture(DOjS.render_bm);
+                        profiler_mark(PROFILE_BLIT);
+                        timing_end_frame();
+                        profiler_mark(PROFILE_SLEEP);
+                        profiler_end_frame();
+                        frame++;
+                    }
+                    if (DOjS.params.headless) {
+                        double secs = (double)(timing_now() - start) / TIMING_NS_PER_SEC;
+                        LOGF("Headless: %d frames in %.3fs (%.2f fps)\n", frame, secs, secs > 0 ? frame / secs : 0);
+                        fprintf(stdout, "Headless: %d frames in %.3fs (%.2f fps)\n", frame, secs, secs > 0 ? frame / secs : 0);
                     }
                     if (DOjS.onexit_available) {
                         callGlobal(J, CB_ONEXIT);
@@ -674,6 +795,8 @@ static void run_script(int argc, char **argv, int args) {
 #else
     glue_shutdown();
 #endif
+    shutdown_recorder();
+    shutdown_transform();
     shutdown_flic();
     shutdown_midi();
     shutdown_sound();
@@ -978,7 +1101,7 @@ int main(int argc, char **argv) {
     // check command line parameters
     int opt;
 #if LINUX == 1
-    while ((opt = getopt(argc, argv, "utnxlrsfahw:b:j:")) != -1) {
+    while ((opt = getopt(argc, argv, "utnxlrsfahw:b:j:H:D:")) != -1) {
 #else
     while ((opt = getopt(argc, argv, "tnxlrsfahw:b:j:")) != -1) {
 #endif
@@ -1020,6 +1143,12 @@ int main(int argc, char **argv) {
             case 'u':
                 DOjS.fullscreen = true;
                 break;
+            case 'H':
+                DOjS.params.headless = atoi(optarg);
+                break;
+            case 'D':
+                DOjS.params.dump = optarg;
+                break;
 #endif
             case 'h':
             default: /* '?' */
@@ -1116,6 +1245,18 @@ int main(int argc, char **argv) {
         exit(EXIT_FAILURE);
     }
 
+    // headless mode runs the script directly without sound
+    if (DOjS.params.headless < 0) {
+        fprintf(stderr, "Number of headless frames must be positive, not %d.\n\n", DOjS.params.headless);
+        usage();
+        exit(EXIT_FAILURE);
+    }
+    if (DOjS.params.headless) {
+        DOjS.params.run = true;
+        DOjS.params.no_sound = true;
+        DOjS.params.no_fm = true;
+    }
+
     // check screen size parameters
     if (DOjS.params.width != DOJS_FULL_WIDTH && DOjS.params.width != DOJS_HALF_WIDTH) {
         fprintf(stderr, "Screen width must be 640 or 320 pixel, not %d.\n\n", DOjS.params.width);
@@ -1153,6 +1294,8 @@ int main(int argc, char **argv) {
     }
 
     clear_last_error();
+    imgcache_clear();
+    textcache_clear();
     if (DOjS.exitMessage) {
         free(DOjS.exitMessage);
         DOjS.exitMessage = NULL;
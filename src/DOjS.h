@@ -35,6 +35,7 @@ SOFTWARE.
 #define CB_LOOP "Loop"      //!< name of loop function (required)
 #define CB_INPUT "Input"    //!< name of input function (optional)
 #define CB_ONEXIT "OnExit"  //!< name of onExit function (optional)
+#define CB_UPDATE "Update"  //!< name of the fixed timestep update function (optional, see SetUpdateRate())
 
 #define SYSINFO ">>> "  //!< logfile line prefix for system messages
 
@@ -231,6 +232,8 @@ typedef struct {
     bool no_tcpip;       //!< disable Watt32 TCP stack
     int width;           //!< requested screen with
     int bpp;             //!< requested bit depth
+    int headless;        //!< number of frames to render without display and input (Linux), 0 for normal operation
+    const char *dump;    //!< comma separated list of frame numbers to save as PNG in headless mode
 } cmd_params_t;
 
 typedef struct {
@@ -266,6 +269,7 @@ typedef struct {
     int last_mouse_b;       //!< last reported mouse button
     bool input_available;   //!< indicates if the input callback function is available
     bool onexit_available;  //!< indicates if the onexit callback function is available
+    bool update_available;  //!< indicates if the update callback function is available
     char *exitMessage;      //!< a message to print to the console when DOjS shuts down
     const char *jsboot;     //!< path/name of jsboot-file.
 } dojs_t;
@@ -0,0 +1,461 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "asyncload.h"
+
+#include <allegro.h>
+#include <mujs.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if LINUX == 1
+#include <pthread.h>
+#endif
+
+#include "DOjS.h"
+#include "bitmap.h"
+#include "imgcache.h"
+#include "util.h"
+#include "zipfile.h"
+
+/************
+** defines **
+************/
+#define ASYNCLOAD_MAX_DECODERS 16          //!< max number of registered decoders
+#define ASYNCLOAD_EXT_LEN 8                //!< max length of a file extension
+#define ASYNCLOAD_PROPERTY "___bitmap___"  //!< hidden property holding the finished Bitmap
+
+/************
+** structs **
+************/
+//! state of a load job
+typedef enum {
+    ASYNC_QUEUED,   //!< waiting for (or being processed by) the worker
+    ASYNC_DECODED,  //!< decoded, conversion to BITMAP pending
+    ASYNC_FAILED,   //!< loading or decoding failed
+    ASYNC_DONE      //!< the Bitmap was created
+} asyncload_state_t;
+
+//! a load job, owned by the JS handle
+typedef struct asyncload_job {
+    struct asyncload_job *next;   //!< next job in the worker queue
+    char *fname;                  //!< file name of the image
+    asyncload_decoder_t decoder;  //!< decoder for the image or NULL to load with Allegro on the main thread
+    asyncload_image_t img;        //!< the decoded image
+    asyncload_state_t state;      //!< current state of the job
+    bool orphaned;                //!< the handle was garbage collected while the worker still used the job
+} asyncload_job_t;
+
+//! a registered decoder
+typedef struct {
+    char ext[ASYNCLOAD_EXT_LEN];  //!< file extension (lowercase)
+    asyncload_decoder_t decoder;  //!< the decoder function
+} asyncload_decoder_entry_t;
+
+/*********************
+** static variables **
+*********************/
+static asyncload_decoder_entry_t al_decoders[ASYNCLOAD_MAX_DECODERS];  //!< registered decoders
+static int al_num_decoders = 0;                                        //!< number of registered decoders
+
+#if LINUX == 1
+static pthread_mutex_t al_mutex = PTHREAD_MUTEX_INITIALIZER;  //!< protects the queue and the job states
+static pthread_cond_t al_work = PTHREAD_COND_INITIALIZER;     //!< signalled when a job was queued
+static pthread_cond_t al_done = PTHREAD_COND_INITIALIZER;     //!< signalled when a job was decoded
+static asyncload_job_t *al_head = NULL;                       //!< first job in the queue
+static asyncload_job_t *al_tail = NULL;                       //!< last job in the queue
+static bool al_worker_running = false;                        //!< the worker thread was started
+#endif
+
+/************************
+** function prototypes **
+************************/
+static asyncload_decoder_t asyncload_find(const char *fname);
+static void asyncload_free(asyncload_job_t *job);
+static bool asyncload_decode(asyncload_job_t *job);
+static void AsyncBitmap_Finalize(js_State *J, void *data);
+static void AsyncBitmap_Poll(js_State *J);
+static void AsyncBitmap_Wait(js_State *J);
+static void Bitmap_LoadAsync(js_State *J);
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief find the decoder for a file.
+ *
+ * @param fname the file name.
+ *
+ * @return the decoder or NULL if the file type can only be loaded by Allegro.
+ */
+static asyncload_decoder_t asyncload_find(const char *fname) {
+    const char *ext = ut_getFilenameExt(fname);
+    for (int i = 0; i < al_num_decoders; i++) {
+        if (stricmp(al_decoders[i].ext, ext) == 0) {
+            return al_decoders[i].decoder;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief free a job and its image data.
+ *
+ * @param job the job.
+ */
+static void asyncload_free(asyncload_job_t *job) {
+    if (job->img.rgba) {
+        job->img.free_rgba(job->img.rgba);
+    }
+    free(job->fname);
+    free(job);
+}
+
+/**
+ * @brief read and decode the image of a job. Does not use Allegro or the JS engine, so it may run on the worker thread.
+ *
+ * @param job the job, the decoded image is stored in job->img.
+ *
+ * @return true if the image was decoded, else false.
+ */
+static bool asyncload_decode(asyncload_job_t *job) {
+    void *data;
+    size_t size;
+    bool ok;
+
+    if (strchr(job->fname, ZIP_DELIM)) {
+        ok = read_zipfile1(job->fname, &data, &size);
+    } else {
+        ok = ut_read_file(job->fname, &data, &size);
+    }
+
+    if (ok) {
+        ok = job->decoder(data, size, &job->img);
+        free(data);
+    }
+    return ok;
+}
+
+#if LINUX == 1
+/**
+ * @brief worker thread, decodes queued jobs one after the other.
+ *
+ * @param arg unused.
+ *
+ * @return never returns.
+ */
+static void *asyncload_worker(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&al_mutex);
+    while (true) {
+        while (!al_head) {
+            pthread_cond_wait(&al_work, &al_mutex);
+        }
+        asyncload_job_t *job = al_head;
+        al_head = job->next;
+        if (!al_head) {
+            al_tail = NULL;
+        }
+
+        if (job->orphaned) {
+            asyncload_free(job);
+            continue;
+        }
+        pthread_mutex_unlock(&al_mutex);
+
+        bool ok = asyncload_decode(job);
+
+        pthread_mutex_lock(&al_mutex);
+        if (job->orphaned) {
+            asyncload_free(job);
+        } else {
+            job->state = ok ? ASYNC_DECODED : ASYNC_FAILED;
+            pthread_cond_broadcast(&al_done);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief hand a job to the worker thread, starting it if necessary.
+ *
+ * @param job the job.
+ *
+ * @return true if the job was queued, false if the worker could not be started.
+ */
+static bool asyncload_enqueue(asyncload_job_t *job) {
+    pthread_mutex_lock(&al_mutex);
+    if (!al_worker_running) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, asyncload_worker, NULL) != 0) {
+            pthread_mutex_unlock(&al_mutex);
+            return false;
+        }
+        pthread_detach(thread);
+        al_worker_running = true;
+    }
+
+    job->next = NULL;
+    if (al_tail) {
+        al_tail->next = job;
+    } else {
+        al_head = job;
+    }
+    al_tail = job;
+    pthread_cond_signal(&al_work);
+    pthread_mutex_unlock(&al_mutex);
+    return true;
+}
+#endif
+
+/**
+ * @brief finalize a handle and free resources.
+ *
+ * @param J VM state.
+ * @param data the job.
+ */
+static void AsyncBitmap_Finalize(js_State *J, void *data) {
+    asyncload_job_t *job = (asyncload_job_t *)data;
+
+#if LINUX == 1
+    pthread_mutex_lock(&al_mutex);
+    if (job->decoder && job->state == ASYNC_QUEUED) {
+        job->orphaned = true;  // the worker frees the job when done
+        job = NULL;
+    }
+    pthread_mutex_unlock(&al_mutex);
+#endif
+
+    if (job) {
+        asyncload_free(job);
+    }
+}
+
+/**
+ * @brief create the Bitmap for a job once decoding is finished.
+ * The Bitmap is stored in the handle and pushed onto the stack.
+ *
+ * @param J VM state.
+ * @param job the job.
+ */
+static void AsyncBitmap_finish(js_State *J, asyncload_job_t *job) {
+    BITMAP *bm;
+    imgcache_entry_t *cache = NULL;
+
+    if (job->state == ASYNC_FAILED) {
+        js_error(J, "Can't load image '%s'", job->fname);
+        return;
+    }
+
+    if (!job->decoder) {
+        // no decoder for this format, load it with Allegro now
+        bm = Bitmap_loadFile(job->fname, &cache);
+        if (!bm) {
+            job->state = ASYNC_FAILED;
+            js_error(J, "Can't load image '%s'", job->fname);
+            return;
+        }
+    } else {
+        asyncload_image_t *img = &job->img;
+        bm = create_bitmap_ex(32, img->width, img->height);
+        if (!bm) {
+            JS_ENOMEM(J);
+            return;
+        }
+
+        // copy RGBA data in BITMAP
+        uint8_t *src = img->rgba;
+        for (int y = 0; y < bm->h; y++) {
+            uint32_t *dst = (uint32_t *)bm->line[y];
+            for (int x = 0; x < bm->w; x++) {
+                *dst++ = makeacol32(src[0], src[1], src[2], src[3]);
+                src += 4;
+            }
+        }
+        img->free_rgba(img->rgba);
+        img->rgba = NULL;
+
+        cache = imgcache_put(job->fname, bm);
+    }
+    job->state = ASYNC_DONE;
+
+    Bitmap_fromStruct(J, bm, cache, job->fname);
+    js_copy(J, -1);
+    js_defproperty(J, 0, ASYNCLOAD_PROPERTY, JS_READONLY | JS_DONTENUM | JS_DONTCONF);
+}
+
+/**
+ * @brief check if the image was loaded.
+ * ah.Poll():Bitmap
+ *
+ * @param J VM state.
+ */
+static void AsyncBitmap_Poll(js_State *J) {
+    if (js_hasproperty(J, 0, ASYNCLOAD_PROPERTY)) {
+        return;  // already finished, the Bitmap is on the stack
+    }
+
+    asyncload_job_t *job = js_touserdata(J, 0, TAG_ASYNCBITMAP);
+
+    asyncload_state_t state;
+#if LINUX == 1
+    pthread_mutex_lock(&al_mutex);
+    state = job->state;
+    pthread_mutex_unlock(&al_mutex);
+#else
+    // no threads on DOS: decode on the first poll
+    if (job->decoder && job->state == ASYNC_QUEUED) {
+        job->state = asyncload_decode(job) ? ASYNC_DECODED : ASYNC_FAILED;
+    }
+    state = job->state;
+#endif
+
+    if (job->decoder && state == ASYNC_QUEUED) {
+        js_pushnull(J);
+    } else {
+        AsyncBitmap_finish(J, job);
+    }
+}
+
+/**
+ * @brief wait until the image was loaded.
+ * ah.Wait():Bitmap
+ *
+ * @param J VM state.
+ */
+static void AsyncBitmap_Wait(js_State *J) {
+    if (js_hasproperty(J, 0, ASYNCLOAD_PROPERTY)) {
+        return;  // already finished, the Bitmap is on the stack
+    }
+
+    asyncload_job_t *job = js_touserdata(J, 0, TAG_ASYNCBITMAP);
+
+#if LINUX == 1
+    pthread_mutex_lock(&al_mutex);
+    while (job->decoder && job->state == ASYNC_QUEUED) {
+        pthread_cond_wait(&al_done, &al_mutex);
+    }
+    pthread_mutex_unlock(&al_mutex);
+#else
+    if (job->decoder && job->state == ASYNC_QUEUED) {
+        job->state = asyncload_decode(job) ? ASYNC_DECODED : ASYNC_FAILED;
+    }
+#endif
+
+    AsyncBitmap_finish(J, job);
+}
+
+/**
+ * @brief start loading an image in the background.
+ * Bitmap.LoadAsync(fname:string):AsyncBitmap
+ *
+ * @param J VM state.
+ */
+static void Bitmap_LoadAsync(js_State *J) {
+    const char *fname = js_tostring(J, 1);
+
+    asyncload_job_t *job = calloc(1, sizeof(asyncload_job_t));
+    if (!job) {
+        JS_ENOMEM(J);
+        return;
+    }
+    job->fname = ut_clone_string(fname);
+    if (!job->fname) {
+        free(job);
+        JS_ENOMEM(J);
+        return;
+    }
+    job->state = ASYNC_QUEUED;
+
+    // images already in the cache or without a decoder are completed on the main thread
+    if (!imgcache_contains(fname)) {
+        job->decoder = asyncload_find(fname);
+    }
+
+#if LINUX == 1
+    if (job->decoder && !asyncload_enqueue(job)) {
+        job->decoder = NULL;  // no worker thread, fall back to synchronous loading
+    }
+#endif
+
+    js_getregistry(J, TAG_ASYNCBITMAP);
+    js_newuserdata(J, TAG_ASYNCBITMAP, job, AsyncBitmap_Finalize);
+
+    // add properties
+    js_pushstring(J, fname);
+    js_defproperty(J, -2, "filename", JS_READONLY | JS_DONTCONF);
+}
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief register a decoder for background loading. Image types without a decoder are loaded by Allegro on the main thread.
+ *
+ * @param ext the file extension (e.g. "jpg").
+ * @param decoder the decoder function.
+ */
+void asyncload_register(const char *ext, asyncload_decoder_t decoder) {
+    // libraries are re-initialized for every run, replace an existing entry
+    for (int i = 0; i < al_num_decoders; i++) {
+        if (stricmp(al_decoders[i].ext, ext) == 0) {
+            al_decoders[i].decoder = decoder;
+            return;
+        }
+    }
+
+    if (al_num_decoders >= ASYNCLOAD_MAX_DECODERS || strlen(ext) >= ASYNCLOAD_EXT_LEN) {
+        LOGF("Can't register async decoder for '%s'\n", ext);
+        return;
+    }
+    strcpy(al_decoders[al_num_decoders].ext, ext);
+    al_decoders[al_num_decoders].decoder = decoder;
+    al_num_decoders++;
+}
+
+/**
+ * @brief initialize background image loading.
+ *
+ * @param J VM state.
+ */
+void init_asyncload(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    // define the AsyncBitmap prototype, instances are only created by Bitmap.LoadAsync()
+    js_newobject(J);
+    {
+        NPROTDEF(J, AsyncBitmap, Poll, 0);
+        NPROTDEF(J, AsyncBitmap, Wait, 0);
+    }
+    js_setregistry(J, TAG_ASYNCBITMAP);
+
+    // add LoadAsync() to the Bitmap constructor
+    js_getglobal(J, TAG_BITMAP);
+    js_newcfunction(J, Bitmap_LoadAsync, "Bitmap.LoadAsync", 1);
+    js_defproperty(J, -2, "LoadAsync", JS_READONLY | JS_DONTENUM | JS_DONTCONF);
+    js_pop(J, 1);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
@@ -0,0 +1,62 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef __ASYNCLOAD_H__
+#define __ASYNCLOAD_H__
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define TAG_ASYNCBITMAP "AsyncBitmap"  //!< class name for Bitmap.LoadAsync() handles
+
+/************
+** structs **
+************/
+//! decoded RGBA image data as produced by an asyncload_decoder_t
+typedef struct {
+    uint8_t *rgba;               //!< RGBA pixel data, 4 bytes per pixel
+    int width;                   //!< width of the image
+    int height;                  //!< height of the image
+    void (*free_rgba)(void *p);  //!< function to free the pixel data
+} asyncload_image_t;
+
+/**
+ * @brief decode an image file from memory to RGBA. Called from a worker thread, MUST NOT use Allegro or the JS engine.
+ *
+ * @param data the file contents.
+ * @param size size of the file contents.
+ * @param img the decoded image is stored here.
+ *
+ * @return true if the image was decoded, else false.
+ */
+typedef bool (*asyncload_decoder_t)(const uint8_t *data, size_t size, asyncload_image_t *img);
+
+/***********************
+** exported functions **
+***********************/
+extern void init_asyncload(js_State *J);
+extern void asyncload_register(const char *ext, asyncload_decoder_t decoder);
+
+#endif  // __ASYNCLOAD_H__
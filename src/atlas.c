@@ -0,0 +1,423 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "atlas.h"
+
+#include <allegro.h>
+#include <mujs.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "DOjS.h"
+#include "bitmap.h"
+#include "intarray.h"
+
+/************
+** defines **
+************/
+#define ATLAS_ENTRIES_INC 32          //!< allocation increment for the entry table
+#define ATLAS_PROPERTY "___atlas___"  //!< hidden property of an Atlas view, keeps the Atlas alive
+
+/************
+** structs **
+************/
+//! a packed image in the atlas
+typedef struct {
+    int x;        //!< position in the backing bitmap
+    int y;        //!< position in the backing bitmap
+    BITMAP *sub;  //!< sub-bitmap for the area (used for translucent drawing)
+} atlas_entry_t;
+
+//! a shelf of the rectangle packer
+typedef struct {
+    int y;       //!< top of the shelf
+    int height;  //!< height of the shelf
+    int used;    //!< used width of the shelf
+} atlas_shelf_t;
+
+//! sprite atlas
+typedef struct {
+    BITMAP *bm;              //!< backing bitmap
+    atlas_entry_t *entries;  //!< packed images
+    int num_entries;         //!< number of used entries
+    int max_entries;         //!< number of allocated entries
+    atlas_shelf_t *shelves;  //!< shelves of the packer
+    int num_shelves;         //!< number of shelves
+} atlas_t;
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief finalize an atlas and free resources.
+ *
+ * @param J VM state.
+ */
+static void Atlas_Finalize(js_State *J, void *data) {
+    atlas_t *at = (atlas_t *)data;
+
+    DEBUGF("%s: finalize 0x%p\n", __PRETTY_FUNCTION__, data);
+
+    for (int i = 0; i < at->num_entries; i++) {
+        destroy_bitmap(at->entries[i].sub);
+    }
+    free(at->entries);
+    free(at->shelves);
+    destroy_bitmap(at->bm);
+    free(at);
+}
+
+/**
+ * @brief find space for a rectangle using a shelf packer.
+ * Existing shelves are tried first (best height fit), then a new shelf is opened below the last one.
+ *
+ * @param at the atlas.
+ * @param w width of the rectangle.
+ * @param h height of the rectangle.
+ * @param x resulting position.
+ * @param y resulting position.
+ *
+ * @return true if space was found, false if the atlas is full (or out of memory).
+ */
+static bool Atlas_pack(atlas_t *at, int w, int h, int *x, int *y) {
+    atlas_shelf_t *best = NULL;
+
+    if (w > at->bm->w || h > at->bm->h) {
+        return false;
+    }
+
+    // find the shelf that wastes the least height
+    for (int i = 0; i < at->num_shelves; i++) {
+        atlas_shelf_t *s = &at->shelves[i];
+        if (s->height >= h && at->bm->w - s->used >= w) {
+            if (!best || s->height < best->height) {
+                best = s;
+            }
+        }
+    }
+
+    // open a new shelf if there is still room
+    if (!best) {
+        int top = 0;
+        if (at->num_shelves) {
+            atlas_shelf_t *last = &at->shelves[at->num_shelves - 1];
+            top = last->y + last->height;
+        }
+        if (top + h > at->bm->h) {
+            return false;
+        }
+
+        atlas_shelf_t *new_shelves = realloc(at->shelves, sizeof(atlas_shelf_t) * (at->num_shelves + 1));
+        if (!new_shelves) {
+            return false;
+        }
+        at->shelves = new_shelves;
+        best = &at->shelves[at->num_shelves++];
+        best->y = top;
+        best->height = h;
+        best->used = 0;
+    }
+
+    *x = best->used;
+    *y = best->y;
+    best->used += w;
+    return true;
+}
+
+/**
+ * @brief get an entry by id, throws an error for invalid ids.
+ *
+ * @param J VM state.
+ * @param at the atlas.
+ * @param id the id of the entry.
+ *
+ * @return atlas_entry_t* or NULL if the id was invalid.
+ */
+static atlas_entry_t *Atlas_getEntry(js_State *J, atlas_t *at, int id) {
+    if (id < 0 || id >= at->num_entries) {
+        js_error(J, "Atlas id out of range: %d", id);
+        return NULL;
+    }
+    return &at->entries[id];
+}
+
+/**
+ * @brief draw a single entry of the atlas to the current render bitmap.
+ *
+ * @param e the entry.
+ * @param x position.
+ * @param y position.
+ * @param trans true to draw with alpha.
+ */
+static void Atlas_drawEntry(atlas_entry_t *e, int x, int y, bool trans) {
+    if (trans && !DOjS.params.no_alpha) {
+        draw_trans_sprite(DOjS.current_bm, e->sub, x, y);
+    } else {
+        blit(e->sub, DOjS.current_bm, 0, 0, x, y, e->sub->w, e->sub->h);
+    }
+}
+
+/**
+ * @brief create an empty atlas.
+ * new Atlas(width:number, height:number)
+ *
+ * @param J VM state.
+ */
+static void new_Atlas(js_State *J) {
+    NEW_OBJECT_PREP(J);
+
+    int w = js_toint32(J, 1);
+    int h = js_toint32(J, 2);
+    if (w <= 0 || h <= 0) {
+        js_error(J, "Atlas size must be positive: %dx%d", w, h);
+        return;
+    }
+
+    atlas_t *at = calloc(1, sizeof(atlas_t));
+    if (!at) {
+        JS_ENOMEM(J);
+        return;
+    }
+
+    at->bm = create_bitmap_ex(32, w, h);
+    if (!at->bm) {
+        free(at);
+        JS_ENOMEM(J);
+        return;
+    }
+    clear_bitmap(at->bm);
+
+    js_currentfunction(J);
+    js_getproperty(J, -1, "prototype");
+    js_newuserdata(J, TAG_ATLAS, at, Atlas_Finalize);
+
+    // add properties
+    js_pushnumber(J, w);
+    js_defproperty(J, -2, "width", JS_READONLY | JS_DONTCONF);
+
+    js_pushnumber(J, h);
+    js_defproperty(J, -2, "height", JS_READONLY | JS_DONTCONF);
+}
+
+/**
+ * @brief pack a Bitmap into the atlas.
+ * at.Add(bm:Bitmap):number
+ *
+ * @param J VM state.
+ */
+static void Atlas_Add(js_State *J) {
+    atlas_t *at = js_touserdata(J, 0, TAG_ATLAS);
+    JS_CHECKTYPE(J, 1, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 1);
+
+    if (at->num_entries >= at->max_entries) {
+        atlas_entry_t *new_entries = realloc(at->entries, sizeof(atlas_entry_t) * (at->max_entries + ATLAS_ENTRIES_INC));
+        if (!new_entries) {
+            JS_ENOMEM(J);
+            return;
+        }
+        at->entries = new_entries;
+        at->max_entries += ATLAS_ENTRIES_INC;
+    }
+
+    int x, y;
+    if (!Atlas_pack(at, bm->w, bm->h, &x, &y)) {
+        js_error(J, "No space left in Atlas for %dx%d image", bm->w, bm->h);
+        return;
+    }
+
+    atlas_entry_t *e = &at->entries[at->num_entries];
+    e->x = x;
+    e->y = y;
+    e->sub = create_sub_bitmap(at->bm, x, y, bm->w, bm->h);
+    if (!e->sub) {
+        JS_ENOMEM(J);
+        return;
+    }
+    blit(bm, at->bm, 0, 0, x, y, bm->w, bm->h);
+
+    js_pushnumber(J, at->num_entries++);
+}
+
+/**
+ * @brief get a lightweight Bitmap view of an atlas entry. The view shares the pixel data with the atlas.
+ * at.Get(id:number):Bitmap
+ *
+ * @param J VM state.
+ */
+static void Atlas_Get(js_State *J) {
+    atlas_t *at = js_touserdata(J, 0, TAG_ATLAS);
+    atlas_entry_t *e = Atlas_getEntry(J, at, js_toint32(J, 1));
+    if (!e) {
+        return;
+    }
+
+    BITMAP *view = create_sub_bitmap(at->bm, e->x, e->y, e->sub->w, e->sub->h);
+    if (!view) {
+        JS_ENOMEM(J);
+        return;
+    }
+    Bitmap_fromStruct(J, view, NULL, "<<atlas>>");
+
+    // the view must keep the atlas alive
+    js_copy(J, 0);
+    js_defproperty(J, -2, ATLAS_PROPERTY, JS_READONLY | JS_DONTENUM | JS_DONTCONF);
+}
+
+/**
+ * @brief get the position of an entry in the atlas.
+ * at.GetRect(id:number):{x:number, y:number, width:number, height:number}
+ *
+ * @param J VM state.
+ */
+static void Atlas_GetRect(js_State *J) {
+    atlas_t *at = js_touserdata(J, 0, TAG_ATLAS);
+    atlas_entry_t *e = Atlas_getEntry(J, at, js_toint32(J, 1));
+    if (!e) {
+        return;
+    }
+
+    js_newobject(J);
+    {
+        js_pushnumber(J, e->x);
+        js_setproperty(J, -2, "x");
+        js_pushnumber(J, e->y);
+        js_setproperty(J, -2, "y");
+        js_pushnumber(J, e->sub->w);
+        js_setproperty(J, -2, "width");
+        js_pushnumber(J, e->sub->h);
+        js_setproperty(J, -2, "height");
+    }
+}
+
+/**
+ * @brief get the number of images in the atlas.
+ * at.Size():number
+ *
+ * @param J VM state.
+ */
+static void Atlas_Size(js_State *J) {
+    atlas_t *at = js_touserdata(J, 0, TAG_ATLAS);
+    js_pushnumber(J, at->num_entries);
+}
+
+/**
+ * @brief draw an entry to the canvas.
+ * at.Draw(id:number, x:number, y:number)
+ *
+ * @param J VM state.
+ */
+static void Atlas_Draw(js_State *J) {
+    atlas_t *at = js_touserdata(J, 0, TAG_ATLAS);
+    atlas_entry_t *e = Atlas_getEntry(J, at, js_toint32(J, 1));
+    if (!e) {
+        return;
+    }
+    Atlas_drawEntry(e, js_toint16(J, 2), js_toint16(J, 3), false);
+}
+
+/**
+ * @brief draw an entry to the canvas using the alpha channel.
+ * at.DrawTrans(id:number, x:number, y:number)
+ *
+ * @param J VM state.
+ */
+static void Atlas_DrawTrans(js_State *J) {
+    atlas_t *at = js_touserdata(J, 0, TAG_ATLAS);
+    atlas_entry_t *e = Atlas_getEntry(J, at, js_toint32(J, 1));
+    if (!e) {
+        return;
+    }
+    Atlas_drawEntry(e, js_toint16(J, 2), js_toint16(J, 3), true);
+}
+
+/**
+ * @brief draw many entries with one call.
+ * at.DrawBatch(records:IntArray|number[], trans:boolean)
+ * records are flat (id, x, y) triplets.
+ *
+ * @param J VM state.
+ */
+static void Atlas_DrawBatch(js_State *J) {
+    atlas_t *at = js_touserdata(J, 0, TAG_ATLAS);
+    bool trans = js_toboolean(J, 2);
+
+    if (js_isuserdata(J, 1, TAG_INT_ARRAY)) {
+        int_array_t *ia = js_touserdata(J, 1, TAG_INT_ARRAY);
+        for (uint32_t i = 0; i + 2 < ia->size; i += 3) {
+            atlas_entry_t *e = Atlas_getEntry(J, at, ia->data[i]);
+            if (!e) {
+                return;
+            }
+            Atlas_drawEntry(e, ia->data[i + 1], ia->data[i + 2], trans);
+        }
+    } else if (js_isarray(J, 1)) {
+        int len = js_getlength(J, 1);
+        for (int i = 0; i + 2 < len; i += 3) {
+            js_getindex(J, 1, i);
+            atlas_entry_t *e = Atlas_getEntry(J, at, js_toint32(J, -1));
+            js_pop(J, 1);
+            if (!e) {
+                return;
+            }
+
+            js_getindex(J, 1, i + 1);
+            int x = js_toint16(J, -1);
+            js_pop(J, 1);
+
+            js_getindex(J, 1, i + 2);
+            int y = js_toint16(J, -1);
+            js_pop(J, 1);
+
+            Atlas_drawEntry(e, x, y, trans);
+        }
+    } else {
+        js_error(J, "IntArray or Array expected");
+    }
+}
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief initialize atlas subsystem.
+ *
+ * @param J VM state.
+ */
+void init_atlas(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    js_newobject(J);
+    {
+        NPROTDEF(J, Atlas, Add, 1);
+        NPROTDEF(J, Atlas, Get, 1);
+        NPROTDEF(J, Atlas, GetRect, 1);
+        NPROTDEF(J, Atlas, Size, 0);
+        NPROTDEF(J, Atlas, Draw, 3);
+        NPROTDEF(J, Atlas, DrawTrans, 3);
+        NPROTDEF(J, Atlas, DrawBatch, 2);
+    }
+    CTORDEF(J, new_Atlas, TAG_ATLAS, 2);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
@@ -29,6 +29,7 @@ SOFTWARE.
 
 #include "DOjS.h"
 #include "color.h"
+#include "imgcache.h"
 #include "util.h"
 #include "zipfile.h"
 #include "blurhash.h"
@@ -46,26 +47,185 @@ SOFTWARE.
 #endif
 #endif
 
+/************
+** defines **
+************/
+#define BITMAP_TARGETS_GROW 16  //!< the list of pinned render targets grows in steps of this many entries
+
+/************
+** structs **
+************/
+//! optimization modes for Bitmap.Optimize()
+typedef enum {
+    BM_OPT_NONE = 0,      //!< plain BITMAP, generic blitter
+    BM_OPT_RLE = 1,       //!< RLE sprite
+    BM_OPT_COMPILED = 2,  //!< compiled sprite (plus RLE sprite for clipping and translucent drawing)
+} bitmap_opt_t;
+
+//! optimized representation of a Bitmap
+typedef struct __bitmap_sprite {
+    bitmap_opt_t mode;          //!< the optimization mode
+    RLE_SPRITE *rle;            //!< RLE sprite, always available
+    COMPILED_SPRITE *compiled;  //!< compiled sprite, only for BM_OPT_COMPILED
+} bitmap_sprite_t;
+
+/*********************
+** static variables **
+*********************/
+static BITMAP **bitmap_targets = NULL;  //!< BITMAPs pinned as render targets by Bitmap_pinTarget()
+static int bitmap_num_targets = 0;      //!< number of entries in bitmap_targets
+static int bitmap_max_targets = 0;      //!< number of entries allocated for bitmap_targets
+
 /*********************
 ** static functions **
 *********************/
+/**
+ * @brief free an optimized sprite.
+ *
+ * @param spr the sprite to free.
+ */
+static void Bitmap_freeSprite(bitmap_sprite_t *spr) {
+    if (spr->compiled) {
+        destroy_compiled_sprite(spr->compiled);
+    }
+    if (spr->rle) {
+        destroy_rle_sprite(spr->rle);
+    }
+    free(spr);
+}
+
+/**
+ * @brief get the optimized form of the Bitmap at idx (if any).
+ *
+ * @param J VM state.
+ * @param idx stack index of the Bitmap.
+ *
+ * @return bitmap_sprite_t* or NULL if the Bitmap was not optimized.
+ */
+static bitmap_sprite_t *Bitmap_getSprite(js_State *J, int idx) {
+    bitmap_t *b = js_touserdata(J, idx, TAG_BITMAP);
+    return b->sprite;
+}
+
+/**
+ * @brief drop the optimized form of a Bitmap (if any).
+ *
+ * @param b the Bitmap userdata.
+ */
+static void Bitmap_dropSprite(bitmap_t *b) {
+    if (b->sprite) {
+        Bitmap_freeSprite(b->sprite);
+        b->sprite = NULL;
+    }
+}
+
+/**
+ * @brief check if a BITMAP is currently used as render target (current Bitmap, 3D scene, OSMesa context).
+ *
+ * @param bm the BITMAP to check.
+ *
+ * @return true if the BITMAP may be modified without a call to Bitmap_writable().
+ */
+static bool Bitmap_isTarget(BITMAP *bm) {
+    if (DOjS.current_bm == bm) {
+        return true;
+    }
+    for (int i = 0; i < bitmap_num_targets; i++) {
+        if (bitmap_targets[i] == bm) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief get the optimized form of the Bitmap at idx if it can be used for drawing.
+ *
+ * @param J VM state.
+ * @param idx stack index of the Bitmap.
+ * @param bm the BITMAP of the Bitmap.
+ *
+ * @return bitmap_sprite_t* or NULL if the Bitmap was not optimized or the optimized form may be outdated.
+ */
+static bitmap_sprite_t *Bitmap_getValidSprite(js_State *J, int idx, BITMAP *bm) {
+    bitmap_sprite_t *spr = Bitmap_getSprite(J, idx);
+    if (!spr || Bitmap_isTarget(bm) || spr->rle->color_depth != bitmap_color_depth(DOjS.current_bm)) {
+        return NULL;
+    }
+    return spr;
+}
+
 /**
  * @brief finalize an image and free resources.
  *
  * @param J VM state.
  */
 static void Bitmap_Finalize(js_State *J, void *data) {
-    BITMAP *bm = (BITMAP *)data;
+    bitmap_t *b = (bitmap_t *)data;
 
     DEBUGF("%s: finalize 0x%p\n", __PRETTY_FUNCTION__, data);
 
     // safeguard of someone GCs our current Bitmap
-    if (DOjS.current_bm == bm) {
+    if (DOjS.current_bm == b->bm) {
         DOjS.current_bm = DOjS.render_bm;
         LOG("GC of current render Bitmap!\n");
     }
 
-    destroy_bitmap(bm);
+    // a renderer still using this Bitmap must not match a new BITMAP at the same address
+    for (int i = 0; i < bitmap_num_targets;) {
+        if (bitmap_targets[i] == b->bm) {
+            bitmap_targets[i] = bitmap_targets[--bitmap_num_targets];
+        } else {
+            i++;
+        }
+    }
+
+    Bitmap_dropSprite(b);
+
+    // shared images are owned by the image cache
+    if (b->cache) {
+        imgcache_release(b->cache);
+    } else {
+        destroy_bitmap(b->bm);
+    }
+    free(b);
+}
+
+/**
+ * @brief wrap a BITMAP into a new Bitmap object, the prototype must be on the stack and is replaced by the object.
+ * On error the BITMAP is released and an error is thrown.
+ *
+ * @param J VM state.
+ * @param bm the BITMAP, the object takes ownership.
+ * @param cache image cache entry if the BITMAP is shared with the cache, else NULL.
+ * @param fname the name to use for the 'filename' property.
+ */
+static void Bitmap_newObject(js_State *J, BITMAP *bm, imgcache_entry_t *cache, const char *fname) {
+    bitmap_t *b = malloc(sizeof(bitmap_t));
+    if (!b) {
+        if (cache) {
+            imgcache_release(cache);
+        } else {
+            destroy_bitmap(bm);
+        }
+        JS_ENOMEM(J);
+        return;
+    }
+    b->bm = bm;
+    b->cache = cache;
+    b->sprite = NULL;
+
+    js_newuserdata(J, TAG_BITMAP, b, Bitmap_Finalize);
+
+    // add properties
+    js_pushstring(J, fname);
+    js_defproperty(J, -2, "filename", JS_READONLY | JS_DONTCONF);
+
+    js_pushnumber(J, bm->w);
+    js_defproperty(J, -2, "width", JS_READONLY | JS_DONTCONF);
+
+    js_pushnumber(J, bm->h);
+    js_defproperty(J, -2, "height", JS_READONLY | JS_DONTCONF);
 }
 
 /**
@@ -82,6 +242,7 @@ static void new_Bitmap(js_State *J) {
     NEW_OBJECT_PREP(J);
     const char *fname = "<<buffer>>";
     BITMAP *bm = NULL;
+    imgcache_entry_t *cache = NULL;
 
 #if LINUX != 1
     if (js_isnumber(J, 1) && js_isnumber(J, 2) && js_isnumber(J, 3) && js_isnumber(J, 4) && js_isnumber(J, 5)) {
@@ -237,27 +398,10 @@ static void new_Bitmap(js_State *J) {
         // new Bitmap("filename")
         fname = js_tostring(J, 1);
 
-        char *delim = strchr(fname, ZIP_DELIM);
-
-        if (!delim) {
-            bm = load_bitmap(fname, NULL);
-            if (!bm) {
-                js_error(J, "Can't load image '%s'", fname);
-                return;
-            }
-        } else {
-            PACKFILE *pf = open_zipfile1(fname);
-            if (!pf) {
-                js_error(J, "Can't load image '%s'", fname);
-                return;
-            }
-            bm = load_bitmap_pf(pf, NULL, ut_getFilenameExt(fname));
-            pack_fclose(pf);
-
-            if (!bm) {
-                js_error(J, "Can't load image '%s'", fname);
-                return;
-            }
+        bm = Bitmap_loadFile(fname, &cache);
+        if (!bm) {
+            js_error(J, "Can't load image '%s'", fname);
+            return;
         }
     } else if (js_isarray(J, 1) && js_isnumber(J, 2) && js_isnumber(J, 3)) {
         // new Bitmap(data[], width, height)
@@ -284,17 +428,7 @@ static void new_Bitmap(js_State *J) {
 
     js_currentfunction(J);
     js_getproperty(J, -1, "prototype");
-    js_newuserdata(J, TAG_BITMAP, bm, Bitmap_Finalize);
-
-    // add properties
-    js_pushstring(J, fname);
-    js_defproperty(J, -2, "filename", JS_READONLY | JS_DONTCONF);
-
-    js_pushnumber(J, bm->w);
-    js_defproperty(J, -2, "width", JS_READONLY | JS_DONTCONF);
-
-    js_pushnumber(J, bm->h);
-    js_defproperty(J, -2, "height", JS_READONLY | JS_DONTCONF);
+    Bitmap_newObject(J, bm, cache, fname);
 }
 
 /**
@@ -304,12 +438,36 @@ static void new_Bitmap(js_State *J) {
  * @param J VM state.
  */
 static void Bitmap_Draw(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     uint16_t x = js_touint16(J, 1);
     uint16_t y = js_touint16(J, 2);
+
     blit(bm, DOjS.current_bm, 0, 0, x, y, bm->w, bm->h);
 }
 
+/**
+ * @brief draw the image to the canvas, pixels with the mask color are skipped.
+ * img.DrawMasked(x, y)
+ *
+ * @param J VM state.
+ */
+static void Bitmap_DrawMasked(js_State *J) {
+    BITMAP *bm = Bitmap_get(J, 0);
+    uint16_t x = js_touint16(J, 1);
+    uint16_t y = js_touint16(J, 2);
+
+    BITMAP *dst = DOjS.current_bm;
+    bitmap_sprite_t *spr = Bitmap_getValidSprite(J, 0, bm);
+    if (!spr) {
+        masked_blit(bm, dst, 0, 0, x, y, bm->w, bm->h);
+    } else if (spr->compiled && x >= dst->cl && y >= dst->ct && x + bm->w <= dst->cr && y + bm->h <= dst->cb) {
+        // compiled sprites do not clip, only use them if the whole sprite is visible
+        draw_compiled_sprite(dst, spr->compiled, x, y);
+    } else {
+        draw_rle_sprite(dst, spr->rle, x, y);
+    }
+}
+
 /**
  * @brief draw the image to the canvas.
  * img.DrawAdvanced(source_x, source_y, source_width, source_height, dest_x, dest_y, dest_width, dest_height)
@@ -317,7 +475,7 @@ static void Bitmap_Draw(js_State *J) {
  * @param J VM state.
  */
 static void Bitmap_DrawAdvanced(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     uint16_t srcX = js_touint16(J, 1);
     uint16_t srcY = js_touint16(J, 2);
     uint16_t srcW = js_touint16(J, 3);
@@ -343,8 +501,10 @@ static void Bitmap_DrawAdvanced(js_State *J) {
  * @param J VM state.
  */
 static void Bitmap_Clear(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
-    clear_bitmap(bm);
+    BITMAP *bm = Bitmap_writable(J, 0);
+    if (bm) {
+        clear_bitmap(bm);
+    }
 }
 
 /**
@@ -354,19 +514,84 @@ static void Bitmap_Clear(js_State *J) {
  * @param J VM state.
  */
 static void Bitmap_DrawTrans(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     uint16_t x = js_touint16(J, 1);
     uint16_t y = js_touint16(J, 2);
+
     if (DOjS.params.no_alpha) {
         blit(bm, DOjS.current_bm, 0, 0, x, y, bm->w, bm->h);
     } else {
-        draw_trans_sprite(DOjS.current_bm, bm, x, y);
+        bitmap_sprite_t *spr = Bitmap_getValidSprite(J, 0, bm);
+        if (spr) {
+            draw_trans_rle_sprite(DOjS.current_bm, spr->rle, x, y);
+        } else {
+            draw_trans_sprite(DOjS.current_bm, bm, x, y);
+        }
+    }
+}
+
+/**
+ * @brief create an optimized representation used by DrawMasked() and DrawTrans().
+ * The optimized form is dropped when the Bitmap is modified.
+ * img.Optimize(mode:number)
+ *
+ * @param J VM state.
+ */
+static void Bitmap_Optimize(js_State *J) {
+    bitmap_t *b = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = b->bm;
+    bitmap_opt_t mode = js_isdefined(J, 1) ? js_toint32(J, 1) : BM_OPT_RLE;
+
+    if (mode != BM_OPT_NONE && mode != BM_OPT_RLE && mode != BM_OPT_COMPILED) {
+        js_error(J, "Unknown optimization mode %d", mode);
+        return;
+    }
+
+    Bitmap_dropSprite(b);
+    if (mode == BM_OPT_NONE) {
+        return;
+    }
+
+    if (Bitmap_isTarget(bm)) {
+        js_error(J, "A Bitmap used as render target can't be optimized");
+        return;
+    }
+
+    bitmap_sprite_t *spr = calloc(1, sizeof(bitmap_sprite_t));
+    if (!spr) {
+        JS_ENOMEM(J);
+        return;
+    }
+    spr->mode = mode;
+
+    spr->rle = get_rle_sprite(bm);
+    if (spr->rle && mode == BM_OPT_COMPILED) {
+        spr->compiled = get_compiled_sprite(bm, FALSE);
     }
+
+    if (!spr->rle || (mode == BM_OPT_COMPILED && !spr->compiled)) {
+        Bitmap_freeSprite(spr);
+        JS_ENOMEM(J);
+        return;
+    }
+
+    b->sprite = spr;
+}
+
+/**
+ * @brief get the current optimization mode of this Bitmap.
+ * img.GetOptimization():number
+ *
+ * @param J VM state.
+ */
+static void Bitmap_GetOptimization(js_State *J) {
+    bitmap_sprite_t *spr = Bitmap_getSprite(J, 0);
+    js_pushnumber(J, spr ? spr->mode : BM_OPT_NONE);
 }
 
 #ifdef LFB_3DFX
 static void Bitmap_FxDrawLfb(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     uint16_t *buf = malloc(bm->w * bm->h * sizeof(uint16_t));
     if (!buf) {
         JS_ENOMEM(J);
@@ -407,7 +632,7 @@ static void Bitmap_FxDrawLfb(js_State *J) {
  * @param J the JS context.
  */
 static void Bitmap_GetPixel(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
 
     uint16_t x = js_touint16(J, 1);
     uint16_t y = js_touint16(J, 2);
@@ -422,7 +647,7 @@ static void Bitmap_GetPixel(js_State *J) {
  * @param J the JS context.
  */
 static void Bitmap_SaveBmpImage(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     const char *fname = js_tostring(J, 1);
 
     PALETTE pal;
@@ -440,7 +665,7 @@ static void Bitmap_SaveBmpImage(js_State *J) {
  * @param J the JS context.
  */
 static void Bitmap_SavePcxImage(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     const char *fname = js_tostring(J, 1);
 
     PALETTE pal;
@@ -459,7 +684,7 @@ static void Bitmap_SavePcxImage(js_State *J) {
  * @param J the JS context.
  */
 static void Bitmap_SavePngImage(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     const char *fname = js_tostring(J, 1);
 
     PALETTE pal;
@@ -477,7 +702,7 @@ static void Bitmap_SavePngImage(js_State *J) {
  * @param J the JS context.
  */
 static void Bitmap_SaveQoiImage(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     const char *fname = js_tostring(J, 1);
 
     if (!save_qoi(bm, fname)) {
@@ -492,7 +717,7 @@ static void Bitmap_SaveQoiImage(js_State *J) {
  * @param J the JS context.
  */
 static void Bitmap_SaveWebpImage(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     const char *fname = js_tostring(J, 1);
 
     if (!save_webp(bm, fname)) {
@@ -508,7 +733,7 @@ static void Bitmap_SaveWebpImage(js_State *J) {
  * @param J the JS context.
  */
 static void Bitmap_SaveTgaImage(js_State *J) {
-    BITMAP *bm = js_touserdata(J, 0, TAG_BITMAP);
+    BITMAP *bm = Bitmap_get(J, 0);
     const char *fname = js_tostring(J, 1);
 
     PALETTE pal;
@@ -522,6 +747,85 @@ static void Bitmap_SaveTgaImage(js_State *J) {
 /***********************
 ** exported functions **
 ***********************/
+/**
+ * @brief prepare a Bitmap for modification, must be called before the pixel data of a Bitmap is changed.
+ * This drops the optimized form (if any) and creates a private copy of images shared with the image cache.
+ *
+ * @param J VM state.
+ * @param idx stack index of the Bitmap.
+ *
+ * @return BITMAP* the BITMAP that may be modified or NULL if out of memory (an error is thrown).
+ */
+BITMAP *Bitmap_writable(js_State *J, int idx) {
+    bitmap_t *b = js_touserdata(J, idx, TAG_BITMAP);
+
+    Bitmap_dropSprite(b);
+
+    if (b->cache) {
+        BITMAP *copy = create_bitmap_ex(bitmap_color_depth(b->bm), b->bm->w, b->bm->h);
+        if (!copy) {
+            JS_ENOMEM(J);
+            return NULL;
+        }
+        blit(b->bm, copy, 0, 0, 0, 0, b->bm->w, b->bm->h);
+
+        // use the private copy and release the shared one
+        DEBUGF("Copy on write 0x%p -> 0x%p\n", b->bm, copy);
+        imgcache_release(b->cache);
+        b->cache = NULL;
+        b->bm = copy;
+    }
+    return b->bm;
+}
+
+/**
+ * @brief pin a BITMAP as render target of a renderer that writes to it without calling Bitmap_writable() (e.g. 3D scene, OSMesa).
+ * Optimized forms of pinned BITMAPs are ignored when drawing and pinned BITMAPs can't be optimized.
+ * Pins are counted, each successful call must be matched by a call to Bitmap_unpinTarget().
+ *
+ * @param bm the BITMAP to pin.
+ *
+ * @return true if the BITMAP was pinned, false if out of memory. The caller must not render into the BITMAP in that case.
+ */
+bool Bitmap_pinTarget(BITMAP *bm) {
+    if (bitmap_num_targets >= bitmap_max_targets) {
+        BITMAP **new_targets = realloc(bitmap_targets, (bitmap_max_targets + BITMAP_TARGETS_GROW) * sizeof(BITMAP *));
+        if (!new_targets) {
+            return false;
+        }
+        bitmap_targets = new_targets;
+        bitmap_max_targets += BITMAP_TARGETS_GROW;
+    }
+    bitmap_targets[bitmap_num_targets++] = bm;
+    return true;
+}
+
+/**
+ * @brief remove one pin of a BITMAP set by Bitmap_pinTarget().
+ *
+ * @param bm the BITMAP to unpin, NULL is ignored.
+ */
+void Bitmap_unpinTarget(BITMAP *bm) {
+    for (int i = 0; bm && i < bitmap_num_targets; i++) {
+        if (bitmap_targets[i] == bm) {
+            bitmap_targets[i] = bitmap_targets[--bitmap_num_targets];
+            return;
+        }
+    }
+}
+
+/**
+ * @brief get the BITMAP of a Bitmap object. The BITMAP must not be modified, use Bitmap_writable() for that.
+ *
+ * @param J VM state.
+ * @param idx stack index of the Bitmap.
+ *
+ * @return BITMAP* the image, an error is thrown if the value is not a Bitmap.
+ */
+BITMAP *Bitmap_get(js_State *J, int idx) {
+    bitmap_t *b = js_touserdata(J, idx, TAG_BITMAP);
+    return b->bm;
+}
 
 /**
  * @brief create a bitmap from RGBA data.
@@ -555,17 +859,55 @@ void Bitmap_fromRGBA(js_State *J, const uint8_t *data, int w, int h) {
 
     js_currentfunction(J);
     js_getproperty(J, -1, "prototype");
-    js_newuserdata(J, TAG_BITMAP, bm, Bitmap_Finalize);
+    Bitmap_newObject(J, bm, NULL, fname);
+}
 
-    // add properties
-    js_pushstring(J, fname);
-    js_defproperty(J, -2, "filename", JS_READONLY | JS_DONTCONF);
+/**
+ * @brief load an image file (or zip entry) into a BITMAP. An already decoded image is shared using the image cache.
+ *
+ * @param fname the file name, may contain ZIP_DELIM to load from a ZIP file.
+ * @param cache the image cache entry is stored here if the BITMAP is shared with the cache, else NULL.
+ *
+ * @return BITMAP* or NULL if loading failed.
+ */
+BITMAP *Bitmap_loadFile(const char *fname, imgcache_entry_t **cache) {
+    // try to share an already decoded image
+    *cache = NULL;
+    BITMAP *bm = imgcache_get(fname, cache);
+    if (bm) {
+        DEBUGF("Image cache hit for '%s'\n", fname);
+        return bm;
+    }
 
-    js_pushnumber(J, bm->w);
-    js_defproperty(J, -2, "width", JS_READONLY | JS_DONTCONF);
+    if (!strchr(fname, ZIP_DELIM)) {
+        bm = load_bitmap(fname, NULL);
+    } else {
+        PACKFILE *pf = open_zipfile1(fname);
+        if (!pf) {
+            return NULL;
+        }
+        bm = load_bitmap_pf(pf, NULL, ut_getFilenameExt(fname));
+        pack_fclose(pf);
+    }
 
-    js_pushnumber(J, bm->h);
-    js_defproperty(J, -2, "height", JS_READONLY | JS_DONTCONF);
+    if (bm) {
+        *cache = imgcache_put(fname, bm);
+    }
+    return bm;
+}
+
+/**
+ * @brief create a Bitmap object from an existing BITMAP. The object remains on the stack.
+ * The Bitmap takes ownership of the BITMAP (or of the reference to the cache entry), it is released when the object is garbage collected.
+ *
+ * @param J VM state.
+ * @param bm the BITMAP.
+ * @param cache image cache entry if the BITMAP is shared with the cache, else NULL.
+ * @param fname the name to use for the 'filename' property.
+ */
+void Bitmap_fromStruct(js_State *J, BITMAP *bm, imgcache_entry_t *cache, const char *fname) {
+    js_getregistry(J, TAG_BITMAP);
+    Bitmap_newObject(J, bm, cache, fname);
 }
 
 /**
@@ -580,10 +922,13 @@ void init_bitmap(js_State *J) {
     js_newobject(J);
     {
         NPROTDEF(J, Bitmap, Draw, 2);
+        NPROTDEF(J, Bitmap, DrawMasked, 2);
         NPROTDEF(J, Bitmap, DrawAdvanced, 8);
         NPROTDEF(J, Bitmap, Clear, 0);
         NPROTDEF(J, Bitmap, DrawTrans, 2);
         NPROTDEF(J, Bitmap, GetPixel, 2);
+        NPROTDEF(J, Bitmap, Optimize, 1);
+        NPROTDEF(J, Bitmap, GetOptimization, 0);
         NPROTDEF(J, Bitmap, SaveBmpImage, 1);
         NPROTDEF(J, Bitmap, SavePcxImage, 1);
         NPROTDEF(J, Bitmap, SaveTgaImage, 1);
@@ -596,6 +941,8 @@ void init_bitmap(js_State *J) {
         NPROTDEF(J, Bitmap, FxDrawLfb, 4);
 #endif
     }
+    js_copy(J, -1);
+    js_setregistry(J, TAG_BITMAP);  // keep the prototype for Bitmap_fromStruct()
     CTORDEF(J, new_Bitmap, TAG_BITMAP, 5);
 
     DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
@@ -30,10 +30,26 @@ SOFTWARE.
 ************/
 #define TAG_BITMAP "Bitmap"  //!< class name for Bitmap()
 
+/************
+** structs **
+************/
+//! userdata of a Bitmap object
+typedef struct __bitmap {
+    BITMAP *bm;                      //!< the image
+    struct __imgcache_entry *cache;  //!< image cache entry if bm is shared with the cache (copied before modification), else NULL
+    struct __bitmap_sprite *sprite;  //!< optimized form created by Bitmap.Optimize(), NULL if not optimized
+} bitmap_t;
+
 /***********************
 ** exported functions **
 ***********************/
 extern void init_bitmap(js_State *J);
+extern BITMAP *Bitmap_get(js_State *J, int idx);
 extern void Bitmap_fromRGBA(js_State *J, const uint8_t *data, int w, int h);
+extern BITMAP *Bitmap_writable(js_State *J, int idx);
+extern bool Bitmap_pinTarget(BITMAP *bm);
+extern void Bitmap_unpinTarget(BITMAP *bm);
+extern void Bitmap_fromStruct(js_State *J, BITMAP *bm, struct __imgcache_entry *cache, const char *fname);
+extern BITMAP *Bitmap_loadFile(const char *fname, struct __imgcache_entry **cache);
 
 #endif  // __BITMAP_H__
@@ -21,13 +21,215 @@ SOFTWARE.
 */
 
 #include <allegro.h>
+#include <ctype.h>
+#include <math.h>
 #include <mujs.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "DOjS.h"
 #include "color.h"
 
+/************
+** defines **
+************/
+#define COLOR_CACHE_SIZE 256  //!< number of entries in the cache for ColorFromArgs(), must be a power of two
+#define COLOR_KEY_MAX 80      //!< maximum key size for the cache, longer color strings are not cached
+#define COLOR_STR_MAX 64      //!< maximum length of a color string, longer strings are treated as unknown color
+
+/************
+** structs **
+************/
+//! color modes as used by p5js colorMode()
+typedef enum {
+    COLOR_MODE_RGB,  //!< red, green, blue
+    COLOR_MODE_HSB,  //!< hue, saturation, brightness
+    COLOR_MODE_HSL   //!< hue, saturation, lightness
+} color_mode_t;
+
+//! color arguments extracted from a JS argument list
+typedef struct {
+    color_mode_t mode;  //!< color mode
+    double maxes[4];    //!< maximum values of the components for the mode
+    int nargs;          //!< number of arguments
+    const char *str;    //!< the color string if a single string was passed, else NULL
+    double val[4];      //!< first four numeric arguments
+    bool isnum[4];      //!< true if the corresponding argument is a number
+} color_args_t;
+
+//! a cache entry, the key is built from the arguments
+typedef struct {
+    uint32_t hash;               //!< hash of the key
+    int len;                     //!< length of the key, 0 for unused entries
+    uint8_t key[COLOR_KEY_MAX];  //!< the key
+    uint32_t color;              //!< the resulting Allegro color
+} color_cache_entry_t;
+
+//! CSS color names
+typedef struct {
+    const char *name;  //!< the name
+    uint32_t rgb;      //!< RGB value
+} color_name_t;
+
+/*********************
+** static variables **
+*********************/
+//! CSS named colors, sorted by name for bsearch()
+static const color_name_t color_names[] = {
+    {"aliceblue", 0xF0F8FF},
+    {"antiquewhite", 0xFAEBD7},
+    {"aqua", 0x00FFFF},
+    {"aquamarine", 0x7FFFD4},
+    {"azure", 0xF0FFFF},
+    {"beige", 0xF5F5DC},
+    {"bisque", 0xFFE4C4},
+    {"black", 0x000000},
+    {"blanchedalmond", 0xFFEBCD},
+    {"blue", 0x0000FF},
+    {"blueviolet", 0x8A2BE2},
+    {"brown", 0xA52A2A},
+    {"burlywood", 0xDEB887},
+    {"cadetblue", 0x5F9EA0},
+    {"chartreuse", 0x7FFF00},
+    {"chocolate", 0xD2691E},
+    {"coral", 0xFF7F50},
+    {"cornflowerblue", 0x6495ED},
+    {"cornsilk", 0xFFF8DC},
+    {"crimson", 0xDC143C},
+    {"cyan", 0x00FFFF},
+    {"darkblue", 0x00008B},
+    {"darkcyan", 0x008B8B},
+    {"darkgoldenrod", 0xB8860B},
+    {"darkgray", 0xA9A9A9},
+    {"darkgreen", 0x006400},
+    {"darkgrey", 0xA9A9A9},
+    {"darkkhaki", 0xBDB76B},
+    {"darkmagenta", 0x8B008B},
+    {"darkolivegreen", 0x556B2F},
+    {"darkorange", 0xFF8C00},
+    {"darkorchid", 0x9932CC},
+    {"darkred", 0x8B0000},
+    {"darksalmon", 0xE9967A},
+    {"darkseagreen", 0x8FBC8F},
+    {"darkslateblue", 0x483D8B},
+    {"darkslategray", 0x2F4F4F},
+    {"darkslategrey", 0x2F4F4F},
+    {"darkturquoise", 0x00CED1},
+    {"darkviolet", 0x9400D3},
+    {"deeppink", 0xFF1493},
+    {"deepskyblue", 0x00BFFF},
+    {"dimgray", 0x696969},
+    {"dimgrey", 0x696969},
+    {"dodgerblue", 0x1E90FF},
+    {"firebrick", 0xB22222},
+    {"floralwhite", 0xFFFAF0},
+    {"forestgreen", 0x228B22},
+    {"fuchsia", 0xFF00FF},
+    {"gainsboro", 0xDCDCDC},
+    {"ghostwhite", 0xF8F8FF},
+    {"gold", 0xFFD700},
+    {"goldenrod", 0xDAA520},
+    {"gray", 0x808080},
+    {"green", 0x008000},
+    {"greenyellow", 0xADFF2F},
+    {"grey", 0x808080},
+    {"honeydew", 0xF0FFF0},
+    {"hotpink", 0xFF69B4},
+    {"indianred", 0xCD5C5C},
+    {"indigo", 0x4B0082},
+    {"ivory", 0xFFFFF0},
+    {"khaki", 0xF0E68C},
+    {"lavender", 0xE6E6FA},
+    {"lavenderblush", 0xFFF0F5},
+    {"lawngreen", 0x7CFC00},
+    {"lemonchiffon", 0xFFFACD},
+    {"lightblue", 0xADD8E6},
+    {"lightcoral", 0xF08080},
+    {"lightcyan", 0xE0FFFF},
+    {"lightgoldenrodyellow", 0xFAFAD2},
+    {"lightgray", 0xD3D3D3},
+    {"lightgreen", 0x90EE90},
+    {"lightgrey", 0xD3D3D3},
+    {"lightpink", 0xFFB6C1},
+    {"lightsalmon", 0xFFA07A},
+    {"lightseagreen", 0x20B2AA},
+    {"lightskyblue", 0x87CEFA},
+    {"lightslategray", 0x778899},
+    {"lightslategrey", 0x778899},
+    {"lightsteelblue", 0xB0C4DE},
+    {"lightyellow", 0xFFFFE0},
+    {"lime", 0x00FF00},
+    {"limegreen", 0x32CD32},
+    {"linen", 0xFAF0E6},
+    {"magenta", 0xFF00FF},
+    {"maroon", 0x800000},
+    {"mediumaquamarine", 0x66CDAA},
+    {"mediumblue", 0x0000CD},
+    {"mediumorchid", 0xBA55D3},
+    {"mediumpurple", 0x9370DB},
+    {"mediumseagreen", 0x3CB371},
+    {"mediumslateblue", 0x7B68EE},
+    {"mediumspringgreen", 0x00FA9A},
+    {"mediumturquoise", 0x48D1CC},
+    {"mediumvioletred", 0xC71585},
+    {"midnightblue", 0x191970},
+    {"mintcream", 0xF5FFFA},
+    {"mistyrose", 0xFFE4E1},
+    {"moccasin", 0xFFE4B5},
+    {"navajowhite", 0xFFDEAD},
+    {"navy", 0x000080},
+    {"oldlace", 0xFDF5E6},
+    {"olive", 0x808000},
+    {"olivedrab", 0x6B8E23},
+    {"orange", 0xFFA500},
+    {"orangered", 0xFF4500},
+    {"orchid", 0xDA70D6},
+    {"palegoldenrod", 0xEEE8AA},
+    {"palegreen", 0x98FB98},
+    {"paleturquoise", 0xAFEEEE},
+    {"palevioletred", 0xDB7093},
+    {"papayawhip", 0xFFEFD5},
+    {"peachpuff", 0xFFDAB9},
+    {"peru", 0xCD853F},
+    {"pink", 0xFFC0CB},
+    {"plum", 0xDDA0DD},
+    {"powderblue", 0xB0E0E6},
+    {"purple", 0x800080},
+    {"red", 0xFF0000},
+    {"rosybrown", 0xBC8F8F},
+    {"royalblue", 0x4169E1},
+    {"saddlebrown", 0x8B4513},
+    {"salmon", 0xFA8072},
+    {"sandybrown", 0xF4A460},
+    {"seagreen", 0x2E8B57},
+    {"seashell", 0xFFF5EE},
+    {"sienna", 0xA0522D},
+    {"silver", 0xC0C0C0},
+    {"skyblue", 0x87CEEB},
+    {"slateblue", 0x6A5ACD},
+    {"slategray", 0x708090},
+    {"slategrey", 0x708090},
+    {"snow", 0xFFFAFA},
+    {"springgreen", 0x00FF7F},
+    {"steelblue", 0x4682B4},
+    {"tan", 0xD2B48C},
+    {"teal", 0x008080},
+    {"thistle", 0xD8BFD8},
+    {"tomato", 0xFF6347},
+    {"turquoise", 0x40E0D0},
+    {"violet", 0xEE82EE},
+    {"wheat", 0xF5DEB3},
+    {"white", 0xFFFFFF},
+    {"whitesmoke", 0xF5F5F5},
+    {"yellow", 0xFFFF00},
+    {"yellowgreen", 0x9ACD32},
+};
+
+static color_cache_entry_t color_cache[COLOR_CACHE_SIZE];  //!< cache for ColorFromArgs()
+static uint32_t color_cache_hits = 0;                      //!< number of cache hits
+static uint32_t color_cache_misses = 0;                    //!< number of cache misses
+
 /*********************
 ** static functions **
 *********************/
@@ -85,6 +287,576 @@ static void f_GetBlue(js_State *J) { js_pushnumber(J, getb(js_toint32(J, 1))); }
  */
 static void f_GetAlpha(js_State *J) { js_pushnumber(J, geta(js_toint32(J, 1))); }
 
+/**
+ * @brief compare function for bsearch() in color_names.
+ */
+static int color_compareName(const void *a, const void *b) { return strcmp(((const color_name_t *)a)->name, ((const color_name_t *)b)->name); }
+
+/**
+ * @brief parse a number from a color string.
+ *
+ * @param s pointer to the current position, advanced past the number.
+ * @param kind 'i' for an integer with up to three digits, 'd' for a decimal number, 'p' for a decimal number followed by '%'.
+ * @param out the number is stored here.
+ *
+ * @return true if a number of the given kind was found.
+ */
+static bool color_parseNumber(const char **s, char kind, double *out) {
+    const char *p = *s;
+    int digits = 0;
+    while (isdigit((unsigned char)p[digits])) {
+        digits++;
+    }
+    if (kind == 'i') {
+        if (digits < 1 || digits > 3) {
+            return false;
+        }
+        *out = strtol(p, NULL, 10);
+        *s = p + digits;
+        return true;
+    }
+
+    // decimal: 129.6, 79, .9
+    const char *end = p + digits;
+    if (*end == '.') {
+        int frac = 0;
+        while (isdigit((unsigned char)end[1 + frac])) {
+            frac++;
+        }
+        if (frac) {
+            end += 1 + frac;
+        } else if (!digits) {
+            return false;
+        }
+    } else if (!digits) {
+        return false;
+    }
+    *out = strtod(p, NULL);
+    if (kind == 'p') {
+        if (*end != '%') {
+            return false;
+        }
+        end++;
+    }
+    *s = end;
+    return true;
+}
+
+/**
+ * @brief match a functional color string like 'rgba(R, G, B, A)'.
+ *
+ * @param s the (trimmed, lower case) color string.
+ * @param prefix function name including the opening bracket.
+ * @param fmt one character for each component, see color_parseNumber().
+ * @param out the components are stored here.
+ *
+ * @return true if the string matched.
+ */
+static bool color_parseFunction(const char *s, const char *prefix, const char *fmt, double *out) {
+    size_t plen = strlen(prefix);
+    if (strncmp(s, prefix, plen) != 0) {
+        return false;
+    }
+    s += plen;
+    for (int i = 0; fmt[i]; i++) {
+        while (isspace((unsigned char)*s)) {
+            s++;
+        }
+        if (!color_parseNumber(&s, fmt[i], &out[i])) {
+            return false;
+        }
+        while (isspace((unsigned char)*s)) {
+            s++;
+        }
+        if (*s != (fmt[i + 1] ? ',' : ')')) {
+            return false;
+        }
+        s++;
+    }
+    return *s == 0;
+}
+
+/**
+ * @brief match a hex color string: #rgb, #rgba, #rrggbb or #rrggbbaa.
+ *
+ * @param s the (trimmed, lower case) color string.
+ * @param out the normalized components are stored here.
+ *
+ * @return true if the string matched.
+ */
+static bool color_parseHex(const char *s, double *out) {
+    if (*s++ != '#') {
+        return false;
+    }
+    size_t len = strlen(s);
+    for (size_t i = 0; i < len; i++) {
+        if (!isxdigit((unsigned char)s[i])) {
+            return false;
+        }
+    }
+
+    char tmp[3] = {0};
+    switch (len) {
+        case 3:
+        case 4:
+            for (size_t i = 0; i < len; i++) {
+                tmp[0] = tmp[1] = s[i];
+                out[i] = strtol(tmp, NULL, 16) / 255.0;
+            }
+            break;
+        case 6:
+        case 8:
+            for (size_t i = 0; i < len / 2; i++) {
+                tmp[0] = s[i * 2];
+                tmp[1] = s[i * 2 + 1];
+                out[i] = strtol(tmp, NULL, 16) / 255.0;
+            }
+            break;
+        default:
+            return false;
+    }
+    if (len == 3 || len == 6) {
+        out[3] = 1;
+    }
+    return true;
+}
+
+/**
+ * @brief project hue/zest/value onto a RGB component, see ColorConversion._hslaToRGBA() in p5color.js.
+ */
+static double color_hzvToRGB(double hue, double zest, double val) {
+    if (hue < 0) {
+        hue += 6;
+    } else if (hue >= 6) {
+        hue -= 6;
+    }
+    if (hue < 1) {
+        return zest + (val - zest) * hue;
+    } else if (hue < 3) {
+        return val;
+    } else if (hue < 4) {
+        return zest + (val - zest) * (4 - hue);
+    } else {
+        return zest;
+    }
+}
+
+/**
+ * @brief convert normalized HSLA to RGBA in place.
+ *
+ * @param c the color components.
+ */
+static void color_hslaToRGBA(double *c) {
+    double hue = c[0] * 6;
+    double sat = c[1];
+    double li = c[2];
+
+    if (sat == 0) {
+        c[0] = c[1] = c[2] = li;
+    } else {
+        double val;
+        if (li < 0.5) {
+            val = (1 + sat) * li;
+        } else {
+            val = li + sat - li * sat;
+        }
+        double zest = 2 * li - val;
+
+        c[0] = color_hzvToRGB(hue + 2, zest, val);
+        c[1] = color_hzvToRGB(hue, zest, val);
+        c[2] = color_hzvToRGB(hue - 2, zest, val);
+    }
+}
+
+/**
+ * @brief convert normalized HSBA to RGBA in place.
+ *
+ * @param c the color components.
+ */
+static void color_hsbaToRGBA(double *c) {
+    double hue = c[0] * 6;
+    double sat = c[1];
+    double val = c[2];
+
+    if (sat == 0) {
+        c[0] = c[1] = c[2] = val;
+    } else {
+        int sector = floor(hue);
+        double tint1 = val * (1 - sat);
+        double tint2 = val * (1 - sat * (hue - sector));
+        double tint3 = val * (1 - sat * (1 + sector - hue));
+        switch (sector) {
+            case 1:  // Yellow to green.
+                c[0] = tint2;
+                c[1] = val;
+                c[2] = tint1;
+                break;
+            case 2:  // Green to cyan.
+                c[0] = tint1;
+                c[1] = val;
+                c[2] = tint3;
+                break;
+            case 3:  // Cyan to blue.
+                c[0] = tint1;
+                c[1] = tint2;
+                c[2] = val;
+                break;
+            case 4:  // Blue to magenta.
+                c[0] = tint3;
+                c[1] = tint1;
+                c[2] = val;
+                break;
+            case 5:  // Magenta to red.
+                c[0] = val;
+                c[1] = tint1;
+                c[2] = tint2;
+                break;
+            default:  // Red to yellow (sector could be 0 or 6).
+                c[0] = val;
+                c[1] = tint3;
+                c[2] = tint1;
+                break;
+        }
+    }
+}
+
+/**
+ * @brief clamp all components to [0..1].
+ *
+ * @param c the color components.
+ */
+static void color_clamp(double *c) {
+    for (int i = 0; i < 4; i++) {
+        if (c[i] < 0) {
+            c[i] = 0;
+        } else if (c[i] > 1) {
+            c[i] = 1;
+        }
+    }
+}
+
+/**
+ * @brief parse a CSS color string (named, hex, rgb(a), hsl(a) and hsb(a)). Unknown strings result in white.
+ *
+ * @param str the color string.
+ * @param out normalized RGBA components.
+ */
+static void color_parseString(const char *str, double *out) {
+    char buf[COLOR_STR_MAX + 1];
+
+    // trim and convert to lower case
+    while (isspace((unsigned char)*str)) {
+        str++;
+    }
+    size_t len = strlen(str);
+    while (len && isspace((unsigned char)str[len - 1])) {
+        len--;
+    }
+    if (len > COLOR_STR_MAX) {
+        len = 0;
+    }
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = tolower((unsigned char)str[i]);
+    }
+    buf[len] = 0;
+
+    // named colors
+    color_name_t search = {buf, 0};
+    color_name_t *named = bsearch(&search, color_names, sizeof(color_names) / sizeof(color_names[0]), sizeof(color_names[0]), color_compareName);
+    if (named) {
+        out[0] = ((named->rgb >> 16) & 0xFF) / 255.0;
+        out[1] = ((named->rgb >> 8) & 0xFF) / 255.0;
+        out[2] = (named->rgb & 0xFF) / 255.0;
+        out[3] = 1;
+        return;
+    }
+
+    // RGBA patterns
+    if (color_parseHex(buf, out)) {
+        return;
+    }
+    if (color_parseFunction(buf, "rgb(", "iii", out)) {
+        out[0] /= 255;
+        out[1] /= 255;
+        out[2] /= 255;
+        out[3] = 1;
+        return;
+    }
+    if (color_parseFunction(buf, "rgb(", "ppp", out)) {
+        out[0] /= 100;
+        out[1] /= 100;
+        out[2] /= 100;
+        out[3] = 1;
+        return;
+    }
+    if (color_parseFunction(buf, "rgba(", "iiid", out)) {
+        out[0] /= 255;
+        out[1] /= 255;
+        out[2] /= 255;
+        return;
+    }
+    if (color_parseFunction(buf, "rgba(", "pppd", out)) {
+        out[0] /= 100;
+        out[1] /= 100;
+        out[2] /= 100;
+        return;
+    }
+
+    // HSLA/HSBA patterns, percentages are truncated to integers like parseInt() does
+    bool hsl = false, hsb = false;
+    if (color_parseFunction(buf, "hsl(", "ipp", out)) {
+        out[3] = 1;
+        hsl = true;
+    } else if (color_parseFunction(buf, "hsla(", "ippd", out)) {
+        hsl = true;
+    } else if (color_parseFunction(buf, "hsb(", "ipp", out)) {
+        out[3] = 1;
+        hsb = true;
+    } else if (color_parseFunction(buf, "hsba(", "ippd", out)) {
+        hsb = true;
+    }
+    if (hsl || hsb) {
+        out[0] /= 360;
+        out[1] = floor(out[1]) / 100;
+        out[2] = floor(out[2]) / 100;
+        color_clamp(out);
+        if (hsl) {
+            color_hslaToRGBA(out);
+        } else {
+            color_hsbaToRGBA(out);
+        }
+        return;
+    }
+
+    // Input did not match any CSS color pattern: default to white.
+    out[0] = out[1] = out[2] = out[3] = 1;
+}
+
+/**
+ * @brief extract color arguments from the JS stack. The argument values are left on the stack so color strings stay valid.
+ * The parameters are expected as (mode:string, maxes:number[], args:any[]).
+ *
+ * @param J VM state.
+ * @param ca the extracted arguments are stored here.
+ */
+static void color_getArgs(js_State *J, color_args_t *ca) {
+    const char *mode = js_tostring(J, 1);
+    if (strcmp(mode, "rgb") == 0) {
+        ca->mode = COLOR_MODE_RGB;
+    } else if (strcmp(mode, "hsb") == 0) {
+        ca->mode = COLOR_MODE_HSB;
+    } else if (strcmp(mode, "hsl") == 0) {
+        ca->mode = COLOR_MODE_HSL;
+    } else {
+        js_error(J, "%s is an invalid colorMode.", mode);
+        return;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        js_getindex(J, 2, i);
+        ca->maxes[i] = js_tonumber(J, -1);
+        js_pop(J, 1);
+    }
+
+    ca->nargs = js_getlength(J, 3);
+    ca->str = NULL;
+    for (int i = 0; i < 4; i++) {
+        js_getindex(J, 3, i);
+        ca->isnum[i] = js_isnumber(J, -1);
+        if (i == 0 && ca->nargs == 1 && js_isstring(J, -1)) {
+            ca->str = js_tostring(J, -1);
+            ca->val[i] = 0;
+        } else {
+            ca->val[i] = i < ca->nargs ? js_tonumber(J, -1) : 0;
+        }
+    }
+}
+
+/**
+ * @brief convert color arguments to normalized RGBA, see p5Color._parseInputs() in p5color.js.
+ *
+ * @param J VM state.
+ * @param ca the arguments.
+ * @param out normalized RGBA components.
+ */
+static void color_normalize(js_State *J, color_args_t *ca, double *out) {
+    if (ca->nargs >= 3) {
+        // Argument is a list of component values.
+        for (int i = 0; i < 3; i++) {
+            out[i] = ca->val[i] / ca->maxes[i];
+        }
+        out[3] = ca->isnum[3] ? ca->val[3] / ca->maxes[3] : 1;
+        color_clamp(out);
+
+        if (ca->mode == COLOR_MODE_HSL) {
+            color_hslaToRGBA(out);
+        } else if (ca->mode == COLOR_MODE_HSB) {
+            color_hsbaToRGBA(out);
+        }
+    } else if (ca->str) {
+        color_parseString(ca->str, out);
+    } else if ((ca->nargs == 1 || ca->nargs == 2) && ca->isnum[0]) {
+        // 'Grayscale' mode, the gray level is normalized according to the blue maximum.
+        out[0] = out[1] = out[2] = ca->val[0] / ca->maxes[2];
+        out[3] = ca->isnum[1] ? ca->val[1] / ca->maxes[3] : 1;
+        color_clamp(out);
+    } else {
+        js_error(J, "Arguments are not a valid color representation.");
+    }
+}
+
+/**
+ * @brief convert normalized RGBA to an Allegro color, see p5Color.toAllegro() in p5color.js.
+ *
+ * @param c normalized RGBA components.
+ *
+ * @return uint32_t the Allegro color.
+ */
+static uint32_t color_toAllegro(double *c) {
+    int l[4];
+    for (int i = 0; i < 4; i++) {
+        double v = c[i] * 255 + 0.5;
+        if (v > 255) {
+            l[i] = 255;
+        } else if (v > 0) {
+            l[i] = (int)v;
+        } else {
+            l[i] = 0;  // negative or NaN
+        }
+    }
+    // alpha can never be 255 because the resulting integer for WHITE would be -1 and that is equal to 'no color'
+    if (l[3] == 255) {
+        l[3] = 254;
+    }
+    return makeacol32(l[0], l[1], l[2], l[3]);
+}
+
+/**
+ * @brief build the cache key for the given arguments.
+ *
+ * @param ca the arguments.
+ * @param key the key is stored here.
+ *
+ * @return int length of the key or 0 if the arguments can't be cached.
+ */
+static int color_makeKey(color_args_t *ca, uint8_t *key) {
+    if (ca->str) {
+        // color strings do not depend on mode or maxes
+        size_t len = strlen(ca->str);
+        if (len + 1 > COLOR_KEY_MAX) {
+            return 0;
+        }
+        key[0] = 's';
+        memcpy(&key[1], ca->str, len);
+        return len + 1;
+    } else {
+        key[0] = 'n';
+        key[1] = ca->mode;
+        key[2] = ca->nargs > 4 ? 4 : ca->nargs;
+        key[3] = ca->isnum[0] | (ca->isnum[1] << 1) | (ca->isnum[2] << 2) | (ca->isnum[3] << 3);
+        memcpy(&key[4], ca->maxes, sizeof(ca->maxes));
+        memcpy(&key[4 + sizeof(ca->maxes)], ca->val, sizeof(ca->val));
+        return 4 + sizeof(ca->maxes) + sizeof(ca->val);
+    }
+}
+
+/**
+ * @brief FNV-1a hash of the key.
+ */
+static uint32_t color_hash(const uint8_t *key, int len) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < len; i++) {
+        h ^= key[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief convert p5js style color arguments to normalized RGBA.
+ * ColorFromArgsRGBA(mode:string, maxes:number[], args:any[]):number[]
+ *
+ * @param J VM state.
+ */
+static void f_ColorFromArgsRGBA(js_State *J) {
+    color_args_t ca;
+    double c[4];
+
+    color_getArgs(J, &ca);
+    color_normalize(J, &ca, c);
+
+    js_newarray(J);
+    for (int i = 0; i < 4; i++) {
+        js_pushnumber(J, c[i]);
+        js_setindex(J, -2, i);
+    }
+}
+
+/**
+ * @brief convert p5js style color arguments to an Allegro color, results are cached.
+ * ColorFromArgs(mode:string, maxes:number[], args:any[]):Color
+ *
+ * @param J VM state.
+ */
+static void f_ColorFromArgs(js_State *J) {
+    color_args_t ca;
+    uint8_t key[COLOR_KEY_MAX];
+
+    color_getArgs(J, &ca);
+
+    int len = color_makeKey(&ca, key);
+    uint32_t hash = 0;
+    color_cache_entry_t *e = NULL;
+    if (len) {
+        hash = color_hash(key, len);
+        e = &color_cache[hash & (COLOR_CACHE_SIZE - 1)];
+        if (e->len == len && e->hash == hash && memcmp(e->key, key, len) == 0) {
+            color_cache_hits++;
+            js_pushnumber(J, e->color);
+            return;
+        }
+    }
+    color_cache_misses++;
+
+    double c[4];
+    color_normalize(J, &ca, c);
+    uint32_t color = color_toAllegro(c);
+
+    // replace whatever was stored in this slot
+    if (e) {
+        e->hash = hash;
+        e->len = len;
+        memcpy(e->key, key, len);
+        e->color = color;
+    }
+    js_pushnumber(J, color);
+}
+
+/**
+ * @brief get color cache statistics.
+ * ColorCacheStats():{"hits":number, "misses":number, "entries":number}
+ *
+ * @param J VM state.
+ */
+static void f_ColorCacheStats(js_State *J) {
+    int entries = 0;
+    for (int i = 0; i < COLOR_CACHE_SIZE; i++) {
+        if (color_cache[i].len) {
+            entries++;
+        }
+    }
+
+    js_newobject(J);
+    {
+        js_pushnumber(J, color_cache_hits);
+        js_setproperty(J, -2, "hits");
+        js_pushnumber(J, color_cache_misses);
+        js_setproperty(J, -2, "misses");
+        js_pushnumber(J, entries);
+        js_setproperty(J, -2, "entries");
+    }
+}
+
 /***********************
 ** exported functions **
 ***********************/
@@ -101,6 +873,12 @@ void init_color(js_State *J) {
     NFUNCDEF(J, GetGreen, 1);
     NFUNCDEF(J, GetBlue, 1);
     NFUNCDEF(J, GetAlpha, 1);
+    NFUNCDEF(J, ColorFromArgs, 3);
+    NFUNCDEF(J, ColorFromArgsRGBA, 3);
+    NFUNCDEF(J, ColorCacheStats, 0);
+
+    memset(color_cache, 0, sizeof(color_cache));
+    color_cache_hits = color_cache_misses = 0;
 
     DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
 }
@@ -30,6 +30,7 @@ SOFTWARE.
 
 #include "DOjS.h"
 #include "color.h"
+#include "textcache.h"
 #include "zipfile.h"
 
 #if LINUX == 1
@@ -47,6 +48,7 @@ SOFTWARE.
 static void Font_Finalize(js_State *J, void *data) {
     FONT *f = (FONT *)data;
     if (f != font) {
+        textcache_forget(f);
         destroy_font(f);
     }
 }
@@ -132,7 +134,7 @@ static void Font_DrawStringLeft(js_State *J) {
     int fg = js_toint32(J, 4);
     int bg = js_toint32(J, 5);
 
-    textout_ex(DOjS.current_bm, f, str, x, y, fg, bg);
+    textcache_draw(DOjS.current_bm, f, str, x, y, fg, bg, TEXT_ALIGN_LEFT);
 }
 
 /**
@@ -151,7 +153,7 @@ static void Font_DrawStringCenter(js_State *J) {
     int fg = js_toint32(J, 4);
     int bg = js_toint32(J, 5);
 
-    textout_centre_ex(DOjS.current_bm, f, str, x, y, fg, bg);
+    textcache_draw(DOjS.current_bm, f, str, x, y, fg, bg, TEXT_ALIGN_CENTER);
 }
 
 /**
@@ -170,7 +172,7 @@ static void Font_DrawStringRight(js_State *J) {
     int fg = js_toint32(J, 4);
     int bg = js_toint32(J, 5);
 
-    textout_right_ex(DOjS.current_bm, f, str, x, y, fg, bg);
+    textcache_draw(DOjS.current_bm, f, str, x, y, fg, bg, TEXT_ALIGN_RIGHT);
 }
 
 /**
@@ -208,6 +210,7 @@ static void f_SetMissingCharacter(js_State *J) {
     const char *missing = js_tostring(J, 1);
     if (strlen(missing) > 0) {
         allegro_404_char = missing[0];
+        textcache_clear();  // cached strings may contain the old character
     }
 }
 
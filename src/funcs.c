@@ -30,6 +30,7 @@ SOFTWARE.
 
 #include "util.h"
 #include "socket.h"
+#include "timing.h"
 #include "zipfile.h"
 #include "jsi.h"
 #include "jsparse.h"
@@ -404,12 +405,19 @@ static void f_MemoryInfo(js_State *J) {
 }
 
 /**
- * @brief sleep for the given number of ms.
+ * @brief sleep for the given number of ms. In headless mode only the virtual clock is advanced.
  * Sleep(ms:number)
  *
  * @param J the JS context.
  */
-static void f_Sleep(js_State *J) { rest_callback(js_toint32(J, 1), tick_socket); }
+static void f_Sleep(js_State *J) {
+    int ms = js_toint32(J, 1);
+    if (DOjS.params.headless) {
+        timing_advance((uint64_t)MAX(ms, 0) * TIMING_NS_PER_MS);
+    } else {
+        rest_callback(ms, tick_socket);
+    }
+}
 
 /**
  * @brief get current time in ms.
@@ -35,6 +35,9 @@ SOFTWARE.
 #include "color.h"
 #include "funcs.h"
 #include "gfx.h"
+#include "intarray.h"
+#include "textcache.h"
+#include "transform.h"
 #include "util.h"
 
 //! used to keep a reference to the bitmap in global context
@@ -110,7 +113,7 @@ static poly_array_t *f_allocArray(int len) {
 }
 
 /**
- * @brief convert JS-array to C array for polygon functions.
+ * @brief convert JS-array to C array for polygon functions. The current transformation is applied to all points.
  *
  * @param J the JS context.
  * @param idx index of th JS-array on the stack.
@@ -138,16 +141,25 @@ static poly_array_t *f_convertArray(js_State *J, int idx) {
                     return NULL;
                 }
 
-                js_getindex(J, -1, 0);
-                int x = js_toint16(J, -1);
-                js_pop(J, 1);
+                if (transform_current.identity) {
+                    js_getindex(J, -1, 0);
+                    array->data[i * 2 + 0] = js_toint16(J, -1);
+                    js_pop(J, 1);
 
-                js_getindex(J, -1, 1);
-                int y = js_toint16(J, -1);
-                js_pop(J, 1);
+                    js_getindex(J, -1, 1);
+                    array->data[i * 2 + 1] = js_toint16(J, -1);
+                    js_pop(J, 1);
+                } else {
+                    js_getindex(J, -1, 0);
+                    double x = js_tonumber(J, -1);
+                    js_pop(J, 1);
 
-                array->data[i * 2 + 0] = x;
-                array->data[i * 2 + 1] = y;
+                    js_getindex(J, -1, 1);
+                    double y = js_tonumber(J, -1);
+                    js_pop(J, 1);
+
+                    transform_point(x, y, &array->data[i * 2 + 0], &array->data[i * 2 + 1]);
+                }
             }
             js_pop(J, 1);
         }
@@ -155,6 +167,108 @@ static poly_array_t *f_convertArray(js_State *J, int idx) {
     }
 }
 
+/**
+ * @brief get the points for a polygon function. The current transformation is applied to all points.
+ * IntArrays with x/y pairs are used directly without copying (if no transformation is active), JS-arrays of [x, y] are converted.
+ *
+ * @param J the JS context.
+ * @param idx index of the points on the stack.
+ * @param tmp a converted array is stored here and must be freed by the caller using f_freeArray(), NULL for IntArrays.
+ * @param len the number of points is stored here.
+ *
+ * @return int* with x/y pairs or NULL on error.
+ */
+static int *f_getPoints(js_State *J, int idx, poly_array_t **tmp, int *len) {
+    *tmp = NULL;
+    if (js_isuserdata(J, idx, TAG_INT_ARRAY)) {
+        int_array_t *ia = js_touserdata(J, idx, TAG_INT_ARRAY);
+        if (ia->size % 2) {
+            js_error(J, "IntArray must contain x/y pairs");
+            return NULL;
+        }
+        *len = ia->size / 2;
+        if (transform_current.identity) {
+            return (int *)ia->data;
+        } else {
+            int *points = transform_points((int *)ia->data, *len);
+            if (!points) {
+                JS_ENOMEM(J);
+            }
+            return points;
+        }
+    } else {
+        *tmp = f_convertArray(J, idx);
+        if (!*tmp) {
+            return NULL;
+        }
+        *len = (*tmp)->len;
+        return (*tmp)->data;
+    }
+}
+
+/**
+ * @brief get an integer from an IntArray or a JS-array.
+ *
+ * @param J the JS context.
+ * @param idx index of the array on the stack.
+ * @param i index in the array.
+ *
+ * @return the value.
+ */
+static int f_getIndexInt(js_State *J, int idx, int i) {
+    if (js_isuserdata(J, idx, TAG_INT_ARRAY)) {
+        int_array_t *ia = js_touserdata(J, idx, TAG_INT_ARRAY);
+        return ia->data[i];
+    } else {
+        js_getindex(J, idx, i);
+        int val = js_toint32(J, -1);
+        js_pop(J, 1);
+        return val;
+    }
+}
+
+/**
+ * @brief get the length of an IntArray or a JS-array.
+ *
+ * @param J the JS context.
+ * @param idx index of the array on the stack.
+ *
+ * @return the length.
+ */
+static int f_getLength(js_State *J, int idx) {
+    if (js_isuserdata(J, idx, TAG_INT_ARRAY)) {
+        int_array_t *ia = js_touserdata(J, idx, TAG_INT_ARRAY);
+        return ia->size;
+    } else if (js_isarray(J, idx)) {
+        return js_getlength(J, idx);
+    } else {
+        JS_ENOARR(J);
+        return 0;
+    }
+}
+
+/**
+ * @brief get the coordinates of a line from the stack and apply the current transformation.
+ *
+ * @param J the JS context.
+ * @param idx index of the first coordinate on the stack.
+ * @param x1 start point.
+ * @param y1 start point.
+ * @param x2 end point.
+ * @param y2 end point.
+ */
+static void f_getLine(js_State *J, int idx, int *x1, int *y1, int *x2, int *y2) {
+    if (transform_current.identity) {
+        *x1 = js_toint16(J, idx + 0);
+        *y1 = js_toint16(J, idx + 1);
+        *x2 = js_toint16(J, idx + 2);
+        *y2 = js_toint16(J, idx + 3);
+    } else {
+        transform_point(js_tonumber(J, idx + 0), js_tonumber(J, idx + 1), x1, y1);
+        transform_point(js_tonumber(J, idx + 2), js_tonumber(J, idx + 3), x2, y2);
+    }
+}
+
 /**
  * @brief get name of screen mode.
  * GetScreenMode():string
@@ -224,8 +338,13 @@ static void f_ClearScreen(js_State *J) {
  * @param J the JS context.
  */
 static void f_Plot(js_State *J) {
-    int x = js_toint16(J, 1);
-    int y = js_toint16(J, 2);
+    int x, y;
+    if (transform_current.identity) {
+        x = js_toint16(J, 1);
+        y = js_toint16(J, 2);
+    } else {
+        transform_point(js_tonumber(J, 1), js_tonumber(J, 2), &x, &y);
+    }
 
     int color = js_toint32(J, 3);
 
@@ -240,10 +359,8 @@ static void f_Plot(js_State *J) {
  * @param J the JS context.
  */
 static void f_Line(js_State *J) {
-    int x1 = js_toint16(J, 1);
-    int y1 = js_toint16(J, 2);
-    int x2 = js_toint16(J, 3);
-    int y2 = js_toint16(J, 4);
+    int x1, y1, x2, y2;
+    f_getLine(J, 1, &x1, &y1, &x2, &y2);
 
     int color = js_toint32(J, 5);
 
@@ -268,10 +385,8 @@ static void f_customPixel(BITMAP *bmp, int x, int y, int d) { circlefill(bmp, x,
  * @param J the JS context.
  */
 static void f_CustomLine(js_State *J) {
-    int x1 = js_toint16(J, 1);
-    int y1 = js_toint16(J, 2);
-    int x2 = js_toint16(J, 3);
-    int y2 = js_toint16(J, 4);
+    int x1, y1, x2, y2;
+    f_getLine(J, 1, &x1, &y1, &x2, &y2);
     int w = js_toint16(J, 5);
 
     int color = js_toint32(J, 6);
@@ -284,6 +399,109 @@ static void f_CustomLine(js_State *J) {
     do_line(DOjS.current_bm, x1, y1, x2, y2, color, f_customPixel);
 }
 
+/**
+ * @brief draw connected lines.
+ *
+ * @param bmp destination BITMAP.
+ * @param points x/y pairs.
+ * @param len number of points.
+ * @param close true to connect the last and the first point.
+ * @param color the color.
+ * @param proc NULL to draw 1px lines, else the function to draw every pixel of the lines with.
+ */
+static void f_drawPolyLine(BITMAP *bmp, int *points, int len, bool close, int color, void (*proc)(BITMAP *, int, int, int)) {
+    for (int i = 0; i < len - 1; i++) {
+        int *p = &points[i * 2];
+        if (proc) {
+            do_line(bmp, p[0], p[1], p[2], p[3], color, proc);
+        } else {
+            line(bmp, p[0], p[1], p[2], p[3], color);
+        }
+    }
+    if (close && len > 2) {
+        int *p = &points[(len - 1) * 2];
+        if (proc) {
+            do_line(bmp, p[0], p[1], points[0], points[1], color, proc);
+        } else {
+            line(bmp, p[0], p[1], points[0], points[1], color);
+        }
+    }
+}
+
+/**
+ * @brief draw connected lines.
+ *
+ * PolyLine([[x1, y1], [..], [xN, yN]] | IntArray, c:Color, close:boolean)
+ *
+ * @param J the JS context.
+ */
+static void f_PolyLine(js_State *J) {
+    poly_array_t *tmp;
+    int len;
+    int *points = f_getPoints(J, 1, &tmp, &len);
+    if (!points) {
+        return;
+    }
+    int color = js_toint32(J, 2);
+    bool close = js_toboolean(J, 3);
+
+    f_drawPolyLine(DOjS.current_bm, points, len, close, color, NULL);
+
+    f_freeArray(tmp);
+}
+
+/**
+ * @brief draw connected lines with variable thinkness.
+ *
+ * CustomPolyLine([[x1, y1], [..], [xN, yN]] | IntArray, w:number, c:Color, close:boolean)
+ *
+ * @param J the JS context.
+ */
+static void f_CustomPolyLine(js_State *J) {
+    poly_array_t *tmp;
+    int len;
+    int *points = f_getPoints(J, 1, &tmp, &len);
+    if (!points) {
+        return;
+    }
+    int w = js_toint16(J, 2);
+    int color = js_toint32(J, 3);
+    bool close = js_toboolean(J, 4);
+
+    if (w % 2) {
+        customRadius = w / 2 + 1;
+    } else {
+        customRadius = w / 2;
+    }
+    f_drawPolyLine(DOjS.current_bm, points, len, close, color, f_customPixel);
+
+    f_freeArray(tmp);
+}
+
+/**
+ * @brief draw many points with the same color.
+ *
+ * PlotPoints([[x1, y1], [..], [xN, yN]] | IntArray, c:Color)
+ *
+ * @param J the JS context.
+ */
+static void f_PlotPoints(js_State *J) {
+    poly_array_t *tmp;
+    int len;
+    int *points = f_getPoints(J, 1, &tmp, &len);
+    if (!points) {
+        return;
+    }
+    int color = js_toint32(J, 2);
+
+    BITMAP *bmp = DOjS.current_bm;
+    for (int i = 0; i < len; i++) {
+        putpixel(bmp, points[i * 2 + 0], points[i * 2 + 1], color);
+    }
+
+    f_freeArray(tmp);
+}
+
 /**
  * @brief draw a box.
  *
@@ -556,21 +774,73 @@ static void f_FloodFill(js_State *J) {
 }
 
 /**
- * @brief draw a polyline.
- * PolyLine([[x1, x2], [..], [xN, yN]], c:Color)
+ * @brief draw a filled polygon.
+ * FilledPolygon([[x1, y1], [..], [xN, yN]] | IntArray, c:Color)
  *
  * @param J the JS context.
  */
 static void f_FilledPolygon(js_State *J) {
-    poly_array_t *array = f_convertArray(J, 1);
-    if (!array) {
+    poly_array_t *tmp;
+    int len;
+    int *points = f_getPoints(J, 1, &tmp, &len);
+    if (!points) {
         return;
     }
     int color = js_toint32(J, 2);
 
-    polygon(DOjS.current_bm, array->len, array->data, color);
+    polygon(DOjS.current_bm, len, points, color);
+
+    f_freeArray(tmp);
+}
+
+/**
+ * @brief draw many filled polygons with one call.
+ * The vertices of all polygons are stored one after the other in 'points', 'counts' holds the number of vertices of every polygon.
+ * FilledPolygons([[x1, y1], [..], [xN, yN]] | IntArray, counts:number[] | IntArray, c:Color | Color[] | IntArray)
+ *
+ * @param J the JS context.
+ */
+static void f_FilledPolygons(js_State *J) {
+    bool single_color = js_isnumber(J, 3);
+    int num_polys = f_getLength(J, 2);
+    if (!single_color && f_getLength(J, 3) < num_polys) {
+        js_error(J, "Not enough colors for %d polygons", num_polys);
+        return;
+    }
+
+    poly_array_t *tmp;
+    int len;
+    int *points = f_getPoints(J, 1, &tmp, &len);
+    if (!points) {
+        return;
+    }
+
+    // check all counts before drawing anything
+    int total = 0;
+    for (int i = 0; i < num_polys; i++) {
+        int count = f_getIndexInt(J, 2, i);
+        if (count < 0 || total + count > len) {
+            f_freeArray(tmp);
+            js_error(J, "Polygon %d exceeds the number of points", i);
+            return;
+        }
+        total += count;
+    }
+
+    int color = single_color ? js_toint32(J, 3) : 0;
+    int *p = points;
+    for (int i = 0; i < num_polys; i++) {
+        int count = f_getIndexInt(J, 2, i);
+        if (!single_color) {
+            color = f_getIndexInt(J, 3, i);
+        }
+        if (count >= 3) {
+            polygon(DOjS.current_bm, count, p, color);
+        }
+        p += count * 2;
+    }
 
-    f_freeArray(array);
+    f_freeArray(tmp);
 }
 
 /**
@@ -588,7 +858,7 @@ static void f_TextXY(js_State *J) {
     int fg = js_toint32(J, 4);
     int bg = js_toint32(J, 5);
 
-    textout_ex(DOjS.current_bm, font, (char *)str, x, y, fg, bg);
+    textcache_draw(DOjS.current_bm, font, str, x, y, fg, bg, TEXT_ALIGN_LEFT);
 }
 
 /**
@@ -685,7 +955,11 @@ static void f_SetRenderBitmap(js_State *J) {
     } else {
         JS_CHECKTYPE(J, 1, TAG_BITMAP);
 
-        BITMAP *bm = js_touserdata(J, 1, TAG_BITMAP);
+        // the Bitmap will be drawn on, make sure it may be modified
+        BITMAP *bm = Bitmap_writable(J, 1);
+        if (!bm) {
+            return;
+        }
         DOjS.current_bm = bm;
 
         // copy reference into global context to stop the object from being garbage collected
@@ -739,6 +1013,9 @@ void init_gfx(js_State *J) {
     NFUNCDEF(J, Plot, 3);
     NFUNCDEF(J, Line, 5);
     NFUNCDEF(J, CustomLine, 6);
+    NFUNCDEF(J, PolyLine, 3);
+    NFUNCDEF(J, CustomPolyLine, 4);
+    NFUNCDEF(J, PlotPoints, 2);
     NFUNCDEF(J, Box, 5);
     NFUNCDEF(J, Circle, 4);
     NFUNCDEF(J, CustomCircle, 5);
@@ -751,6 +1028,7 @@ void init_gfx(js_State *J) {
     NFUNCDEF(J, FilledCircle, 4);
     NFUNCDEF(J, FilledEllipse, 5);
     NFUNCDEF(J, FilledPolygon, 2);
+    NFUNCDEF(J, FilledPolygons, 3);
 
     NFUNCDEF(J, FloodFill, 4);
 
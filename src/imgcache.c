@@ -0,0 +1,376 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "imgcache.h"
+
+#include <allegro.h>
+#include <mujs.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "DOjS.h"
+#include "util.h"
+#include "zipfile.h"
+
+/************
+** defines **
+************/
+#define IMGCACHE_DEFAULT_SIZE (8 * 1024 * 1024)  //!< default memory limit of the image cache
+
+/************
+** structs **
+************/
+//! a decoded image in the cache
+struct __imgcache_entry {
+    struct __imgcache_entry *prev;  //!< previous entry (more recently used)
+    struct __imgcache_entry *next;  //!< next entry (less recently used)
+    char *name;                     //!< file name (including ZIP entry)
+    time_t mtime;                   //!< modification time of the file (or ZIP file)
+    off_t fsize;                    //!< size of the file (or ZIP file)
+    BITMAP *bm;                     //!< the decoded image
+    size_t bytes;                   //!< memory used by the decoded image
+    int refs;                       //!< number of Bitmap objects sharing the decoded image
+    bool stale;                     //!< the file changed, entry is only kept until all references are released
+};
+
+/*********************
+** static variables **
+*********************/
+static imgcache_entry_t *ic_head = NULL;         //!< most recently used entry
+static imgcache_entry_t *ic_tail = NULL;         //!< least recently used entry
+static size_t ic_limit = IMGCACHE_DEFAULT_SIZE;  //!< memory limit in bytes, 0 to disable the cache
+static size_t ic_bytes = 0;                      //!< current memory usage in bytes
+static int ic_entries = 0;                       //!< number of entries
+static unsigned long ic_hits = 0;                //!< cache hits
+static unsigned long ic_misses = 0;              //!< cache misses
+static unsigned long ic_evictions = 0;           //!< number of evicted entries
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief get modification time and size of a file. For ZIP entries the ZIP file is checked.
+ *
+ * @param fname file name, ZIP-files using ZIP_DELIM.
+ * @param mtime modification time.
+ * @param fsize file size.
+ *
+ * @return true if the file could be checked, else false.
+ */
+static bool imgcache_stat(const char *fname, time_t *mtime, off_t *fsize) {
+    struct stat st;
+    int res;
+
+    char *delim = strchr(fname, ZIP_DELIM);
+    if (delim) {
+        size_t len = delim - fname;
+        char *zname = malloc(len + 1);
+        if (!zname) {
+            return false;
+        }
+        strncpy(zname, fname, len);
+        zname[len] = 0;
+        res = stat(zname, &st);
+        free(zname);
+    } else {
+        res = stat(fname, &st);
+    }
+
+    if (res != 0) {
+        return false;
+    }
+    *mtime = st.st_mtime;
+    *fsize = st.st_size;
+    return true;
+}
+
+/**
+ * @brief remove an entry from the LRU list.
+ *
+ * @param e the entry.
+ */
+static void imgcache_unlink(imgcache_entry_t *e) {
+    if (e->prev) {
+        e->prev->next = e->next;
+    } else {
+        ic_head = e->next;
+    }
+    if (e->next) {
+        e->next->prev = e->prev;
+    } else {
+        ic_tail = e->prev;
+    }
+    e->prev = e->next = NULL;
+}
+
+/**
+ * @brief insert an entry at the start of the LRU list.
+ *
+ * @param e the entry.
+ */
+static void imgcache_link(imgcache_entry_t *e) {
+    e->prev = NULL;
+    e->next = ic_head;
+    if (ic_head) {
+        ic_head->prev = e;
+    } else {
+        ic_tail = e;
+    }
+    ic_head = e;
+}
+
+/**
+ * @brief remove an entry from the cache and free all resources.
+ *
+ * @param e the entry.
+ */
+static void imgcache_free(imgcache_entry_t *e) {
+    DEBUGF("%s: %s\n", __PRETTY_FUNCTION__, e->name);
+
+    imgcache_unlink(e);
+    ic_bytes -= e->bytes;
+    ic_entries--;
+    destroy_bitmap(e->bm);
+    free(e->name);
+    free(e);
+}
+
+/**
+ * @brief evict unused entries (least recently used first) until the cache fits its memory limit.
+ */
+static void imgcache_trim(void) {
+    imgcache_entry_t *e = ic_tail;
+    while (e && ic_bytes > ic_limit) {
+        imgcache_entry_t *prev = e->prev;
+        if (e->refs == 0) {
+            imgcache_free(e);
+            ic_evictions++;
+        }
+        e = prev;
+    }
+}
+
+/**
+ * @brief get image cache statistics.
+ * ImageCacheStats():{hits:number, misses:number, evictions:number, entries:number, bytes:number, limit:number}
+ *
+ * @param J the JS context.
+ */
+static void f_ImageCacheStats(js_State *J) {
+    js_newobject(J);
+    {
+        js_pushnumber(J, ic_hits);
+        js_setproperty(J, -2, "hits");
+        js_pushnumber(J, ic_misses);
+        js_setproperty(J, -2, "misses");
+        js_pushnumber(J, ic_evictions);
+        js_setproperty(J, -2, "evictions");
+        js_pushnumber(J, ic_entries);
+        js_setproperty(J, -2, "entries");
+        js_pushnumber(J, ic_bytes);
+        js_setproperty(J, -2, "bytes");
+        js_pushnumber(J, ic_limit);
+        js_setproperty(J, -2, "limit");
+    }
+}
+
+/**
+ * @brief set the memory limit of the image cache.
+ * SetImageCacheSize(bytes:number)
+ *
+ * @param J the JS context.
+ */
+static void f_SetImageCacheSize(js_State *J) {
+    double size = js_tonumber(J, 1);
+    JS_CHECKPOS(J, size);
+
+    ic_limit = size;
+    imgcache_trim();
+}
+
+/**
+ * @brief remove all unused images from the cache and reset the statistics.
+ * ClearImageCache()
+ *
+ * @param J the JS context.
+ */
+static void f_ClearImageCache(js_State *J) {
+    imgcache_clear();
+    ic_hits = ic_misses = ic_evictions = 0;
+}
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief initialize image cache functions.
+ *
+ * @param J VM state.
+ */
+void init_imgcache(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    NFUNCDEF(J, ImageCacheStats, 0);
+    NFUNCDEF(J, SetImageCacheSize, 1);
+    NFUNCDEF(J, ClearImageCache, 0);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
+
+/**
+ * @brief look up a decoded image. On success the caller shares the BITMAP and must call imgcache_release() with the entry when done.
+ *
+ * @param fname file name, ZIP-files using ZIP_DELIM.
+ * @param entry the cache entry is stored here on success.
+ *
+ * @return BITMAP* the shared BITMAP or NULL if the image is not in the cache.
+ */
+BITMAP *imgcache_get(const char *fname, imgcache_entry_t **entry) {
+    time_t mtime;
+    off_t fsize;
+
+    if (ic_limit == 0 || !imgcache_stat(fname, &mtime, &fsize)) {
+        return NULL;
+    }
+
+    for (imgcache_entry_t *e = ic_head; e; e = e->next) {
+        if (!e->stale && strcmp(e->name, fname) == 0) {
+            if (e->mtime != mtime || e->fsize != fsize) {
+                // file changed on disk
+                DEBUGF("%s: %s changed\n", __PRETTY_FUNCTION__, fname);
+                if (e->refs == 0) {
+                    imgcache_free(e);
+                } else {
+                    e->stale = true;
+                }
+                break;
+            }
+
+            // move to front
+            imgcache_unlink(e);
+            imgcache_link(e);
+
+            e->refs++;
+            ic_hits++;
+            *entry = e;
+            return e->bm;
+        }
+    }
+
+    ic_misses++;
+    return NULL;
+}
+
+/**
+ * @brief check if an up-to-date decoded image is in the cache. Does not count as hit or miss and does not change the LRU order.
+ *
+ * @param fname file name, ZIP-files using ZIP_DELIM.
+ *
+ * @return true if imgcache_get() would return the image.
+ */
+bool imgcache_contains(const char *fname) {
+    time_t mtime;
+    off_t fsize;
+
+    if (ic_limit == 0 || !imgcache_stat(fname, &mtime, &fsize)) {
+        return false;
+    }
+
+    for (imgcache_entry_t *e = ic_head; e; e = e->next) {
+        if (!e->stale && strcmp(e->name, fname) == 0) {
+            return e->mtime == mtime && e->fsize == fsize;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief put a freshly decoded image into the cache.
+ *
+ * @param fname file name, ZIP-files using ZIP_DELIM.
+ * @param bm the decoded image.
+ *
+ * @return the cache entry if the cache took ownership of the BITMAP (the caller shares it and must call imgcache_release()),
+ * @return NULL if the image was not cached and the caller still owns it.
+ */
+imgcache_entry_t *imgcache_put(const char *fname, BITMAP *bm) {
+    time_t mtime;
+    off_t fsize;
+    size_t bytes = bm->w * bm->h * ((bitmap_color_depth(bm) + 7) / 8);
+
+    if (bytes > ic_limit || !imgcache_stat(fname, &mtime, &fsize)) {
+        return NULL;
+    }
+
+    imgcache_entry_t *e = calloc(1, sizeof(imgcache_entry_t));
+    if (!e) {
+        return NULL;
+    }
+    e->name = ut_clone_string(fname);
+    if (!e->name) {
+        free(e);
+        return NULL;
+    }
+    e->mtime = mtime;
+    e->fsize = fsize;
+    e->bm = bm;
+    e->bytes = bytes;
+    e->refs = 1;
+
+    imgcache_link(e);
+    ic_bytes += bytes;
+    ic_entries++;
+
+    imgcache_trim();
+    return e;
+}
+
+/**
+ * @brief release a shared BITMAP.
+ *
+ * @param e the cache entry returned by imgcache_get() or imgcache_put().
+ */
+void imgcache_release(imgcache_entry_t *e) {
+    e->refs--;
+    if (e->refs <= 0 && e->stale) {
+        imgcache_free(e);
+    } else {
+        imgcache_trim();
+    }
+}
+
+/**
+ * @brief free all images that are not in use.
+ */
+void imgcache_clear() {
+    imgcache_entry_t *e = ic_head;
+    while (e) {
+        imgcache_entry_t *next = e->next;
+        if (e->refs == 0) {
+            imgcache_free(e);
+        }
+        e = next;
+    }
+}
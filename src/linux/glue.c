@@ -2,13 +2,16 @@
 #include <netdb.h>
 #include <poll.h>
 #include <sys/ioctl.h>
+#include <png.h>
 
 #include "DOjS.h"
 #include "glue.h"
 #include "allegro/internal/aintern.h"
 #include "jpgalleg.h"
 #include "loadpng.h"
+#include "asyncload.h"
 #include "bitmap.h"
+#include "recorder.h"
 #include "qoi.h"
 #include "webp.h"
 #include "sqlite.h"
@@ -21,6 +24,7 @@
 #include "vorbis.h"
 #include "gifanim.h"
 #include "ogl.h"
+#include "al3d.h"
 
 #define FONTMAGIC 0x19590214L
 #define JPEG_BUFFER_SIZE (4096 * 16)  //!< memory allocation increment while loading file data
@@ -48,6 +52,61 @@ static void f_SavePngImage(js_State *J) {
     }
 }
 
+/**
+ * @brief encode a frame for the recorder. Uses the simplified libpng API only, so it can run on a worker thread.
+ *
+ * @param fname the file to write.
+ * @param rgba RGBA pixel data.
+ * @param width width of the image.
+ * @param height height of the image.
+ * @return true if the image was written, else false
+ */
+static bool encode_png(const char *fname, const uint8_t *rgba, int width, int height) {
+    png_image img;
+
+    memset(&img, 0, sizeof(img));
+    img.version = PNG_IMAGE_VERSION;
+    img.width = width;
+    img.height = height;
+    img.format = PNG_FORMAT_RGBA;
+
+    return png_image_write_to_file(&img, fname, 0, rgba, 0, NULL) != 0;
+}
+
+/**
+ * @brief decode PNG data for Bitmap.LoadAsync(). Uses the simplified libpng API only, so it can run on a worker thread.
+ *
+ * @param data the file contents.
+ * @param size size of the file contents.
+ * @param img the decoded image is stored here.
+ * @return true if the image was decoded, else false
+ */
+static bool decode_png(const uint8_t *data, size_t size, asyncload_image_t *img) {
+    png_image png;
+
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_memory(&png, data, size)) {
+        return false;
+    }
+    png.format = PNG_FORMAT_RGBA;
+
+    img->rgba = malloc(PNG_IMAGE_SIZE(png));
+    if (!img->rgba) {
+        png_image_free(&png);
+        return false;
+    }
+    if (!png_image_finish_read(&png, NULL, img->rgba, 0, NULL)) {
+        free(img->rgba);
+        img->rgba = NULL;
+        return false;
+    }
+    img->width = png.width;
+    img->height = png.height;
+    img->free_rgba = free;
+    return true;
+}
+
 /**
  * @brief initialize PNG loading/saving.
  *
@@ -56,6 +115,9 @@ static void f_SavePngImage(js_State *J) {
 void init_png(js_State *J) {
     LOGF("%s\n", __PRETTY_FUNCTION__);
 
+    recorder_register("png", encode_png);
+    asyncload_register("png", decode_png);
+
     NFUNCDEF(J, SavePngImage, 1);
 }
 
@@ -75,9 +137,13 @@ void glue_init(js_State *J) {
     init_vorbis(J);
     init_gifanim(J);
     init_ogl(J);
+    init_al3d(J);
 }
 
-void glue_shutdown() { shutdown_ogl(); }
+void glue_shutdown() {
+    shutdown_ogl();
+    shutdown_al3d();
+}
 
 FONT *load_grx_font_pf(PACKFILE *pack, RGB *pal, void *param) {
     FONT *f;
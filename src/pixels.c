@@ -0,0 +1,327 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "pixels.h"
+
+#include <allegro.h>
+#include <mujs.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DOjS.h"
+#include "bitmap.h"
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief finalize a PixelArray and free resources. The BITMAP belongs to the Bitmap object or the screen.
+ *
+ * @param J VM state.
+ */
+static void PixelArray_Finalize(js_State *J, void *data) {
+    pixel_array_t *pa = (pixel_array_t *)data;
+    if (pa->copy) {
+        free(pa->copy);
+    }
+    free(pa);
+}
+
+/**
+ * @brief convert a property name to an array index.
+ *
+ * @param name the property name.
+ * @param idx the index is stored here.
+ *
+ * @return true if the name is a non negative integer, else false.
+ */
+static bool PixelArray_index(const char *name, int *idx) {
+    int i = 0;
+    int len = 0;
+    while (name[len] >= '0' && name[len] <= '9') {
+        i = i * 10 + (name[len] - '0');
+        len++;
+        if (len > 9) {
+            return false;
+        }
+    }
+    if (len == 0 || name[len]) {
+        return false;
+    }
+    *idx = i;
+    return true;
+}
+
+/**
+ * @brief get a pointer to the 32bit pixel that contains the byte at index i.
+ *
+ * @param pa the PixelArray.
+ * @param i byte index.
+ *
+ * @return uint32_t* pointer to the pixel.
+ */
+static inline uint32_t *PixelArray_pixel(pixel_array_t *pa, int i) {
+    int p = i >> 2;
+    return &((uint32_t *)pa->bm->line[p / pa->bm->w])[p % pa->bm->w];
+}
+
+/**
+ * @brief property getter for 'length' and the array entries.
+ *
+ * @param J VM state.
+ * @param data the PixelArray.
+ * @param name property name.
+ *
+ * @return int 1 if the property was pushed, 0 if the normal property lookup shall be used.
+ */
+static int PixelArray_has(js_State *J, void *data, const char *name) {
+    pixel_array_t *pa = (pixel_array_t *)data;
+    int i;
+
+    if (PixelArray_index(name, &i)) {
+        if (i >= pa->length) {
+            js_pushundefined(J);
+        } else if (pa->copy) {
+            js_pushnumber(J, pa->copy[i]);
+        } else {
+            uint32_t px = *PixelArray_pixel(pa, i);
+            switch (i & 3) {
+                case 0:
+                    js_pushnumber(J, getr32(px));
+                    break;
+                case 1:
+                    js_pushnumber(J, getg32(px));
+                    break;
+                case 2:
+                    js_pushnumber(J, getb32(px));
+                    break;
+                default:
+                    js_pushnumber(J, geta32(px));
+                    break;
+            }
+        }
+        return 1;
+    } else if (strcmp(name, "length") == 0) {
+        js_pushnumber(J, pa->length);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief property setter for the array entries, values are clamped to 0..255. The new value is on top of the stack.
+ *
+ * @param J VM state.
+ * @param data the PixelArray.
+ * @param name property name.
+ *
+ * @return int 1 if the property was handled, 0 if the normal property handling shall be used.
+ */
+static int PixelArray_put(js_State *J, void *data, const char *name) {
+    pixel_array_t *pa = (pixel_array_t *)data;
+    int i;
+
+    if (PixelArray_index(name, &i)) {
+        // writes outside the array are ignored like for typed arrays
+        if (i < pa->length) {
+            double d = js_tonumber(J, -1) + 0.5;
+            uint8_t v = d >= 255 ? 255 : (d > 0 ? (int)d : 0);
+
+            if (pa->copy) {
+                pa->copy[i] = v;
+            } else {
+                uint32_t *px = PixelArray_pixel(pa, i);
+                int c[4] = {getr32(*px), getg32(*px), getb32(*px), geta32(*px)};
+                c[i & 3] = v;
+                *px = makeacol32(c[0], c[1], c[2], c[3]);
+            }
+        }
+        return 1;
+    } else if (strcmp(name, "length") == 0) {
+        return 1;  // read only
+    }
+    return 0;
+}
+
+/**
+ * @brief re-read the RGBA copy for bitmaps that are not 32bpp.
+ *
+ * @param pa the PixelArray.
+ */
+static void PixelArray_refresh(pixel_array_t *pa) {
+    if (pa->copy) {
+        int depth = bitmap_color_depth(pa->bm);
+        uint8_t *d = pa->copy;
+        for (int y = 0; y < pa->bm->h; y++) {
+            for (int x = 0; x < pa->bm->w; x++) {
+                int c = getpixel(pa->bm, x, y);
+                *d++ = getr_depth(depth, c);
+                *d++ = getg_depth(depth, c);
+                *d++ = getb_depth(depth, c);
+                *d++ = 255;
+            }
+        }
+    }
+}
+
+/**
+ * @brief create a PixelArray for a BITMAP. The object remains on the stack.
+ *
+ * @param J VM state.
+ * @param bm the bitmap.
+ */
+static void PixelArray_create(js_State *J, BITMAP *bm) {
+    pixel_array_t *pa = calloc(1, sizeof(pixel_array_t));
+    if (!pa) {
+        JS_ENOMEM(J);
+        return;
+    }
+    pa->bm = bm;
+    pa->length = bm->w * bm->h * 4;
+
+    // 32bpp bitmaps are accessed directly, everything else goes through a RGBA copy
+    if (bitmap_color_depth(bm) != 32) {
+        pa->copy = malloc(pa->length);
+        if (!pa->copy) {
+            free(pa);
+            JS_ENOMEM(J);
+            return;
+        }
+        PixelArray_refresh(pa);
+    }
+
+    js_getregistry(J, TAG_PIXELS);
+    js_newuserdatax(J, TAG_PIXELS, pa, PixelArray_has, PixelArray_put, NULL, PixelArray_Finalize);
+}
+
+/**
+ * @brief finish modification of the pixels. Writes back the RGBA copy (if any) and drops the optimized form of the Bitmap.
+ * px.Update()
+ *
+ * @param J VM state.
+ */
+static void PixelArray_Update(js_State *J) {
+    pixel_array_t *pa = js_touserdata(J, 0, TAG_PIXELS);
+
+    // the Bitmap was modified: drop Bitmap.Optimize() data
+    js_getproperty(J, 0, PIXELS_BITMAP_PROPERTY);
+    if (js_isuserdata(J, -1, TAG_BITMAP)) {
+        pa->bm = Bitmap_writable(J, -1);
+        if (!pa->bm) {
+            return;
+        }
+    }
+    js_pop(J, 1);
+
+    if (pa->copy) {
+        int depth = bitmap_color_depth(pa->bm);
+        uint8_t *s = pa->copy;
+        for (int y = 0; y < pa->bm->h; y++) {
+            for (int x = 0; x < pa->bm->w; x++) {
+                putpixel(pa->bm, x, y, makecol_depth(depth, s[0], s[1], s[2]));
+                s += 4;
+            }
+        }
+    }
+}
+
+/**
+ * @brief get the pixels of a Bitmap as RGBA byte array. 32bpp Bitmaps are accessed without copying.
+ * The same PixelArray is returned on every call.
+ * img.GetPixels():PixelArray
+ *
+ * @param J VM state.
+ */
+static void Bitmap_GetPixels(js_State *J) {
+    BITMAP *bm = Bitmap_writable(J, 0);
+    if (!bm) {
+        return;
+    }
+
+    js_getproperty(J, 0, PIXELS_PROPERTY);
+    if (js_isuserdata(J, -1, TAG_PIXELS)) {
+        pixel_array_t *pa = js_touserdata(J, -1, TAG_PIXELS);
+        pa->bm = bm;
+        PixelArray_refresh(pa);
+        return;
+    }
+    js_pop(J, 1);
+
+    PixelArray_create(J, bm);
+
+    // the PixelArray keeps the Bitmap alive and the Bitmap caches the PixelArray
+    js_copy(J, 0);
+    js_defproperty(J, -2, PIXELS_BITMAP_PROPERTY, JS_DONTENUM);
+    js_copy(J, -1);
+    js_defproperty(J, 0, PIXELS_PROPERTY, JS_DONTENUM);
+}
+
+/**
+ * @brief get the pixels of the screen as RGBA byte array. The same PixelArray is returned on every call.
+ * GetScreenPixels():PixelArray
+ *
+ * @param J VM state.
+ */
+static void f_GetScreenPixels(js_State *J) {
+    js_getregistry(J, PIXELS_SCREEN);
+    if (js_isuserdata(J, -1, TAG_PIXELS)) {
+        pixel_array_t *pa = js_touserdata(J, -1, TAG_PIXELS);
+        pa->bm = DOjS.render_bm;
+        PixelArray_refresh(pa);
+        return;
+    }
+    js_pop(J, 1);
+
+    PixelArray_create(J, DOjS.render_bm);
+    js_copy(J, -1);
+    js_setregistry(J, PIXELS_SCREEN);
+}
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief initialize PixelArray class and add GetPixels() to Bitmap.
+ *
+ * @param J VM state.
+ */
+void init_pixels(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    // instances are only created by Bitmap.GetPixels() and GetScreenPixels()
+    js_newobject(J);
+    {
+        NPROTDEF(J, PixelArray, Update, 0);
+    }
+    js_setregistry(J, TAG_PIXELS);
+
+    js_getregistry(J, TAG_BITMAP);
+    {
+        NPROTDEF(J, Bitmap, GetPixels, 0);
+    }
+    js_pop(J, 1);
+
+    NFUNCDEF(J, GetScreenPixels, 0);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
@@ -0,0 +1,55 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef __PIXELS_H__
+#define __PIXELS_H__
+
+#include <mujs.h>
+#include <stdint.h>
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define TAG_PIXELS "PixelArray"                //!< class name for PixelArray
+#define PIXELS_PROPERTY "___pixels___"         //!< hidden property of a Bitmap holding its PixelArray
+#define PIXELS_BITMAP_PROPERTY "___bitmap___"  //!< hidden property of a PixelArray referencing its Bitmap
+#define PIXELS_SCREEN "___screenpixels___"     //!< registry name of the PixelArray for the screen
+
+/************
+** structs **
+************/
+//! a RGBA byte view on the pixels of a BITMAP
+typedef struct {
+    BITMAP *bm;     //!< the bitmap
+    uint8_t *copy;  //!< RGBA copy for bitmaps that are not 32bpp, NULL if the bitmap memory is accessed directly
+    int length;     //!< number of bytes (width * height * 4)
+} pixel_array_t;
+
+/***********************
+** exported functions **
+***********************/
+extern void init_pixels(js_State *J);
+
+#endif  // __PIXELS_H__
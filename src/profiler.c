@@ -0,0 +1,259 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "profiler.h"
+
+#include <allegro.h>
+#include <errno.h>
+#include <mujs.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "DOjS.h"
+#include "timing.h"
+
+/*********************
+** static variables **
+*********************/
+static profiler_t profiler;  //!< profiler state
+
+//! phase names used for JS objects and the CSV header
+static const char *profiler_names[PROFILE_NUM] = {"gc", "socket", "update", "loop", "input", "blit", "sleep"};
+
+//! overlay colors of the phases as RGB
+static const int profiler_colors[PROFILE_NUM][3] = {
+    {255, 0, 0},      // gc
+    {255, 0, 255},    // socket
+    {0, 255, 255},    // update
+    {255, 255, 0},    // loop
+    {0, 0, 255},      // input
+    {255, 128, 0},    // blit
+    {64, 64, 64},     // sleep
+};
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief get the ring buffer index of a frame.
+ *
+ * @param n frame number, 0 is the oldest frame.
+ *
+ * @return int index into profiler.frames.
+ */
+static int profiler_index(int n) { return (profiler.frame_idx - profiler.frame_count + n + PROFILER_HISTORY) % PROFILER_HISTORY; }
+
+/**
+ * @brief get the recorded phase times of the last frames, oldest first.
+ * GetProfile():{"gc":number, "socket":number, "update":number, "loop":number, "input":number, "blit":number, "sleep":number, "total":number}[]
+ *
+ * @param J the JS context.
+ */
+static void f_GetProfile(js_State *J) {
+    js_newarray(J);
+    for (int n = 0; n < profiler.frame_count; n++) {
+        uint64_t *f = profiler.frames[profiler_index(n)];
+        uint64_t total = 0;
+
+        js_newobject(J);
+        for (int p = 0; p < PROFILE_NUM; p++) {
+            total += f[p];
+            js_pushnumber(J, (double)f[p] / TIMING_NS_PER_MS);
+            js_setproperty(J, -2, profiler_names[p]);
+        }
+        js_pushnumber(J, (double)total / TIMING_NS_PER_MS);
+        js_setproperty(J, -2, "total");
+
+        js_setindex(J, -2, n);
+    }
+}
+
+/**
+ * @brief write the recorded phase times of the last frames to a CSV file, all times are in ms.
+ * SaveProfileCSV(fname:string)
+ *
+ * @param J the JS context.
+ */
+static void f_SaveProfileCSV(js_State *J) {
+    const char *fname = js_tostring(J, 1);
+
+    FILE *f = fopen(fname, "w");
+    if (!f) {
+        js_error(J, "Could not open '%s' for writing: %s", fname, strerror(errno));
+        return;
+    }
+
+    fputs("frame", f);
+    for (int p = 0; p < PROFILE_NUM; p++) {
+        fprintf(f, ",%s", profiler_names[p]);
+    }
+    fputs(",total\n", f);
+
+    for (int n = 0; n < profiler.frame_count; n++) {
+        uint64_t *times = profiler.frames[profiler_index(n)];
+        uint64_t total = 0;
+
+        fprintf(f, "%d", n);
+        for (int p = 0; p < PROFILE_NUM; p++) {
+            total += times[p];
+            fprintf(f, ",%.3f", (double)times[p] / TIMING_NS_PER_MS);
+        }
+        fprintf(f, ",%.3f\n", (double)total / TIMING_NS_PER_MS);
+    }
+
+    if (fclose(f) != 0) {
+        js_error(J, "Could not write '%s': %s", fname, strerror(errno));
+    }
+}
+
+/**
+ * @brief enable/disable the profiler overlay graph. It can also be toggled with F12.
+ * SetProfileOverlay(enable:boolean)
+ *
+ * @param J the JS context.
+ */
+static void f_SetProfileOverlay(js_State *J) { profiler.overlay = js_toboolean(J, 1); }
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief initialize profiler subsystem.
+ *
+ * @param J VM state.
+ */
+void init_profiler(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    memset(&profiler, 0, sizeof(profiler));
+
+    NFUNCDEF(J, GetProfile, 0);
+    NFUNCDEF(J, SaveProfileCSV, 1);
+    NFUNCDEF(J, SetProfileOverlay, 1);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
+
+/**
+ * @brief start profiling, must be called before the first frame.
+ */
+void profiler_start(void) {
+    memset(profiler.current, 0, sizeof(profiler.current));
+    profiler.last = timing_now();
+}
+
+/**
+ * @brief end a phase: the time since the last call is added to the given phase.
+ *
+ * @param phase the phase that just ended.
+ */
+void profiler_mark(profile_phase_t phase) {
+    uint64_t now = timing_now();
+    profiler.current[phase] += now - profiler.last;
+    profiler.last = now;
+}
+
+/**
+ * @brief store the phase times of the current frame in the ring buffer and start a new frame.
+ */
+void profiler_end_frame(void) {
+    memcpy(profiler.frames[profiler.frame_idx], profiler.current, sizeof(profiler.current));
+    memset(profiler.current, 0, sizeof(profiler.current));
+    profiler.frame_idx = (profiler.frame_idx + 1) % PROFILER_HISTORY;
+    if (profiler.frame_count < PROFILER_HISTORY) {
+        profiler.frame_count++;
+    }
+}
+
+/**
+ * @brief switch the overlay graph on/off.
+ */
+void profiler_toggle_overlay(void) { profiler.overlay = !profiler.overlay; }
+
+/**
+ * @brief check if the overlay graph shall be drawn.
+ *
+ * @return true if the overlay is enabled.
+ */
+bool profiler_overlay_enabled(void) { return profiler.overlay; }
+
+/**
+ * @brief draw the phase times of the last frames as stacked bars into the lower left corner of a bitmap.
+ * The line marks the frame time of the wanted frame rate.
+ *
+ * @param bm the bitmap to draw on (usually the screen).
+ */
+void profiler_draw_overlay(BITMAP *bm) {
+    int colors[PROFILE_NUM];
+    int width = MIN(PROFILER_HISTORY, bm->w);
+    int bottom = bm->h - 1;
+    int top = bottom - PROFILER_OVERLAY_HEIGHT - text_height(font) - 2;
+
+    for (int p = 0; p < PROFILE_NUM; p++) {
+        colors[p] = makecol(profiler_colors[p][0], profiler_colors[p][1], profiler_colors[p][2]);
+    }
+
+    // the drawing mode is global and may still be set to the script's transparency mode, the overlay is always drawn opaque
+    solid_mode();
+    acquire_bitmap(bm);
+    rectfill(bm, 0, top, width - 1, bottom, makecol(0, 0, 0));
+
+    // one column per frame, newest frame on the right
+    int first = profiler.frame_count - width;
+    for (int x = 0; x < width; x++) {
+        int n = first + x;
+        if (n < 0) {
+            continue;
+        }
+        uint64_t *times = profiler.frames[profiler_index(n)];
+        int y = bottom;
+        for (int p = 0; p < PROFILE_NUM && y > bottom - PROFILER_OVERLAY_HEIGHT; p++) {
+            int h = times[p] / PROFILER_OVERLAY_NS_PER_PIXEL;
+            if (h > 0) {
+                int y2 = MAX(y - h, bottom - PROFILER_OVERLAY_HEIGHT);
+                vline(bm, x, y, y2 + 1, colors[p]);
+                y = y2;
+            }
+        }
+    }
+
+    // frame time of the wanted frame rate
+    if (DOjS.wanted_frame_rate > 0) {
+        int h = (TIMING_NS_PER_SEC / DOjS.wanted_frame_rate) / PROFILER_OVERLAY_NS_PER_PIXEL;
+        if (h <= PROFILER_OVERLAY_HEIGHT) {
+            hline(bm, 0, bottom - h, width - 1, makecol(255, 255, 255));
+        }
+    }
+
+    // legend, may be wider than the graph so it brings its own background
+    int x = 0;
+    int black = makecol(0, 0, 0);
+    for (int p = 0; p < PROFILE_NUM; p++) {
+        textout_ex(bm, font, profiler_names[p], x, top + 1, colors[p], black);
+        x += text_length(font, profiler_names[p]);
+        textout_ex(bm, font, " ", x, top + 1, black, black);
+        x += text_length(font, " ");
+    }
+    release_bitmap(bm);
+    dojs_update_transparency();
+}
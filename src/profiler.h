@@ -0,0 +1,76 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <allegro.h>
+#include <stdint.h>
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define PROFILER_HISTORY 256                  //!< number of frames kept in the ring buffer
+#define PROFILER_OVERLAY_KEY KEY_F12          //!< key that toggles the overlay graph
+#define PROFILER_OVERLAY_HEIGHT 100           //!< height of the overlay graph in pixels
+#define PROFILER_OVERLAY_NS_PER_PIXEL 500000  //!< vertical scale of the overlay graph (0.5ms per pixel)
+
+/************
+** structs **
+************/
+//! phases of a frame in the order they are executed by the main loop
+typedef enum {
+    PROFILE_GC,      //!< js_gc()
+    PROFILE_SOCKET,  //!< tick_socket()
+    PROFILE_UPDATE,  //!< Update() calls
+    PROFILE_LOOP,    //!< Loop() call
+    PROFILE_INPUT,   //!< input polling and Input() call
+    PROFILE_BLIT,    //!< copying the render bitmap to the screen
+    PROFILE_SLEEP,   //!< waiting for the frame deadline
+    PROFILE_NUM      //!< number of phases
+} profile_phase_t;
+
+//! profiler state
+typedef struct {
+    uint64_t frames[PROFILER_HISTORY][PROFILE_NUM];  //!< ring buffer of phase times
+    uint64_t current[PROFILE_NUM];                   //!< phase times of the running frame
+    uint64_t last;                                   //!< time of the last phase change
+    int frame_idx;                                   //!< next index in the ring buffer
+    int frame_count;                                 //!< number of valid entries in the ring buffer
+    bool overlay;                                    //!< true if the overlay graph is drawn
+} profiler_t;
+
+/***********************
+** exported functions **
+***********************/
+extern void init_profiler(js_State *J);
+extern void profiler_start(void);
+extern void profiler_mark(profile_phase_t phase);
+extern void profiler_end_frame(void);
+extern void profiler_toggle_overlay(void);
+extern bool profiler_overlay_enabled(void);
+extern void profiler_draw_overlay(BITMAP *bm);
+
+#endif  // __PROFILER_H__
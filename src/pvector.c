@@ -0,0 +1,866 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "pvector.h"
+
+#include <math.h>
+#include <mujs.h>
+#include <stdlib.h>
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+//! define a static function on the PVector constructor
+#define PV_STATICDEF(j, n, p)                                               \
+    {                                                                       \
+        js_newcfunction(j, PVector_s##n, "PVector." #n, p);                 \
+        js_defproperty(j, -2, #n, JS_READONLY | JS_DONTENUM | JS_DONTCONF); \
+    }
+
+/*********************
+** static variables **
+*********************/
+static pvector_t *pv_free = NULL;  //!< list of unused vectors
+static bool pv_defining = false;   //!< true while PVector_push() creates the x/y/z properties
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief get a vector from the pool, refill the pool with a new chunk if it runs empty.
+ * The chunks are never given back to the system, freed vectors are reused instead.
+ *
+ * @return pvector_t* a vector or NULL if out of memory.
+ */
+static pvector_t *PVector_alloc(void) {
+    if (!pv_free) {
+        pvector_t *chunk = malloc(sizeof(pvector_t) * PV_CHUNK_SIZE);
+        if (!chunk) {
+            return NULL;
+        }
+        for (int i = 0; i < PV_CHUNK_SIZE; i++) {
+            chunk[i].next = pv_free;
+            pv_free = &chunk[i];
+        }
+    }
+    pvector_t *v = pv_free;
+    pv_free = v->next;
+    v->next = NULL;
+    return v;
+}
+
+/**
+ * @brief finalize a vector and put it back into the pool.
+ *
+ * @param J VM state.
+ */
+static void PVector_Finalize(js_State *J, void *data) {
+    pvector_t *v = (pvector_t *)data;
+    v->next = pv_free;
+    pv_free = v;
+}
+
+/**
+ * @brief get pointer to one of the components by name.
+ *
+ * @param v the vector.
+ * @param name property name.
+ *
+ * @return double* the component or NULL if the name is not x, y or z.
+ */
+static double *PVector_component(pvector_t *v, const char *name) {
+    if (name[0] && !name[1]) {
+        switch (name[0]) {
+            case 'x':
+                return &v->x;
+            case 'y':
+                return &v->y;
+            case 'z':
+                return &v->z;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief property getter for x, y and z.
+ *
+ * @param J VM state.
+ * @param data the vector.
+ * @param name property name.
+ *
+ * @return int 1 if the property was pushed, 0 if the normal property lookup shall be used.
+ */
+static int PVector_has(js_State *J, void *data, const char *name) {
+    double *c = PVector_component((pvector_t *)data, name);
+    if (c) {
+        js_pushnumber(J, *c);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief property setter for x, y and z, the new value is on top of the stack.
+ *
+ * @param J VM state.
+ * @param data the vector.
+ * @param name property name.
+ *
+ * @return int 1 if the property was stored, 0 if the normal property handling shall be used.
+ */
+static int PVector_put(js_State *J, void *data, const char *name) {
+    double *c = PVector_component((pvector_t *)data, name);
+    if (c && !pv_defining) {
+        *c = js_tonumber(J, -1);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief get a number with the same semantics as 'val || 0' in JS.
+ *
+ * @param J VM state.
+ * @param idx stack index.
+ *
+ * @return double the value or 0 for undefined/NaN.
+ */
+static double PVector_number(js_State *J, int idx) {
+    if (!js_isdefined(J, idx)) {
+        return 0;
+    }
+    double d = js_tonumber(J, idx);
+    return isnan(d) ? 0 : d;
+}
+
+/**
+ * @brief get vector components from the parameters. Accepts a PVector, a number[] or up to three numbers.
+ *
+ * @param J VM state.
+ * @param idx stack index of the first parameter.
+ * @param x the x component is stored here.
+ * @param y the y component is stored here.
+ * @param z the z component is stored here.
+ */
+static void PVector_args(js_State *J, int idx, double *x, double *y, double *z) {
+    if (js_isuserdata(J, idx, TAG_PVECTOR)) {
+        pvector_t *v = js_touserdata(J, idx, TAG_PVECTOR);
+        *x = v->x;
+        *y = v->y;
+        *z = v->z;
+    } else if (js_isarray(J, idx)) {
+        js_getindex(J, idx, 0);
+        *x = PVector_number(J, -1);
+        js_getindex(J, idx, 1);
+        *y = PVector_number(J, -1);
+        js_getindex(J, idx, 2);
+        *z = PVector_number(J, -1);
+        js_pop(J, 3);
+    } else {
+        *x = PVector_number(J, idx);
+        *y = PVector_number(J, idx + 1);
+        *z = PVector_number(J, idx + 2);
+    }
+}
+
+/**
+ * @brief print a warning using Println() like the p5 implementation does.
+ *
+ * @param J VM state.
+ * @param fname name of the calling function.
+ * @param msg the warning.
+ */
+static void PVector_warn(js_State *J, const char *fname, const char *msg) {
+    js_getglobal(J, "Println");
+    js_pushnull(J);
+    js_pushstring(J, fname);
+    js_pushstring(J, msg);
+    js_call(J, 2);
+    js_pop(J, 1);
+}
+
+/**
+ * @brief get a finite number parameter for mult()/div(), prints a warning like p5 does if it isn't.
+ *
+ * @param J VM state.
+ * @param idx stack index.
+ * @param fname name of the calling function for the warning.
+ * @param n the number is stored here.
+ *
+ * @return true if a finite number was passed, else false.
+ */
+static bool PVector_factor(js_State *J, int idx, const char *fname, double *n) {
+    if (js_isnumber(J, idx)) {
+        *n = js_tonumber(J, idx);
+        if (isfinite(*n)) {
+            return true;
+        }
+    }
+    PVector_warn(J, fname, "n is undefined or not a finite number");
+    return false;
+}
+
+/**
+ * @brief get the vector at the given index of a JS array. The array keeps the object alive so the pointer stays valid.
+ *
+ * @param J VM state.
+ * @param idx stack index of the array.
+ * @param i array index.
+ *
+ * @return pvector_t* the vector.
+ */
+static pvector_t *PVector_index(js_State *J, int idx, int i) {
+    js_getindex(J, idx, i);
+    pvector_t *v = js_touserdata(J, -1, TAG_PVECTOR);
+    js_pop(J, 1);
+    return v;
+}
+
+/**
+ * @brief limit the magnitude of a vector.
+ *
+ * @param v the vector.
+ * @param max maximum magnitude.
+ */
+static void PVector_doLimit(pvector_t *v, double max) {
+    double mSq = v->x * v->x + v->y * v->y + v->z * v->z;
+    if (mSq > max * max) {
+        double f = max / sqrt(mSq);
+        v->x *= f;
+        v->y *= f;
+        v->z *= f;
+    }
+}
+
+/**
+ * @brief normalize a vector to length 1, zero length vectors are left untouched.
+ *
+ * @param v the vector.
+ */
+static void PVector_doNormalize(pvector_t *v) {
+    double len = sqrt(v->x * v->x + v->y * v->y + v->z * v->z);
+    if (len != 0) {
+        double f = 1 / len;
+        v->x *= f;
+        v->y *= f;
+        v->z *= f;
+    }
+}
+
+/**
+ * @brief get the target vector for a static function. If a target is passed it is used and pushed, else a new vector is created.
+ *
+ * @param J VM state.
+ * @param idx stack index of the optional target.
+ *
+ * @return pvector_t* the target vector, it is on top of the stack.
+ */
+static pvector_t *PVector_target(js_State *J, int idx) {
+    if (js_isuserdata(J, idx, TAG_PVECTOR)) {
+        js_copy(J, idx);
+    } else {
+        PVector_push(J, 0, 0, 0);
+    }
+    return js_touserdata(J, -1, TAG_PVECTOR);
+}
+
+/**
+ * @brief create a vector.
+ * v = new PVector([x:number, y:number, z:number])
+ *
+ * @param J VM state.
+ */
+static void new_PVector(js_State *J) {
+    // no NEW_OBJECT_PREP() here: vectors are created in large numbers and come from the pool, a GC per vector would dominate the runtime.
+    PVector_push(J, PVector_number(J, 1), PVector_number(J, 2), PVector_number(J, 3));
+}
+
+/**
+ * @brief set the components.
+ * v.set(x:number, y:number, z:number):PVector
+ * v.set(v:PVector):PVector
+ * v.set(a:number[]):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_set(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    PVector_args(J, 1, &v->x, &v->y, &v->z);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief get a copy of the vector.
+ * v.copy():PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_copy(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    PVector_push(J, v->x, v->y, v->z);
+}
+
+/**
+ * @brief add to the vector (in place).
+ * v.add(x:number, y:number, z:number):PVector
+ * v.add(v:PVector):PVector
+ * v.add(a:number[]):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_add(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    double x, y, z;
+    PVector_args(J, 1, &x, &y, &z);
+    v->x += x;
+    v->y += y;
+    v->z += z;
+    js_copy(J, 0);
+}
+
+/**
+ * @brief subtract from the vector (in place).
+ * v.sub(x:number, y:number, z:number):PVector
+ * v.sub(v:PVector):PVector
+ * v.sub(a:number[]):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_sub(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    double x, y, z;
+    PVector_args(J, 1, &x, &y, &z);
+    v->x -= x;
+    v->y -= y;
+    v->z -= z;
+    js_copy(J, 0);
+}
+
+/**
+ * @brief multiply the vector with a scalar (in place).
+ * v.mult(n:number):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_mult(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    double n;
+    if (PVector_factor(J, 1, "PVector.prototype.mult:", &n)) {
+        v->x *= n;
+        v->y *= n;
+        v->z *= n;
+    }
+    js_copy(J, 0);
+}
+
+/**
+ * @brief divide the vector by a scalar (in place).
+ * v.div(n:number):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_div(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    double n;
+    if (PVector_factor(J, 1, "PVector.prototype.div:", &n)) {
+        if (n == 0) {
+            PVector_warn(J, "PVector.prototype.div:", "divide by 0");
+        } else {
+            v->x /= n;
+            v->y /= n;
+            v->z /= n;
+        }
+    }
+    js_copy(J, 0);
+}
+
+/**
+ * @brief get the magnitude of the vector.
+ * v.mag():number
+ *
+ * @param J VM state.
+ */
+static void PVector_mag(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    js_pushnumber(J, sqrt(v->x * v->x + v->y * v->y + v->z * v->z));
+}
+
+/**
+ * @brief get the squared magnitude of the vector.
+ * v.magSq():number
+ *
+ * @param J VM state.
+ */
+static void PVector_magSq(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    js_pushnumber(J, v->x * v->x + v->y * v->y + v->z * v->z);
+}
+
+/**
+ * @brief calculate the dot product.
+ * v.dot(x:number, y:number, z:number):number
+ * v.dot(v:PVector):number
+ *
+ * @param J VM state.
+ */
+static void PVector_dot(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    double x, y, z;
+    PVector_args(J, 1, &x, &y, &z);
+    js_pushnumber(J, v->x * x + v->y * y + v->z * z);
+}
+
+/**
+ * @brief calculate the cross product.
+ * v.cross(v:PVector):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_cross(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    pvector_t *o = js_touserdata(J, 1, TAG_PVECTOR);
+    PVector_push(J, v->y * o->z - v->z * o->y, v->z * o->x - v->x * o->z, v->x * o->y - v->y * o->x);
+}
+
+/**
+ * @brief calculate the euclidean distance to another vector.
+ * v.dist(v:PVector):number
+ *
+ * @param J VM state.
+ */
+static void PVector_dist(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    pvector_t *o = js_touserdata(J, 1, TAG_PVECTOR);
+    double dx = o->x - v->x;
+    double dy = o->y - v->y;
+    double dz = o->z - v->z;
+    js_pushnumber(J, sqrt(dx * dx + dy * dy + dz * dz));
+}
+
+/**
+ * @brief normalize the vector to length 1 (in place).
+ * v.normalize():PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_normalize(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    PVector_doNormalize(v);
+    js_copy(J, 0);
+}
+
+/**
+ * @brief limit the magnitude of the vector (in place).
+ * v.limit(max:number):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_limit(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    PVector_doLimit(v, js_tonumber(J, 1));
+    js_copy(J, 0);
+}
+
+/**
+ * @brief set the magnitude of the vector (in place).
+ * v.setMag(len:number):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_setMag(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    double n;
+    PVector_doNormalize(v);
+    if (PVector_factor(J, 1, "PVector.prototype.mult:", &n)) {
+        v->x *= n;
+        v->y *= n;
+        v->z *= n;
+    }
+    js_copy(J, 0);
+}
+
+/**
+ * @brief linear interpolate the vector to another vector (in place).
+ * v.lerp(x:number, y:number, z:number, amt:number):PVector
+ * v.lerp(v:PVector, amt:number):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_lerp(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    double x, y, z, amt;
+    PVector_args(J, 1, &x, &y, &z);
+    if (js_isuserdata(J, 1, TAG_PVECTOR)) {
+        amt = js_tonumber(J, 2);
+    } else {
+        amt = js_tonumber(J, 4);
+    }
+    double dx = (x - v->x) * amt;
+    double dy = (y - v->y) * amt;
+    double dz = (z - v->z) * amt;
+    v->x += isnan(dx) ? 0 : dx;
+    v->y += isnan(dy) ? 0 : dy;
+    v->z += isnan(dz) ? 0 : dz;
+    js_copy(J, 0);
+}
+
+/**
+ * @brief compare the vector.
+ * v.equals(x:number, y:number, z:number):boolean
+ * v.equals(v:PVector):boolean
+ * v.equals(a:number[]):boolean
+ *
+ * @param J VM state.
+ */
+static void PVector_equals(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    double x, y, z;
+    PVector_args(J, 1, &x, &y, &z);
+    js_pushboolean(J, v->x == x && v->y == y && v->z == z);
+}
+
+/**
+ * @brief get the components as array.
+ * v.array():number[]
+ *
+ * @param J VM state.
+ */
+static void PVector_array(js_State *J) {
+    pvector_t *v = js_touserdata(J, 0, TAG_PVECTOR);
+    js_newarray(J);
+    js_pushnumber(J, v->x);
+    js_setindex(J, -2, 0);
+    js_pushnumber(J, v->y);
+    js_setindex(J, -2, 1);
+    js_pushnumber(J, v->z);
+    js_setindex(J, -2, 2);
+}
+
+/**
+ * @brief add two vectors.
+ * PVector.add(v1:PVector, v2:PVector[, target:PVector]):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_sadd(js_State *J) {
+    pvector_t *v1 = js_touserdata(J, 1, TAG_PVECTOR);
+    double x, y, z;
+    PVector_args(J, 2, &x, &y, &z);
+    x += v1->x;
+    y += v1->y;
+    z += v1->z;
+    pvector_t *t = PVector_target(J, 3);
+    t->x = x;
+    t->y = y;
+    t->z = z;
+}
+
+/**
+ * @brief subtract two vectors.
+ * PVector.sub(v1:PVector, v2:PVector[, target:PVector]):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_ssub(js_State *J) {
+    pvector_t *v1 = js_touserdata(J, 1, TAG_PVECTOR);
+    double x, y, z;
+    PVector_args(J, 2, &x, &y, &z);
+    x = v1->x - x;
+    y = v1->y - y;
+    z = v1->z - z;
+    pvector_t *t = PVector_target(J, 3);
+    t->x = x;
+    t->y = y;
+    t->z = z;
+}
+
+/**
+ * @brief multiply a vector with a scalar.
+ * PVector.mult(v:PVector, n:number[, target:PVector]):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_smult(js_State *J) {
+    pvector_t *v = js_touserdata(J, 1, TAG_PVECTOR);
+    double x = v->x, y = v->y, z = v->z, n;
+    if (PVector_factor(J, 2, "PVector.prototype.mult:", &n)) {
+        x *= n;
+        y *= n;
+        z *= n;
+    }
+    pvector_t *t = PVector_target(J, 3);
+    t->x = x;
+    t->y = y;
+    t->z = z;
+}
+
+/**
+ * @brief divide a vector by a scalar.
+ * PVector.div(v:PVector, n:number[, target:PVector]):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_sdiv(js_State *J) {
+    pvector_t *v = js_touserdata(J, 1, TAG_PVECTOR);
+    double x = v->x, y = v->y, z = v->z, n;
+    if (PVector_factor(J, 2, "PVector.prototype.div:", &n)) {
+        if (n == 0) {
+            PVector_warn(J, "PVector.prototype.div:", "divide by 0");
+        } else {
+            x /= n;
+            y /= n;
+            z /= n;
+        }
+    }
+    pvector_t *t = PVector_target(J, 3);
+    t->x = x;
+    t->y = y;
+    t->z = z;
+}
+
+/**
+ * @brief calculate the dot product of two vectors.
+ * PVector.dot(v1:PVector, v2:PVector):number
+ *
+ * @param J VM state.
+ */
+static void PVector_sdot(js_State *J) {
+    pvector_t *v1 = js_touserdata(J, 1, TAG_PVECTOR);
+    pvector_t *v2 = js_touserdata(J, 2, TAG_PVECTOR);
+    js_pushnumber(J, v1->x * v2->x + v1->y * v2->y + v1->z * v2->z);
+}
+
+/**
+ * @brief calculate the euclidean distance between two vectors.
+ * PVector.dist(v1:PVector, v2:PVector):number
+ *
+ * @param J VM state.
+ */
+static void PVector_sdist(js_State *J) {
+    pvector_t *v1 = js_touserdata(J, 1, TAG_PVECTOR);
+    pvector_t *v2 = js_touserdata(J, 2, TAG_PVECTOR);
+    double dx = v2->x - v1->x;
+    double dy = v2->y - v1->y;
+    double dz = v2->z - v1->z;
+    js_pushnumber(J, sqrt(dx * dx + dy * dy + dz * dz));
+}
+
+/**
+ * @brief get the magnitude of a vector.
+ * PVector.mag(v:PVector):number
+ *
+ * @param J VM state.
+ */
+static void PVector_smag(js_State *J) {
+    pvector_t *v = js_touserdata(J, 1, TAG_PVECTOR);
+    js_pushnumber(J, sqrt(v->x * v->x + v->y * v->y + v->z * v->z));
+}
+
+/**
+ * @brief create a 2D vector from an angle.
+ * PVector.fromAngle(angle:number[, length:number]):PVector
+ *
+ * @param J VM state.
+ */
+static void PVector_sfromAngle(js_State *J) {
+    double angle = js_tonumber(J, 1);
+    double len = js_isdefined(J, 2) ? js_tonumber(J, 2) : 1;
+    PVector_push(J, len * cos(angle), len * sin(angle), 0);
+}
+
+/**
+ * @brief add vectors to all vectors of an array (in place).
+ * If a PVector/number[] is passed it is added to all entries, if a PVector[] is passed the entries are added pairwise.
+ * PVector.addArray(vs:PVector[], v:PVector|number[]|PVector[])
+ *
+ * @param J VM state.
+ */
+static void PVector_saddArray(js_State *J) {
+    if (!js_isarray(J, 1)) {
+        JS_ENOARR(J);
+        return;
+    }
+    int len = js_getlength(J, 1);
+
+    if (js_isarray(J, 2) && js_getlength(J, 2) > 0) {
+        js_getindex(J, 2, 0);
+        bool pairwise = js_isuserdata(J, -1, TAG_PVECTOR);
+        js_pop(J, 1);
+
+        if (pairwise) {
+            int len2 = js_getlength(J, 2);
+            if (len2 < len) {
+                len = len2;
+            }
+            for (int i = 0; i < len; i++) {
+                pvector_t *v = PVector_index(J, 1, i);
+                pvector_t *o = PVector_index(J, 2, i);
+                v->x += o->x;
+                v->y += o->y;
+                v->z += o->z;
+            }
+            return;
+        }
+    }
+
+    double x, y, z;
+    PVector_args(J, 2, &x, &y, &z);
+    for (int i = 0; i < len; i++) {
+        pvector_t *v = PVector_index(J, 1, i);
+        v->x += x;
+        v->y += y;
+        v->z += z;
+    }
+}
+
+/**
+ * @brief multiply all vectors of an array with a scalar (in place).
+ * PVector.multArray(vs:PVector[], n:number)
+ *
+ * @param J VM state.
+ */
+static void PVector_smultArray(js_State *J) {
+    if (!js_isarray(J, 1)) {
+        JS_ENOARR(J);
+        return;
+    }
+    double n;
+    if (!PVector_factor(J, 2, "PVector.multArray:", &n)) {
+        return;
+    }
+    int len = js_getlength(J, 1);
+    for (int i = 0; i < len; i++) {
+        pvector_t *v = PVector_index(J, 1, i);
+        v->x *= n;
+        v->y *= n;
+        v->z *= n;
+    }
+}
+
+/**
+ * @brief limit the magnitude of all vectors of an array (in place).
+ * PVector.limitArray(vs:PVector[], max:number)
+ *
+ * @param J VM state.
+ */
+static void PVector_slimitArray(js_State *J) {
+    if (!js_isarray(J, 1)) {
+        JS_ENOARR(J);
+        return;
+    }
+    double max = js_tonumber(J, 2);
+    int len = js_getlength(J, 1);
+    for (int i = 0; i < len; i++) {
+        PVector_doLimit(PVector_index(J, 1, i), max);
+    }
+}
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief create a new vector. The object remains on the stack.
+ *
+ * @param J VM state.
+ * @param x x component.
+ * @param y y component.
+ * @param z z component.
+ */
+void PVector_push(js_State *J, double x, double y, double z) {
+    pvector_t *v = PVector_alloc();
+    if (!v) {
+        JS_ENOMEM(J);
+        return;
+    }
+    v->x = x;
+    v->y = y;
+    v->z = z;
+
+    js_getregistry(J, TAG_PVECTOR);
+    js_newuserdatax(J, TAG_PVECTOR, v, PVector_has, PVector_put, NULL, PVector_Finalize);
+
+    // placeholders so x/y/z are enumerated by for..in and JSON.stringify(), the values are always served by the hooks
+    pv_defining = true;
+    js_pushundefined(J);
+    js_defproperty(J, -2, "x", JS_DONTCONF);
+    js_pushundefined(J);
+    js_defproperty(J, -2, "y", JS_DONTCONF);
+    js_pushundefined(J);
+    js_defproperty(J, -2, "z", JS_DONTCONF);
+    pv_defining = false;
+}
+
+/**
+ * @brief initialize PVector class.
+ *
+ * @param J VM state.
+ */
+void init_pvector(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    // the same prototype is used by the constructor and PVector_push() so instanceof works for all vectors
+    js_newobject(J);
+    {
+        NPROTDEF(J, PVector, set, 3);
+        NPROTDEF(J, PVector, copy, 0);
+        NPROTDEF(J, PVector, add, 3);
+        NPROTDEF(J, PVector, sub, 3);
+        NPROTDEF(J, PVector, mult, 1);
+        NPROTDEF(J, PVector, div, 1);
+        NPROTDEF(J, PVector, mag, 0);
+        NPROTDEF(J, PVector, magSq, 0);
+        NPROTDEF(J, PVector, dot, 3);
+        NPROTDEF(J, PVector, cross, 1);
+        NPROTDEF(J, PVector, dist, 1);
+        NPROTDEF(J, PVector, normalize, 0);
+        NPROTDEF(J, PVector, limit, 1);
+        NPROTDEF(J, PVector, setMag, 1);
+        NPROTDEF(J, PVector, lerp, 4);
+        NPROTDEF(J, PVector, equals, 3);
+        NPROTDEF(J, PVector, array, 0);
+    }
+    js_copy(J, -1);
+    js_setregistry(J, TAG_PVECTOR);
+    CTORDEF(J, new_PVector, TAG_PVECTOR, 3);
+
+    js_getglobal(J, TAG_PVECTOR);
+    {
+        PV_STATICDEF(J, add, 3);
+        PV_STATICDEF(J, sub, 3);
+        PV_STATICDEF(J, mult, 3);
+        PV_STATICDEF(J, div, 3);
+        PV_STATICDEF(J, dot, 2);
+        PV_STATICDEF(J, dist, 2);
+        PV_STATICDEF(J, mag, 1);
+        PV_STATICDEF(J, fromAngle, 2);
+        PV_STATICDEF(J, addArray, 2);
+        PV_STATICDEF(J, multArray, 2);
+        PV_STATICDEF(J, limitArray, 2);
+    }
+    js_pop(J, 1);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
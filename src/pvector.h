@@ -0,0 +1,53 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef __PVECTOR_H__
+#define __PVECTOR_H__
+
+#include <mujs.h>
+
+/************
+** defines **
+************/
+#define TAG_PVECTOR "PVector"  //!< class name for PVector()
+
+#define PV_CHUNK_SIZE 256  //!< number of vectors allocated at once when the pool runs empty
+
+/************
+** structs **
+************/
+//! a three dimensional vector, unused entries are chained into the free list of the pool
+typedef struct pvector {
+    double x;              //!< x component
+    double y;              //!< y component
+    double z;              //!< z component
+    struct pvector *next;  //!< next free entry while in the pool
+} pvector_t;
+
+/***********************
+** exported functions **
+***********************/
+extern void init_pvector(js_State *J);
+extern void PVector_push(js_State *J, double x, double y, double z);
+
+#endif  // __PVECTOR_H__
@@ -0,0 +1,469 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "recorder.h"
+
+#include <allegro.h>
+#include <mujs.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if LINUX == 1
+#include <pthread.h>
+#endif
+
+#include "DOjS.h"
+#include "timing.h"
+#include "util.h"
+
+/************
+** structs **
+************/
+//! state of a frame slot
+typedef enum {
+    SLOT_FREE,     //!< available for the next frame
+    SLOT_COPYING,  //!< the main thread copies a frame into the slot
+    SLOT_FILLED,   //!< waiting for an encoder thread
+    SLOT_ENCODING  //!< an encoder thread writes the frame
+} recorder_slot_state_t;
+
+//! a preallocated frame
+typedef struct {
+    BITMAP *bm;                   //!< 32bpp copy of the frame, converted to RGBA in place before encoding
+    unsigned long frame;          //!< frame number used for the file name
+    recorder_slot_state_t state;  //!< current state
+} recorder_slot_t;
+
+//! a registered encoder
+typedef struct {
+    char ext[RECORDER_EXT_LEN];  //!< file extension (lowercase)
+    recorder_encoder_t encoder;  //!< the encoder function
+} recorder_encoder_entry_t;
+
+//! recording statistics
+typedef struct {
+    unsigned long captured;  //!< number of frames offered to the recorder
+    unsigned long written;   //!< number of frames written to disk
+    unsigned long dropped;   //!< number of frames dropped because all slots were in use
+    unsigned long failed;    //!< number of frames the encoder could not write
+    int pending;             //!< number of frames waiting for or being encoded
+    int max_pending;         //!< highest number of pending frames
+    uint64_t capture_ns;     //!< time spent copying frames on the main thread
+} recorder_stats_t;
+
+/*********************
+** static variables **
+*********************/
+static recorder_encoder_entry_t rec_encoders[RECORDER_MAX_ENCODERS];  //!< registered encoders
+static int rec_num_encoders = 0;                                      //!< number of registered encoders
+
+static recorder_slot_t rec_slots[RECORDER_MAX_SLOTS];  //!< the frame ring
+static int rec_num_slots = 0;                          //!< number of allocated slots, 0 if not recording
+static char *rec_prefix = NULL;                        //!< file name prefix
+static const char *rec_ext = NULL;                     //!< file extension
+static recorder_encoder_t rec_encoder = NULL;          //!< the active encoder
+static recorder_stats_t rec_stats;                     //!< statistics of the current recording
+static int rec_num_threads = 0;                        //!< number of encoder threads, 0 to encode on the main thread
+
+#if LINUX == 1
+static pthread_mutex_t rec_mutex = PTHREAD_MUTEX_INITIALIZER;  //!< protects the slots and the statistics
+static pthread_cond_t rec_work = PTHREAD_COND_INITIALIZER;     //!< signalled when a frame was queued or recording stops
+static pthread_t rec_threads[RECORDER_MAX_THREADS];            //!< the encoder threads
+static bool rec_stopping = false;                              //!< the encoder threads shall exit when all frames are written
+#endif
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief convert a 32bpp memory bitmap to RGBA bytes in place. Only reads the pixel format, so it may run on a worker thread.
+ *
+ * @param bm the bitmap, the lines of memory bitmaps are contiguous.
+ */
+static void recorder_to_rgba(BITMAP *bm) {
+    uint32_t *src = (uint32_t *)bm->line[0];
+    uint8_t *dst = (uint8_t *)bm->line[0];
+    int num = bm->w * bm->h;
+
+    for (int i = 0; i < num; i++) {
+        uint32_t c = *src++;
+        *dst++ = getr32(c);
+        *dst++ = getg32(c);
+        *dst++ = getb32(c);
+        *dst++ = 0xFF;
+    }
+}
+
+/**
+ * @brief convert and write the frame in a slot.
+ *
+ * @param slot the slot.
+ *
+ * @return true if the frame was written.
+ */
+static bool recorder_encode(recorder_slot_t *slot) {
+    char fname[1024];
+
+    snprintf(fname, sizeof(fname), "%s%05lu.%s", rec_prefix, slot->frame, rec_ext);
+    recorder_to_rgba(slot->bm);
+    return rec_encoder(fname, (const uint8_t *)slot->bm->line[0], slot->bm->w, slot->bm->h);
+}
+
+/**
+ * @brief built-in encoder for uncompressed 32bit TGA files. It is fast, but the files are big.
+ */
+static bool recorder_encode_tga(const char *fname, const uint8_t *rgba, int width, int height) {
+    uint8_t header[18] = {0};
+    header[2] = 2;  // uncompressed truecolor
+    header[12] = width & 0xFF;
+    header[13] = (width >> 8) & 0xFF;
+    header[14] = height & 0xFF;
+    header[15] = (height >> 8) & 0xFF;
+    header[16] = 32;    // bits per pixel
+    header[17] = 0x28;  // top-left origin, 8 alpha bits
+
+    uint8_t *row = malloc(width * 4);
+    if (!row) {
+        return false;
+    }
+    FILE *f = fopen(fname, "wb");
+    if (!f) {
+        free(row);
+        return false;
+    }
+
+    bool ok = fwrite(header, sizeof(header), 1, f) == 1;
+    for (int y = 0; y < height && ok; y++) {
+        uint8_t *dst = row;
+        for (int x = 0; x < width; x++) {
+            *dst++ = rgba[2];
+            *dst++ = rgba[1];
+            *dst++ = rgba[0];
+            *dst++ = rgba[3];
+            rgba += 4;
+        }
+        ok = fwrite(row, width * 4, 1, f) == 1;
+    }
+    free(row);
+
+    return (fclose(f) == 0) && ok;
+}
+
+#if LINUX == 1
+/**
+ * @brief encoder thread, writes the oldest queued frame until recording stops and all frames are written.
+ *
+ * @param arg unused.
+ *
+ * @return always NULL.
+ */
+static void *recorder_worker(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&rec_mutex);
+    while (true) {
+        recorder_slot_t *slot = NULL;
+        for (int i = 0; i < rec_num_slots; i++) {
+            if (rec_slots[i].state == SLOT_FILLED && (!slot || rec_slots[i].frame < slot->frame)) {
+                slot = &rec_slots[i];
+            }
+        }
+        if (!slot) {
+            if (rec_stopping) {
+                break;
+            }
+            pthread_cond_wait(&rec_work, &rec_mutex);
+            continue;
+        }
+        slot->state = SLOT_ENCODING;
+        pthread_mutex_unlock(&rec_mutex);
+
+        bool ok = recorder_encode(slot);
+
+        pthread_mutex_lock(&rec_mutex);
+        slot->state = SLOT_FREE;
+        rec_stats.pending--;
+        if (ok) {
+            rec_stats.written++;
+        } else {
+            rec_stats.failed++;
+        }
+    }
+    pthread_mutex_unlock(&rec_mutex);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief wait until all frames are written and free all slots.
+ */
+static void recorder_stop(void) {
+#if LINUX == 1
+    if (rec_num_threads) {
+        pthread_mutex_lock(&rec_mutex);
+        rec_stopping = true;
+        pthread_cond_broadcast(&rec_work);
+        pthread_mutex_unlock(&rec_mutex);
+
+        for (int i = 0; i < rec_num_threads; i++) {
+            pthread_join(rec_threads[i], NULL);
+        }
+        rec_num_threads = 0;
+        rec_stopping = false;
+    }
+#endif
+
+    for (int i = 0; i < rec_num_slots; i++) {
+        destroy_bitmap(rec_slots[i].bm);
+        rec_slots[i].bm = NULL;
+    }
+    rec_num_slots = 0;
+    free(rec_prefix);
+    rec_prefix = NULL;
+}
+
+/**
+ * @brief push the recording statistics onto the stack.
+ *
+ * @param J VM state.
+ */
+static void recorder_push_stats(js_State *J) {
+#if LINUX == 1
+    pthread_mutex_lock(&rec_mutex);
+#endif
+    recorder_stats_t stats = rec_stats;
+#if LINUX == 1
+    pthread_mutex_unlock(&rec_mutex);
+#endif
+
+    js_newobject(J);
+    {
+        js_pushnumber(J, stats.captured);
+        js_setproperty(J, -2, "captured");
+        js_pushnumber(J, stats.written);
+        js_setproperty(J, -2, "written");
+        js_pushnumber(J, stats.dropped);
+        js_setproperty(J, -2, "dropped");
+        js_pushnumber(J, stats.failed);
+        js_setproperty(J, -2, "failed");
+        js_pushnumber(J, stats.pending);
+        js_setproperty(J, -2, "pending");
+        js_pushnumber(J, stats.max_pending);
+        js_setproperty(J, -2, "maxPending");
+        js_pushnumber(J, stats.captured ? (double)stats.capture_ns / stats.captured / TIMING_NS_PER_MS : 0);
+        js_setproperty(J, -2, "captureMs");
+    }
+}
+
+/**
+ * @brief start recording the screen after every Loop().
+ * StartRecording(prefix:string, [format:string], [slots:number], [threads:number])
+ *
+ * @param J VM state.
+ */
+static void f_StartRecording(js_State *J) {
+    if (rec_num_slots) {
+        js_error(J, "Recording already in progress");
+        return;
+    }
+
+    const char *prefix = js_tostring(J, 1);
+    const char *ext = js_isdefined(J, 2) ? js_tostring(J, 2) : "tga";
+    int slots = js_isdefined(J, 3) ? js_toint32(J, 3) : RECORDER_DEFAULT_SLOTS;
+    int threads = js_isdefined(J, 4) ? js_toint32(J, 4) : RECORDER_DEFAULT_THREADS;
+
+    rec_encoder = NULL;
+    for (int i = 0; i < rec_num_encoders; i++) {
+        if (stricmp(rec_encoders[i].ext, ext) == 0) {
+            rec_encoder = rec_encoders[i].encoder;
+            rec_ext = rec_encoders[i].ext;
+        }
+    }
+    if (!rec_encoder) {
+        js_error(J, "No encoder for '%s' available", ext);
+        return;
+    }
+
+    rec_prefix = ut_clone_string(prefix);
+    if (!rec_prefix) {
+        JS_ENOMEM(J);
+        return;
+    }
+
+    // preallocate all frames, the memory use is fixed during recording
+    slots = MID(1, slots, RECORDER_MAX_SLOTS);
+    for (int i = 0; i < slots; i++) {
+        rec_slots[i].bm = create_bitmap_ex(32, DOjS.render_bm->w, DOjS.render_bm->h);
+        rec_slots[i].state = SLOT_FREE;
+        rec_num_slots++;
+        if (!rec_slots[i].bm) {
+            recorder_stop();
+            JS_ENOMEM(J);
+            return;
+        }
+    }
+    memset(&rec_stats, 0, sizeof(rec_stats));
+
+#if LINUX == 1
+    // without threads frames are written on the main thread
+    threads = MID(0, threads, RECORDER_MAX_THREADS);
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&rec_threads[i], NULL, recorder_worker, NULL) != 0) {
+            LOGF("Could only start %d recorder threads\n", i);
+            break;
+        }
+        rec_num_threads++;
+    }
+#else
+    (void)threads;
+#endif
+}
+
+/**
+ * @brief stop recording and wait until all frames are written.
+ * StopRecording():RecorderStats
+ *
+ * @param J VM state.
+ */
+static void f_StopRecording(js_State *J) {
+    recorder_stop();
+    recorder_push_stats(J);
+}
+
+/**
+ * @brief get the statistics of the current/last recording.
+ * GetRecorderStats():RecorderStats
+ *
+ * @param J VM state.
+ */
+static void f_GetRecorderStats(js_State *J) { recorder_push_stats(J); }
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief register an encoder for recording.
+ *
+ * @param ext the file extension (e.g. "qoi").
+ * @param encoder the encoder function.
+ */
+void recorder_register(const char *ext, recorder_encoder_t encoder) {
+    // libraries are re-initialized for every run, replace an existing entry
+    for (int i = 0; i < rec_num_encoders; i++) {
+        if (stricmp(rec_encoders[i].ext, ext) == 0) {
+            rec_encoders[i].encoder = encoder;
+            return;
+        }
+    }
+
+    if (rec_num_encoders >= RECORDER_MAX_ENCODERS || strlen(ext) >= RECORDER_EXT_LEN) {
+        LOGF("Can't register recorder encoder for '%s'\n", ext);
+        return;
+    }
+    strcpy(rec_encoders[rec_num_encoders].ext, ext);
+    rec_encoders[rec_num_encoders].encoder = encoder;
+    rec_num_encoders++;
+}
+
+/**
+ * @brief copy a frame into a free slot and queue it for encoding. The frame is dropped if all slots are in use.
+ * Without encoder threads the frame is written immediately.
+ *
+ * @param bm the frame.
+ */
+void recorder_capture(BITMAP *bm) {
+    if (!rec_num_slots) {
+        return;
+    }
+    uint64_t start = timing_now();
+
+    if (!rec_num_threads) {
+        recorder_slot_t *slot = &rec_slots[0];
+        slot->frame = rec_stats.captured++;
+        blit(bm, slot->bm, 0, 0, 0, 0, slot->bm->w, slot->bm->h);
+        if (recorder_encode(slot)) {
+            rec_stats.written++;
+        } else {
+            rec_stats.failed++;
+        }
+        rec_stats.capture_ns += timing_now() - start;
+        return;
+    }
+
+#if LINUX == 1
+    recorder_slot_t *slot = NULL;
+
+    pthread_mutex_lock(&rec_mutex);
+    unsigned long frame = rec_stats.captured++;
+    for (int i = 0; i < rec_num_slots; i++) {
+        if (rec_slots[i].state == SLOT_FREE) {
+            slot = &rec_slots[i];
+            slot->state = SLOT_COPYING;
+            break;
+        }
+    }
+    if (!slot) {
+        rec_stats.dropped++;
+    }
+    pthread_mutex_unlock(&rec_mutex);
+
+    if (slot) {
+        blit(bm, slot->bm, 0, 0, 0, 0, slot->bm->w, slot->bm->h);
+
+        pthread_mutex_lock(&rec_mutex);
+        slot->frame = frame;
+        slot->state = SLOT_FILLED;
+        rec_stats.pending++;
+        if (rec_stats.pending > rec_stats.max_pending) {
+            rec_stats.max_pending = rec_stats.pending;
+        }
+        pthread_cond_signal(&rec_work);
+        pthread_mutex_unlock(&rec_mutex);
+    }
+#endif
+
+    rec_stats.capture_ns += timing_now() - start;
+}
+
+/**
+ * @brief initialize frame recording.
+ *
+ * @param J VM state.
+ */
+void init_recorder(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    recorder_register("tga", recorder_encode_tga);
+
+    NFUNCDEF(J, StartRecording, 4);
+    NFUNCDEF(J, StopRecording, 0);
+    NFUNCDEF(J, GetRecorderStats, 0);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
+
+/**
+ * @brief stop a running recording, all queued frames are written.
+ */
+void shutdown_recorder(void) { recorder_stop(); }
@@ -0,0 +1,61 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef __RECORDER_H__
+#define __RECORDER_H__
+
+#include <stdint.h>
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define RECORDER_MAX_ENCODERS 8     //!< max number of registered encoders
+#define RECORDER_EXT_LEN 8          //!< max length of a file extension
+#define RECORDER_DEFAULT_SLOTS 8    //!< default number of preallocated frames
+#define RECORDER_MAX_SLOTS 64       //!< max number of preallocated frames
+#define RECORDER_DEFAULT_THREADS 2  //!< default number of encoder threads (Linux)
+#define RECORDER_MAX_THREADS 8      //!< max number of encoder threads (Linux)
+
+/**
+ * @brief encode an RGBA image to a file. Called from a worker thread on Linux, MUST NOT use Allegro or the JS engine there.
+ *
+ * @param fname the file to write.
+ * @param rgba RGBA pixel data, 4 bytes per pixel.
+ * @param width width of the image.
+ * @param height height of the image.
+ *
+ * @return true if the image was written, else false.
+ */
+typedef bool (*recorder_encoder_t)(const char *fname, const uint8_t *rgba, int width, int height);
+
+/***********************
+** exported functions **
+***********************/
+extern void init_recorder(js_State *J);
+extern void shutdown_recorder(void);
+extern void recorder_register(const char *ext, recorder_encoder_t encoder);
+extern void recorder_capture(BITMAP *bm);
+
+#endif  // __RECORDER_H__
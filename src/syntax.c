@@ -72,9 +72,10 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTBLUE, ".prototype"),   //
 
     // DOjS functions
-    EDI_SYNTAX(MAGENTA, "Setup"),  //
-    EDI_SYNTAX(MAGENTA, "Loop"),   //
-    EDI_SYNTAX(MAGENTA, "Input"),  //
+    EDI_SYNTAX(MAGENTA, "Update"),  //
+    EDI_SYNTAX(MAGENTA, "Setup"),   //
+    EDI_SYNTAX(MAGENTA, "Loop"),    //
+    EDI_SYNTAX(MAGENTA, "Input"),   //
 
     // array methods
     EDI_SYNTAX(LIGHTCYAN, ".lastIndexOf"),  //
@@ -124,6 +125,7 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTRED, "fxConstantColorValue"),          //
     EDI_SYNTAX(LIGHTRED, "fxAlphaBlendFunction"),          //
     EDI_SYNTAX(LIGHTRED, "GetTranslationMatrix"),          //
+    EDI_SYNTAX(LIGHTRED, "glClearTextureCache"),           //
     EDI_SYNTAX(LIGHTRED, "glutWireTetrahedron"),           //
     EDI_SYNTAX(LIGHTRED, "glutWireIcosahedron"),           //
     EDI_SYNTAX(LIGHTRED, "glutSolidOctahedron"),           //
@@ -135,6 +137,7 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTRED, "fxDisableAllEffects"),           //
     EDI_SYNTAX(LIGHTRED, "fxAlphaTestFunction"),           //
     EDI_SYNTAX(LIGHTRED, "TransparencyEnabled"),           //
+    EDI_SYNTAX(LIGHTRED, "TransformTranslate"),            //
     EDI_SYNTAX(LIGHTRED, "glutWireOctahedron"),            //
     EDI_SYNTAX(LIGHTRED, "glPushClientAttrib"),            //
     EDI_SYNTAX(LIGHTRED, "fxTexDetailControl"),            //
@@ -148,6 +151,10 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTRED, "IpxGetLocalAddress"),            //
     EDI_SYNTAX(LIGHTRED, "IpxAddressToString"),            //
     EDI_SYNTAX(LIGHTRED, "GetLoadedLibraries"),            //
+    EDI_SYNTAX(LIGHTRED, "glTexCoordPointer"),             //
+    EDI_SYNTAX(LIGHTRED, "SetProfileOverlay"),             //
+    EDI_SYNTAX(LIGHTRED, "ColorFromArgsRGBA"),             //
+    EDI_SYNTAX(LIGHTRED, "SetImageCacheSize"),             //
     EDI_SYNTAX(LIGHTRED, "glPopClientAttrib"),             //
     EDI_SYNTAX(LIGHTRED, "glGetTexParameter"),             //
     EDI_SYNTAX(LIGHTRED, "fxTexLodBiasValue"),             //
@@ -164,6 +171,8 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTRED, "GetLocalIpAddress"),             //
     EDI_SYNTAX(LIGHTRED, "GetIdentityMatrix"),             //
     EDI_SYNTAX(LIGHTRED, "EnableRemoteDebug"),             //
+    EDI_SYNTAX(LIGHTRED, "GetRecorderStats"),              //
+    EDI_SYNTAX(LIGHTRED, "SetTextCacheSize"),              //
     EDI_SYNTAX(LIGHTRED, "glPolygonStipple"),              //
     EDI_SYNTAX(LIGHTRED, "glDeleteTextures"),              //
     EDI_SYNTAX(LIGHTRED, "fxGetRevisionTmu"),              //
@@ -182,6 +191,16 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTRED, "GetScalingMatrix"),              //
     EDI_SYNTAX(LIGHTRED, "GetRawSectorSize"),              //
     EDI_SYNTAX(LIGHTRED, "GetParallelPorts"),              //
+    EDI_SYNTAX(LIGHTRED, "glBitmapTexture"),               //
+    EDI_SYNTAX(LIGHTRED, "glTexSubImage2D"),               //
+    EDI_SYNTAX(LIGHTRED, "glNormalPointer"),               //
+    EDI_SYNTAX(LIGHTRED, "glVertexPointer"),               //
+    EDI_SYNTAX(LIGHTRED, "GetScreenPixels"),               //
+    EDI_SYNTAX(LIGHTRED, "ColorCacheStats"),               //
+    EDI_SYNTAX(LIGHTRED, "TransformRotate"),               //
+    EDI_SYNTAX(LIGHTRED, "TransformActive"),               //
+    EDI_SYNTAX(LIGHTRED, "ClearImageCache"),               //
+    EDI_SYNTAX(LIGHTRED, "ImageCacheStats"),               //
     EDI_SYNTAX(LIGHTRED, "glutSolidSphere"),               //
     EDI_SYNTAX(LIGHTRED, "glPolygonOffset"),               //
     EDI_SYNTAX(LIGHTRED, "glPixelTransfer"),               //
@@ -201,6 +220,18 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTRED, "MouseShowCursor"),               //
     EDI_SYNTAX(LIGHTRED, "GetCameraMatrix"),               //
     EDI_SYNTAX(LIGHTRED, "CustomCircleArc"),               //
+    EDI_SYNTAX(LIGHTRED, "glDrawElements"),                //
+    EDI_SYNTAX(LIGHTRED, "glColorPointer"),                //
+    EDI_SYNTAX(LIGHTRED, "StartRecording"),                //
+    EDI_SYNTAX(LIGHTRED, "SaveProfileCSV"),                //
+    EDI_SYNTAX(LIGHTRED, "GetUpdateAlpha"),                //
+    EDI_SYNTAX(LIGHTRED, "TransformApply"),                //
+    EDI_SYNTAX(LIGHTRED, "TransformScale"),                //
+    EDI_SYNTAX(LIGHTRED, "TransformReset"),                //
+    EDI_SYNTAX(LIGHTRED, "CustomPolyLine"),                //
+    EDI_SYNTAX(LIGHTRED, "FilledPolygons"),                //
+    EDI_SYNTAX(LIGHTRED, "ClearTextCache"),                //
+    EDI_SYNTAX(LIGHTRED, "TextCacheStats"),                //
     EDI_SYNTAX(LIGHTRED, "glutWireSphere"),                //
     EDI_SYNTAX(LIGHTRED, "glutSolidTorus"),                //
     EDI_SYNTAX(LIGHTRED, "gluPerspective"),                //
@@ -232,6 +263,11 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTRED, "GetNetworkMask"),                //
     EDI_SYNTAX(LIGHTRED, "GetEmptyMatrix"),                //
     EDI_SYNTAX(LIGHTRED, "GetAlignMatrix"),                //
+    EDI_SYNTAX(LIGHTRED, "StopRecording"),                 //
+    EDI_SYNTAX(LIGHTRED, "SetUpdateRate"),                 //
+    EDI_SYNTAX(LIGHTRED, "GetFrameStats"),                 //
+    EDI_SYNTAX(LIGHTRED, "ColorFromArgs"),                 //
+    EDI_SYNTAX(LIGHTRED, "TransformPush"),                 //
     EDI_SYNTAX(LIGHTRED, "glutWireTorus"),                 //
     EDI_SYNTAX(LIGHTRED, "glutSolidCube"),                 //
     EDI_SYNTAX(LIGHTRED, "glutSolidCone"),                 //
@@ -263,6 +299,9 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTRED, "FilledEllipse"),                 //
     EDI_SYNTAX(LIGHTRED, "CustomEllipse"),                 //
     EDI_SYNTAX(LIGHTRED, "BytesToString"),                 //
+    EDI_SYNTAX(LIGHTRED, "glDrawArrays"),                  //
+    EDI_SYNTAX(LIGHTRED, "TransformGet"),                  //
+    EDI_SYNTAX(LIGHTRED, "TransformPop"),                  //
     EDI_SYNTAX(LIGHTRED, "glutWireCube"),                  //
     EDI_SYNTAX(LIGHTRED, "glutWireCone"),                  //
     EDI_SYNTAX(LIGHTRED, "glTexImage2D"),                  //
@@ -361,6 +400,10 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTRED, "CreateScene"),                   //
     EDI_SYNTAX(LIGHTRED, "ClearScreen"),                   //
     EDI_SYNTAX(LIGHTRED, "ApplyMatrix"),                   //
+    EDI_SYNTAX(LIGHTRED, "GetProfile"),                    //
+    EDI_SYNTAX(LIGHTRED, "TransformY"),                    //
+    EDI_SYNTAX(LIGHTRED, "TransformX"),                    //
+    EDI_SYNTAX(LIGHTRED, "PlotPoints"),                    //
     EDI_SYNTAX(LIGHTRED, "gluOrtho2D"),                    //
     EDI_SYNTAX(LIGHTRED, "glViewport"),                    //
     EDI_SYNTAX(LIGHTRED, "glShutdown"),                    //
@@ -426,6 +469,8 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTRED, "DrawArray"),                     //
     EDI_SYNTAX(LIGHTRED, "DirExists"),                     //
     EDI_SYNTAX(LIGHTRED, "CircleArc"),                     //
+    EDI_SYNTAX(LIGHTRED, "NsecTime"),                      //
+    EDI_SYNTAX(LIGHTRED, "PolyLine"),                      //
     EDI_SYNTAX(LIGHTRED, "glTexGen"),                      //
     EDI_SYNTAX(LIGHTRED, "glTexEnv"),                      //
     EDI_SYNTAX(LIGHTRED, "glRotate"),                      //
@@ -520,6 +565,7 @@ const syntax_t edi_wordlist[] = {
     // Classes
     EDI_SYNTAX(LIGHTGREEN, "DoubleArray"),  // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "IntArray"),     // .ctor()
+    EDI_SYNTAX(LIGHTGREEN, "PVector"),      // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "GIFAnim"),      // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "TexInfo"),      // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "COMPort"),      // .ctor()
@@ -527,6 +573,7 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTGREEN, "FxState"),      // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "IniFile"),      // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "Rawplay"),      // .ctor()
+    EDI_SYNTAX(LIGHTGREEN, "Matrix"),       // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "Sample"),       // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "Socket"),       // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "Bitmap"),       // .ctor()
@@ -534,6 +581,8 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(LIGHTGREEN, "PDFGen"),       // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "Neural"),       // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "MPEG1"),        // .ctor()
+    EDI_SYNTAX(LIGHTGREEN, "Atlas"),        // .ctor()
+    EDI_SYNTAX(LIGHTGREEN, "Mesh"),         // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "Font"),         // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "File"),         // .ctor()
     EDI_SYNTAX(LIGHTGREEN, "Curl"),         // .ctor()
@@ -581,6 +630,7 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(RED, "ClearHeaders"),            //
     EDI_SYNTAX(RED, "AddRectangle"),            //
     EDI_SYNTAX(RED, "AddImageFile"),            //
+    EDI_SYNTAX(RED, "EnableCache"),             //
     EDI_SYNTAX(RED, "WriteString"),             //
     EDI_SYNTAX(RED, "StringWidth"),             //
     EDI_SYNTAX(RED, "PageSetSize"),             //
@@ -592,6 +642,7 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(RED, "CurrentTime"),             //
     EDI_SYNTAX(RED, "AddTextWrap"),             //
     EDI_SYNTAX(RED, "AddBookmark"),             //
+    EDI_SYNTAX(RED, "DrawMasked"),              //
     EDI_SYNTAX(RED, "WriteBytes"),              //
     EDI_SYNTAX(RED, "SetTimeout"),              //
     EDI_SYNTAX(RED, "SetReferer"),              //
@@ -627,6 +678,8 @@ const syntax_t edi_wordlist[] = {
     EDI_SYNTAX(RED, "DataReady"),               //
     EDI_SYNTAX(RED, "AddHeader"),               //
     EDI_SYNTAX(RED, "AddCircle"),               //
+    EDI_SYNTAX(RED, "GetStats"),                //
+    EDI_SYNTAX(RED, "IsCached"),                //
     EDI_SYNTAX(RED, "ToString"),                //
     EDI_SYNTAX(RED, "SetProxy"),                //
     EDI_SYNTAX(RED, "ReadLine"),                //
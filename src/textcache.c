@@ -0,0 +1,381 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "textcache.h"
+
+#include <allegro.h>
+#include <mujs.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define TEXTCACHE_DEFAULT_SIZE (1024 * 1024)  //!< default memory limit of the text cache
+#define TEXTCACHE_BUCKETS 256                 //!< number of hash buckets (must be a power of two)
+#define TEXTCACHE_MAX_LEN 256                 //!< longer strings are not cached
+
+/************
+** structs **
+************/
+//! a rendered string in the cache
+typedef struct __textcache_entry {
+    struct __textcache_entry *prev;   //!< previous entry (more recently used)
+    struct __textcache_entry *next;   //!< next entry (less recently used)
+    struct __textcache_entry *hnext;  //!< next entry in the same hash bucket
+    uint32_t hash;                    //!< hash over all key fields
+    FONT *f;                          //!< the font
+    char *str;                        //!< the string
+    int fg;                           //!< foreground color
+    int bg;                           //!< background color
+    BITMAP *bm;                       //!< the rendered string, unused pixels are set to the mask color
+    size_t bytes;                     //!< memory used by the rendered string
+} textcache_entry_t;
+
+/*********************
+** static variables **
+*********************/
+static textcache_entry_t *tc_buckets[TEXTCACHE_BUCKETS];  //!< hash buckets
+static textcache_entry_t *tc_head = NULL;                 //!< most recently used entry
+static textcache_entry_t *tc_tail = NULL;                 //!< least recently used entry
+static size_t tc_limit = TEXTCACHE_DEFAULT_SIZE;          //!< memory limit in bytes, 0 to disable the cache
+static size_t tc_bytes = 0;                               //!< current memory usage in bytes
+static int tc_entries = 0;                                //!< number of entries
+static unsigned long tc_hits = 0;                         //!< cache hits
+static unsigned long tc_misses = 0;                       //!< cache misses
+static unsigned long tc_evictions = 0;                    //!< number of evicted entries
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief calculate the hash for a cache key (FNV-1a).
+ *
+ * @param f the font.
+ * @param str the string.
+ * @param fg foreground color.
+ * @param bg background color.
+ * @param depth color depth of the destination.
+ * @param len the length of the string is stored here.
+ *
+ * @return the hash value.
+ */
+static uint32_t textcache_hash(FONT *f, const char *str, int fg, int bg, int depth, size_t *len) {
+    uint32_t h = 2166136261u;
+    const char *s = str;
+    while (*s) {
+        h = (h ^ (uint8_t)*s++) * 16777619u;
+    }
+    *len = s - str;
+
+    h = (h ^ (uint32_t)(uintptr_t)f) * 16777619u;
+    h = (h ^ (uint32_t)fg) * 16777619u;
+    h = (h ^ (uint32_t)bg) * 16777619u;
+    h = (h ^ (uint32_t)depth) * 16777619u;
+    return h;
+}
+
+/**
+ * @brief remove an entry from the LRU list.
+ *
+ * @param e the entry.
+ */
+static void textcache_unlink(textcache_entry_t *e) {
+    if (e->prev) {
+        e->prev->next = e->next;
+    } else {
+        tc_head = e->next;
+    }
+    if (e->next) {
+        e->next->prev = e->prev;
+    } else {
+        tc_tail = e->prev;
+    }
+    e->prev = e->next = NULL;
+}
+
+/**
+ * @brief insert an entry at the start of the LRU list.
+ *
+ * @param e the entry.
+ */
+static void textcache_link(textcache_entry_t *e) {
+    e->prev = NULL;
+    e->next = tc_head;
+    if (tc_head) {
+        tc_head->prev = e;
+    } else {
+        tc_tail = e;
+    }
+    tc_head = e;
+}
+
+/**
+ * @brief remove an entry from the cache and free all resources.
+ *
+ * @param e the entry.
+ */
+static void textcache_free(textcache_entry_t *e) {
+    textcache_entry_t **p = &tc_buckets[e->hash & (TEXTCACHE_BUCKETS - 1)];
+    while (*p != e) {
+        p = &(*p)->hnext;
+    }
+    *p = e->hnext;
+
+    textcache_unlink(e);
+    tc_bytes -= e->bytes;
+    tc_entries--;
+    destroy_bitmap(e->bm);
+    free(e->str);
+    free(e);
+}
+
+/**
+ * @brief evict entries (least recently used first) until the cache fits its memory limit.
+ */
+static void textcache_trim(void) {
+    while (tc_tail && tc_bytes > tc_limit) {
+        textcache_free(tc_tail);
+        tc_evictions++;
+    }
+}
+
+/**
+ * @brief render a string into a new cache entry.
+ *
+ * @param f the font.
+ * @param str the string.
+ * @param len length of the string.
+ * @param fg foreground color.
+ * @param bg background color.
+ * @param depth color depth of the destination.
+ * @param hash hash of the key.
+ *
+ * @return the new entry or NULL if the string can't be cached.
+ */
+static textcache_entry_t *textcache_render(FONT *f, const char *str, size_t len, int fg, int bg, int depth, uint32_t hash) {
+    // only monochrome fonts are drawn without blending, all pixels of a color font would need to be blended
+    if (!is_mono_font(f)) {
+        return NULL;
+    }
+
+    int w = text_length(f, str);
+    int h = text_height(f);
+    if (w <= 0 || h <= 0) {
+        return NULL;
+    }
+
+    textcache_entry_t *e = calloc(1, sizeof(textcache_entry_t));
+    if (!e) {
+        return NULL;
+    }
+    e->str = malloc(len + 1);
+    e->bm = create_bitmap_ex(depth, w, h);
+    if (!e->str || !e->bm) {
+        if (e->bm) {
+            destroy_bitmap(e->bm);
+        }
+        free(e->str);
+        free(e);
+        return NULL;
+    }
+
+    // the mask color marks pixels that textout_ex() would not have touched
+    int mask = bitmap_mask_color(e->bm);
+    if (fg == mask || bg == mask) {
+        destroy_bitmap(e->bm);
+        free(e->str);
+        free(e);
+        return NULL;
+    }
+    clear_to_color(e->bm, mask);
+    textout_ex(e->bm, f, str, 0, 0, fg, bg);
+
+    memcpy(e->str, str, len + 1);
+    e->hash = hash;
+    e->f = f;
+    e->fg = fg;
+    e->bg = bg;
+    e->bytes = w * h * ((depth + 7) / 8) + sizeof(textcache_entry_t) + len;
+
+    textcache_entry_t **bucket = &tc_buckets[hash & (TEXTCACHE_BUCKETS - 1)];
+    e->hnext = *bucket;
+    *bucket = e;
+    textcache_link(e);
+    tc_bytes += e->bytes;
+    tc_entries++;
+
+    textcache_trim();
+    return e;
+}
+
+/**
+ * @brief get text cache statistics.
+ * TextCacheStats():{hits:number, misses:number, evictions:number, entries:number, bytes:number, limit:number}
+ *
+ * @param J the JS context.
+ */
+static void f_TextCacheStats(js_State *J) {
+    js_newobject(J);
+    {
+        js_pushnumber(J, tc_hits);
+        js_setproperty(J, -2, "hits");
+        js_pushnumber(J, tc_misses);
+        js_setproperty(J, -2, "misses");
+        js_pushnumber(J, tc_evictions);
+        js_setproperty(J, -2, "evictions");
+        js_pushnumber(J, tc_entries);
+        js_setproperty(J, -2, "entries");
+        js_pushnumber(J, tc_bytes);
+        js_setproperty(J, -2, "bytes");
+        js_pushnumber(J, tc_limit);
+        js_setproperty(J, -2, "limit");
+    }
+}
+
+/**
+ * @brief set the memory limit of the text cache.
+ * SetTextCacheSize(bytes:number)
+ *
+ * @param J the JS context.
+ */
+static void f_SetTextCacheSize(js_State *J) {
+    double size = js_tonumber(J, 1);
+    JS_CHECKPOS(J, size);
+
+    tc_limit = size;
+    textcache_trim();
+}
+
+/**
+ * @brief remove all strings from the cache and reset the statistics.
+ * ClearTextCache()
+ *
+ * @param J the JS context.
+ */
+static void f_ClearTextCache(js_State *J) {
+    textcache_clear();
+    tc_hits = tc_misses = tc_evictions = 0;
+}
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief initialize text cache functions.
+ *
+ * @param J VM state.
+ */
+void init_textcache(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    NFUNCDEF(J, TextCacheStats, 0);
+    NFUNCDEF(J, SetTextCacheSize, 1);
+    NFUNCDEF(J, ClearTextCache, 0);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
+
+/**
+ * @brief draw a string like textout_ex(), a rendered copy of the string is kept for the next call.
+ *
+ * @param bmp destination BITMAP.
+ * @param f the font.
+ * @param str the string.
+ * @param x x position.
+ * @param y y position.
+ * @param fg foreground color.
+ * @param bg background color or -1 for transparent.
+ * @param align one of TEXT_ALIGN_LEFT, TEXT_ALIGN_CENTER or TEXT_ALIGN_RIGHT.
+ */
+void textcache_draw(BITMAP *bmp, FONT *f, const char *str, int x, int y, int fg, int bg, int align) {
+    textcache_entry_t *e = NULL;
+
+    if (tc_limit > 0) {
+        int depth = bitmap_color_depth(bmp);
+        size_t len;
+        uint32_t hash = textcache_hash(f, str, fg, bg, depth, &len);
+
+        if (len <= TEXTCACHE_MAX_LEN) {
+            for (e = tc_buckets[hash & (TEXTCACHE_BUCKETS - 1)]; e; e = e->hnext) {
+                if (e->hash == hash && e->f == f && e->fg == fg && e->bg == bg && bitmap_color_depth(e->bm) == depth && strcmp(e->str, str) == 0) {
+                    break;
+                }
+            }
+
+            if (e) {
+                tc_hits++;
+                textcache_unlink(e);
+                textcache_link(e);
+            } else {
+                tc_misses++;
+                e = textcache_render(f, str, len, fg, bg, depth, hash);
+            }
+        }
+    }
+
+    if (e) {
+        if (align == TEXT_ALIGN_CENTER) {
+            x -= e->bm->w / 2;
+        } else if (align == TEXT_ALIGN_RIGHT) {
+            x -= e->bm->w;
+        }
+        draw_sprite(bmp, e->bm, x, y);
+    } else {
+        if (align == TEXT_ALIGN_CENTER) {
+            textout_centre_ex(bmp, f, str, x, y, fg, bg);
+        } else if (align == TEXT_ALIGN_RIGHT) {
+            textout_right_ex(bmp, f, str, x, y, fg, bg);
+        } else {
+            textout_ex(bmp, f, str, x, y, fg, bg);
+        }
+    }
+}
+
+/**
+ * @brief remove all strings rendered with a font, must be called before the font is destroyed.
+ *
+ * @param f the font.
+ */
+void textcache_forget(FONT *f) {
+    textcache_entry_t *e = tc_head;
+    while (e) {
+        textcache_entry_t *next = e->next;
+        if (e->f == f) {
+            textcache_free(e);
+        }
+        e = next;
+    }
+}
+
+/**
+ * @brief remove all strings from the cache.
+ */
+void textcache_clear(void) {
+    while (tc_head) {
+        textcache_free(tc_head);
+    }
+}
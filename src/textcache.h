@@ -0,0 +1,44 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef __TEXTCACHE_H__
+#define __TEXTCACHE_H__
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define TEXT_ALIGN_LEFT 0    //!< text starts at x
+#define TEXT_ALIGN_CENTER 1  //!< text is centered around x
+#define TEXT_ALIGN_RIGHT 2   //!< text ends at x
+
+/***********************
+** exported functions **
+***********************/
+extern void init_textcache(js_State *J);
+extern void textcache_draw(BITMAP *bmp, FONT *f, const char *str, int x, int y, int fg, int bg, int align);
+extern void textcache_forget(FONT *f);
+extern void textcache_clear(void);
+
+#endif  // __TEXTCACHE_H__
@@ -0,0 +1,328 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "timing.h"
+
+#include <allegro.h>
+#include <mujs.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if LINUX == 1
+#include <sched.h>
+#include <time.h>
+#endif
+
+#include "DOjS.h"
+
+/*********************
+** static variables **
+*********************/
+static timing_t timing;  //!< scheduler state
+
+#if LINUX != 1
+static bool timing_has_tsc = false;  //!< true if the TSC was calibrated and can be used
+static uint64_t timing_tsc_start;    //!< TSC value at calibration
+static uint64_t timing_tsc_per_ms;   //!< TSC increments per ms
+#endif
+
+/*********************
+** static functions **
+*********************/
+#if LINUX != 1
+/**
+ * @brief read the time stamp counter.
+ *
+ * @return uint64_t the TSC value.
+ */
+static inline uint64_t timing_rdtsc(void) {
+    uint64_t tsc;
+    __asm__ __volatile__("rdtsc" : "=A"(tsc));
+    return tsc;
+}
+
+/**
+ * @brief calibrate the TSC against the Allegro timer. The measurement starts and ends on a tick edge, so the error is the interrupt latency only.
+ * CPUs without TSC (before Pentium) fall back to the 10ms tick counter.
+ */
+static void timing_calibrate(void) {
+    if (cpu_family < 5) {
+        LOG("No TSC, frame timing uses timer ticks\n");
+        return;
+    }
+
+    unsigned long t = DOjS.sys_ticks;
+    while (DOjS.sys_ticks == t) {
+    }
+    t = DOjS.sys_ticks;
+    uint64_t tsc = timing_rdtsc();
+    while (DOjS.sys_ticks - t < TIMING_CALIBRATE_TICKS * TICK_DELAY) {
+    }
+    uint64_t ms = DOjS.sys_ticks - t;
+
+    timing_tsc_per_ms = (timing_rdtsc() - tsc) / ms;
+    timing_tsc_start = tsc;
+    timing_has_tsc = timing_tsc_per_ms > 0;
+    LOGF("TSC calibrated to %lu kHz\n", (unsigned long)timing_tsc_per_ms);
+}
+#endif
+
+/**
+ * @brief sleep until the given point in time. Most of the time is slept, the last TIMING_SPIN_NS are spent waiting actively.
+ *
+ * @param deadline the time to wake up.
+ */
+static void timing_sleep_until(uint64_t deadline) {
+    uint64_t now;
+    while ((now = timing_now()) < deadline) {
+        uint64_t remaining = deadline - now;
+#if LINUX == 1
+        if (remaining > TIMING_SPIN_NS) {
+            remaining -= TIMING_SPIN_NS;
+            struct timespec ts = {.tv_sec = remaining / TIMING_NS_PER_SEC, .tv_nsec = remaining % TIMING_NS_PER_SEC};
+            nanosleep(&ts, NULL);
+        } else {
+            sched_yield();
+        }
+#else
+        if (remaining > TIMING_SPIN_NS) {
+            rest((remaining - TIMING_SPIN_NS) / TIMING_NS_PER_MS);
+        }
+#endif
+    }
+}
+
+/**
+ * @brief get the time as seen by the script: the real time or the virtual time in headless mode.
+ *
+ * @return uint64_t time in ns.
+ */
+static uint64_t timing_clock(void) { return timing.virtual_clock ? timing.virtual_now : timing_now(); }
+
+/**
+ * @brief compare function for qsort().
+ */
+static int timing_compare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief get time since start in ns.
+ * NsecTime([real:boolean]):number
+ *
+ * @param J the JS context.
+ */
+static void f_NsecTime(js_State *J) { js_pushnumber(J, js_toboolean(J, 1) ? timing_now() : timing_clock()); }
+
+/**
+ * @brief get statistics for the last frames.
+ * GetFrameStats():{"min":number, "avg":number, "max":number, "p99":number, "frames":number}
+ *
+ * @param J the JS context.
+ */
+static void f_GetFrameStats(js_State *J) {
+    uint64_t sorted[TIMING_HISTORY];
+    uint64_t sum = 0;
+    int n = timing.frame_count;
+
+    memcpy(sorted, timing.frame_times, sizeof(sorted));
+    qsort(sorted, n, sizeof(uint64_t), timing_compare);
+    for (int i = 0; i < n; i++) {
+        sum += sorted[i];
+    }
+
+    js_newobject(J);
+    {
+        js_pushnumber(J, n ? (double)sorted[0] / TIMING_NS_PER_MS : 0);
+        js_setproperty(J, -2, "min");
+        js_pushnumber(J, n ? (double)sum / n / TIMING_NS_PER_MS : 0);
+        js_setproperty(J, -2, "avg");
+        js_pushnumber(J, n ? (double)sorted[n - 1] / TIMING_NS_PER_MS : 0);
+        js_setproperty(J, -2, "max");
+        js_pushnumber(J, n ? (double)sorted[(n * 99) / 100] / TIMING_NS_PER_MS : 0);
+        js_setproperty(J, -2, "p99");
+        js_pushnumber(J, n);
+        js_setproperty(J, -2, "frames");
+    }
+}
+
+/**
+ * @brief enable fixed timestep updates: Update() is called with the given rate independent of the frame rate.
+ * SetUpdateRate(hz:number)
+ *
+ * @param J the JS context.
+ */
+static void f_SetUpdateRate(js_State *J) {
+    double hz = js_tonumber(J, 1);
+    if (hz > 0) {
+        timing.update_step = TIMING_NS_PER_SEC / hz;
+    } else {
+        timing.update_step = 0;
+    }
+    timing.update_acc = 0;
+    timing.update_alpha = 0;
+    timing.update_last = timing_clock();
+}
+
+/**
+ * @brief get the interpolation factor between the previous and the current Update() for rendering in Loop().
+ * GetUpdateAlpha():number
+ *
+ * @param J the JS context.
+ */
+static void f_GetUpdateAlpha(js_State *J) { js_pushnumber(J, timing.update_alpha); }
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief initialize timing subsystem.
+ *
+ * @param J VM state.
+ */
+void init_timing(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+#if LINUX != 1
+    if (!timing_has_tsc) {
+        timing_calibrate();
+    }
+#endif
+    memset(&timing, 0, sizeof(timing));
+    timing.virtual_clock = DOjS.params.headless > 0;
+
+    NFUNCDEF(J, NsecTime, 0);
+    NFUNCDEF(J, GetFrameStats, 0);
+    NFUNCDEF(J, SetUpdateRate, 1);
+    NFUNCDEF(J, GetUpdateAlpha, 0);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
+
+/**
+ * @brief get a monotonic time.
+ *
+ * @return uint64_t time in ns.
+ */
+uint64_t timing_now(void) {
+#if LINUX == 1
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * TIMING_NS_PER_SEC + ts.tv_nsec;
+#else
+    if (timing_has_tsc) {
+        // split the calculation to avoid overflows
+        uint64_t diff = timing_rdtsc() - timing_tsc_start;
+        return (diff / timing_tsc_per_ms) * TIMING_NS_PER_MS + ((diff % timing_tsc_per_ms) * TIMING_NS_PER_MS) / timing_tsc_per_ms;
+    } else {
+        return (uint64_t)DOjS.sys_ticks * TIMING_NS_PER_MS;
+    }
+#endif
+}
+
+/**
+ * @brief start the frame scheduler, must be called before the first frame.
+ */
+void timing_start(void) {
+    uint64_t now = timing_clock();
+    timing.deadline = now;
+    timing.frame_start = timing_now();
+    timing.update_last = now;
+}
+
+/**
+ * @brief get the number of fixed timestep updates for this frame and calculate the interpolation factor.
+ *
+ * @return int the number of times Update() must be called, 0 if fixed timestep updates are disabled.
+ */
+int timing_update_steps(void) {
+    if (!timing.update_step) {
+        return 0;
+    }
+
+    uint64_t now = timing_clock();
+    timing.update_acc += now - timing.update_last;
+    timing.update_last = now;
+
+    // don't try to catch up if updates are slower than real time
+    if (timing.update_acc > TIMING_MAX_UPDATES * timing.update_step) {
+        timing.update_acc = TIMING_MAX_UPDATES * timing.update_step;
+    }
+
+    int steps = timing.update_acc / timing.update_step;
+    timing.update_acc -= steps * timing.update_step;
+    timing.update_alpha = (double)timing.update_acc / timing.update_step;
+
+    return steps;
+}
+
+/**
+ * @brief finish a frame: sleep until the frame deadline for the wanted frame rate and update the frame statistics.
+ * The deadlines are kept on a fixed grid so rounding errors do not accumulate, if a frame is late the grid is restarted.
+ * With the virtual clock there is no waiting, the script time advances by exactly one frame period.
+ */
+void timing_end_frame(void) {
+    uint64_t now = timing_now();
+
+    if (timing.virtual_clock) {
+        float rate = DOjS.wanted_frame_rate > 0 ? DOjS.wanted_frame_rate : TIMING_VIRTUAL_RATE;
+        timing_advance(TIMING_NS_PER_SEC / rate);
+    } else if (DOjS.wanted_frame_rate > 0) {
+        uint64_t period = TIMING_NS_PER_SEC / DOjS.wanted_frame_rate;
+        timing.deadline += period;
+        if (timing.deadline < now || timing.deadline > now + period) {
+            // too late or the frame rate was changed
+            timing.deadline = now;
+        } else {
+            timing_sleep_until(timing.deadline);
+            now = timing_now();
+        }
+    }
+
+    uint64_t frame = now - timing.frame_start;
+    timing.frame_start = now;
+
+    timing.frame_times[timing.frame_idx] = frame;
+    timing.frame_idx = (timing.frame_idx + 1) % TIMING_HISTORY;
+    if (timing.frame_count < TIMING_HISTORY) {
+        timing.frame_count++;
+    }
+
+    if (timing.virtual_clock) {
+        DOjS.current_frame_rate = DOjS.wanted_frame_rate > 0 ? DOjS.wanted_frame_rate : TIMING_VIRTUAL_RATE;
+    } else if (frame) {
+        DOjS.current_frame_rate = (double)TIMING_NS_PER_SEC / frame;
+    }
+}
+
+/**
+ * @brief advance the virtual clock, MsecTime() follows it.
+ *
+ * @param ns the time to add in ns.
+ */
+void timing_advance(uint64_t ns) {
+    timing.virtual_now += ns;
+    DOjS.sys_ticks = timing.virtual_now / TIMING_NS_PER_MS;
+}
@@ -0,0 +1,70 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef __TIMING_H__
+#define __TIMING_H__
+
+#include <stdint.h>
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define TIMING_NS_PER_SEC 1000000000ULL        //!< nanoseconds per second
+#define TIMING_NS_PER_MS 1000000ULL            //!< nanoseconds per millisecond
+#define TIMING_HISTORY 128                     //!< number of frame times kept for GetFrameStats()
+#define TIMING_MAX_UPDATES 5                   //!< maximum number of Update() calls per frame, the time beyond that is dropped
+#define TIMING_SPIN_NS (2 * TIMING_NS_PER_MS)  //!< the last part of a frame delay is spent busy waiting for precision
+#define TIMING_CALIBRATE_TICKS 5               //!< number of timer ticks used to calibrate the TSC (DOS)
+#define TIMING_VIRTUAL_RATE 30                 //!< frame rate of the virtual clock if no frame rate is set
+
+/************
+** structs **
+************/
+//! frame scheduler state
+typedef struct {
+    uint64_t deadline;                     //!< end of the current frame
+    uint64_t frame_start;                  //!< start of the current frame
+    uint64_t update_step;                  //!< time per Update() call, 0 if fixed timestep updates are disabled
+    uint64_t update_last;                  //!< time of the last update accounting
+    uint64_t update_acc;                   //!< accumulated time not yet consumed by Update() calls
+    double update_alpha;                   //!< interpolation factor between the last two updates
+    uint64_t frame_times[TIMING_HISTORY];  //!< ring buffer of frame times
+    int frame_idx;                         //!< next index in the ring buffer
+    int frame_count;                       //!< number of valid entries in the ring buffer
+    bool virtual_clock;                    //!< true if the script time advances by a fixed amount per frame instead of real time
+    uint64_t virtual_now;                  //!< the current virtual time
+} timing_t;
+
+/***********************
+** exported functions **
+***********************/
+extern void init_timing(js_State *J);
+extern uint64_t timing_now(void);
+extern void timing_start(void);
+extern int timing_update_steps(void);
+extern void timing_end_frame(void);
+extern void timing_advance(uint64_t ns);
+
+#endif  // __TIMING_H__
@@ -0,0 +1,299 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "transform.h"
+
+#include <math.h>
+#include <mujs.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "DOjS.h"
+
+/************
+** defines **
+************/
+#define TRANSFORM_STACK_INC 16  //!< allocation increment for the matrix stack
+
+/*********************
+** global variables **
+*********************/
+transform_t transform_current;  //!< the current transformation, applied by the drawing functions
+
+/*********************
+** static variables **
+*********************/
+static transform_t *tf_stack = NULL;  //!< stack of saved transformations
+static int tf_stack_size = 0;         //!< number of saved transformations
+static int tf_stack_alloc = 0;        //!< allocated size of the stack
+
+static int *tf_points = NULL;    //!< scratch buffer for transformed points
+static int tf_points_alloc = 0;  //!< size of the scratch buffer in points
+
+/*********************
+** static functions **
+*********************/
+/**
+ * @brief set the current transformation to the identity matrix.
+ */
+static void transform_identity(void) {
+    transform_current.a = 1;
+    transform_current.b = 0;
+    transform_current.c = 0;
+    transform_current.d = 1;
+    transform_current.e = 0;
+    transform_current.f = 0;
+    transform_current.identity = true;
+}
+
+/**
+ * @brief multiply the current transformation with the given matrix (new = current * m).
+ *
+ * @param a matrix value.
+ * @param b matrix value.
+ * @param c matrix value.
+ * @param d matrix value.
+ * @param e matrix value.
+ * @param f matrix value.
+ */
+static void transform_multiply(double a, double b, double c, double d, double e, double f) {
+    transform_t *t = &transform_current;
+    transform_t r;
+
+    r.a = t->a * a + t->c * b;
+    r.b = t->b * a + t->d * b;
+    r.c = t->a * c + t->c * d;
+    r.d = t->b * c + t->d * d;
+    r.e = t->a * e + t->c * f + t->e;
+    r.f = t->b * e + t->d * f + t->f;
+    r.identity = (r.a == 1 && r.b == 0 && r.c == 0 && r.d == 1 && r.e == 0 && r.f == 0);
+
+    *t = r;
+}
+
+/**
+ * @brief reset the current transformation.
+ * TransformReset()
+ *
+ * @param J the JS context.
+ */
+static void f_TransformReset(js_State *J) { transform_identity(); }
+
+/**
+ * @brief save the current transformation on the stack.
+ * TransformPush()
+ *
+ * @param J the JS context.
+ */
+static void f_TransformPush(js_State *J) {
+    if (tf_stack_size >= tf_stack_alloc) {
+        transform_t *new_stack = realloc(tf_stack, sizeof(transform_t) * (tf_stack_alloc + TRANSFORM_STACK_INC));
+        if (!new_stack) {
+            JS_ENOMEM(J);
+            return;
+        }
+        tf_stack = new_stack;
+        tf_stack_alloc += TRANSFORM_STACK_INC;
+    }
+    tf_stack[tf_stack_size++] = transform_current;
+}
+
+/**
+ * @brief restore the last saved transformation from the stack.
+ * TransformPop()
+ *
+ * @param J the JS context.
+ */
+static void f_TransformPop(js_State *J) {
+    if (tf_stack_size <= 0) {
+        js_error(J, "TransformPop() without TransformPush()");
+        return;
+    }
+    transform_current = tf_stack[--tf_stack_size];
+}
+
+/**
+ * @brief multiply the current transformation with the given matrix.
+ * TransformApply(a:number, b:number, c:number, d:number, e:number, f:number)
+ *
+ * @param J the JS context.
+ */
+static void f_TransformApply(js_State *J) {
+    transform_multiply(js_tonumber(J, 1), js_tonumber(J, 2), js_tonumber(J, 3), js_tonumber(J, 4), js_tonumber(J, 5), js_tonumber(J, 6));
+}
+
+/**
+ * @brief add a translation to the current transformation.
+ * TransformTranslate(x:number, y:number)
+ *
+ * @param J the JS context.
+ */
+static void f_TransformTranslate(js_State *J) { transform_multiply(1, 0, 0, 1, js_tonumber(J, 1), js_tonumber(J, 2)); }
+
+/**
+ * @brief add a rotation to the current transformation.
+ * TransformRotate(angle:number)
+ *
+ * @param J the JS context.
+ */
+static void f_TransformRotate(js_State *J) {
+    double angle = js_tonumber(J, 1);
+    double cA = cos(angle);
+    double sA = sin(angle);
+    transform_multiply(cA, sA, -sA, cA, 0, 0);
+}
+
+/**
+ * @brief add scaling to the current transformation.
+ * TransformScale(x:number, y:number)
+ *
+ * @param J the JS context.
+ */
+static void f_TransformScale(js_State *J) {
+    double x = js_tonumber(J, 1);
+    double y = js_isdefined(J, 2) ? js_tonumber(J, 2) : x;
+    transform_multiply(x, 0, 0, y, 0, 0);
+}
+
+/**
+ * @brief check if a transformation is active.
+ * TransformActive():boolean
+ *
+ * @param J the JS context.
+ */
+static void f_TransformActive(js_State *J) { js_pushboolean(J, !transform_current.identity); }
+
+/**
+ * @brief get the current transformation.
+ * TransformGet():number[]
+ *
+ * @param J the JS context.
+ */
+static void f_TransformGet(js_State *J) {
+    js_newarray(J);
+    {
+        js_pushnumber(J, transform_current.a);
+        js_setindex(J, -2, 0);
+        js_pushnumber(J, transform_current.b);
+        js_setindex(J, -2, 1);
+        js_pushnumber(J, transform_current.c);
+        js_setindex(J, -2, 2);
+        js_pushnumber(J, transform_current.d);
+        js_setindex(J, -2, 3);
+        js_pushnumber(J, transform_current.e);
+        js_setindex(J, -2, 4);
+        js_pushnumber(J, transform_current.f);
+        js_setindex(J, -2, 5);
+    }
+}
+
+/**
+ * @brief transform a point and return the x coordinate.
+ * TransformX(x:number, y:number):number
+ *
+ * @param J the JS context.
+ */
+static void f_TransformX(js_State *J) {
+    double x = js_tonumber(J, 1);
+    double y = js_tonumber(J, 2);
+    js_pushnumber(J, transform_current.a * x + transform_current.c * y + transform_current.e);
+}
+
+/**
+ * @brief transform a point and return the y coordinate.
+ * TransformY(x:number, y:number):number
+ *
+ * @param J the JS context.
+ */
+static void f_TransformY(js_State *J) {
+    double x = js_tonumber(J, 1);
+    double y = js_tonumber(J, 2);
+    js_pushnumber(J, transform_current.b * x + transform_current.d * y + transform_current.f);
+}
+
+/***********************
+** exported functions **
+***********************/
+/**
+ * @brief transform an array of x/y pairs with the current transformation.
+ * The result is stored in a scratch buffer that is reused by the next call.
+ *
+ * @param points x/y pairs.
+ * @param len number of points.
+ *
+ * @return the transformed points or NULL if out of memory.
+ */
+int *transform_points(const int *points, int len) {
+    if (len > tf_points_alloc) {
+        int *new_points = realloc(tf_points, sizeof(int) * len * 2);
+        if (!new_points) {
+            return NULL;
+        }
+        tf_points = new_points;
+        tf_points_alloc = len;
+    }
+
+    for (int i = 0; i < len * 2; i += 2) {
+        transform_point(points[i], points[i + 1], &tf_points[i], &tf_points[i + 1]);
+    }
+    return tf_points;
+}
+
+/**
+ * @brief initialize transformation subsystem.
+ *
+ * @param J VM state.
+ */
+void init_transform(js_State *J) {
+    DEBUGF("%s\n", __PRETTY_FUNCTION__);
+
+    transform_identity();
+    tf_stack_size = 0;
+
+    NFUNCDEF(J, TransformReset, 0);
+    NFUNCDEF(J, TransformPush, 0);
+    NFUNCDEF(J, TransformPop, 0);
+    NFUNCDEF(J, TransformApply, 6);
+    NFUNCDEF(J, TransformTranslate, 2);
+    NFUNCDEF(J, TransformRotate, 1);
+    NFUNCDEF(J, TransformScale, 2);
+    NFUNCDEF(J, TransformActive, 0);
+    NFUNCDEF(J, TransformGet, 0);
+    NFUNCDEF(J, TransformX, 2);
+    NFUNCDEF(J, TransformY, 2);
+
+    DEBUGF("%s DONE\n", __PRETTY_FUNCTION__);
+}
+
+/**
+ * @brief free the transformation stack and the scratch buffer.
+ */
+void shutdown_transform(void) {
+    free(tf_stack);
+    tf_stack = NULL;
+    tf_stack_size = tf_stack_alloc = 0;
+
+    free(tf_points);
+    tf_points = NULL;
+    tf_points_alloc = 0;
+}
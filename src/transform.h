@@ -0,0 +1,68 @@
+/*
+MIT License
+
+Copyright (c) 2019-2021 Andre Seidelt <superilu@yahoo.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef __TRANSFORM_H__
+#define __TRANSFORM_H__
+
+#include "DOjS.h"
+
+/************
+** structs **
+************/
+//! 2D affine transformation: x' = a * x + c * y + e, y' = b * x + d * y + f
+typedef struct {
+    double a;       //!< x scale/rotation
+    double b;       //!< y shear/rotation
+    double c;       //!< x shear/rotation
+    double d;       //!< y scale/rotation
+    double e;       //!< x translation
+    double f;       //!< y translation
+    bool identity;  //!< true if this is the identity matrix (no transformation)
+} transform_t;
+
+/*********************
+** global variables **
+*********************/
+extern transform_t transform_current;
+
+/***********************
+** exported functions **
+***********************/
+extern void init_transform(js_State *J);
+extern void shutdown_transform(void);
+extern int *transform_points(const int *points, int len);
+
+/**
+ * @brief transform a point with the current transformation.
+ *
+ * @param x x coordinate.
+ * @param y y coordinate.
+ * @param ox the transformed x coordinate is stored here.
+ * @param oy the transformed y coordinate is stored here.
+ */
+static inline void transform_point(double x, double y, int *ox, int *oy) {
+    *ox = (int)(transform_current.a * x + transform_current.c * y + transform_current.e);
+    *oy = (int)(transform_current.b * x + transform_current.d * y + transform_current.f);
+}
+
+#endif  // __TRANSFORM_H__
@@ -0,0 +1,37 @@
+/*
+** Atlas test: pack a number of generated sprites and draw them in one batch.
+*/
+var NUM_SPRITES = 200;
+
+function Setup() {
+	atlas = new Atlas(256, 256);
+	ids = [];
+	for (var i = 0; i < 16; i++) {
+		var size = 8 + i * 2;
+		var bm = new Bitmap(size, size, 0);
+		SetRenderBitmap(bm);
+		FilledCircle(size / 2, size / 2, size / 2 - 1, Color(i * 16, 255 - i * 16, 128));
+		SetRenderBitmap(null);
+		ids.push(atlas.Add(bm));
+	}
+	Println("Packed " + atlas.Size() + " images, last at " + JSON.stringify(atlas.GetRect(ids[ids.length - 1])));
+
+	batch = new IntArray();
+	for (var i = 0; i < NUM_SPRITES; i++) {
+		batch.Push(ids[i % ids.length]);
+		batch.Push(GetRandomInt(SizeX()));
+		batch.Push(GetRandomInt(SizeY()));
+	}
+
+	view = atlas.Get(ids[3]);
+}
+
+function Loop() {
+	ClearScreen(EGA.BLACK);
+	atlas.DrawBatch(batch, true);
+	view.Draw(10, 10);
+	TextXY(10, SizeY() - 20, "fps=" + GetFramerate(), EGA.WHITE, NO_COLOR);
+}
+
+function Input(e) {
+}
@@ -0,0 +1,782 @@
+/*
+** benchmark suite: runs a set of workloads with warmup and repeated measurements.
+** The results are written to BENCH.JSON, if a previous result file is given as first parameter the results are compared to it and regressions are reported.
+** Workloads that are in the baseline but did not produce a result count as regressions, the run fails if a workload throws.
+** Workloads that are alternatives of another one print their speedup against it.
+** An optional second parameter only runs the workloads whose name starts with it.
+**
+** dojs -r -H 1 tests/benchmark.js [<baseline.json> [<filter>]]
+** make -f Makefile.linux bench [BENCH_BASELINE=<baseline.json>]
+*/
+LoadLibrary("png");
+LoadLibrary("al3d");
+
+var WARMUP = 3;				// number of untimed runs before measuring
+var SAMPLES = 10;			// number of timed runs
+var THRESHOLD = 0.10;		// a workload is a regression if it is 10% slower than the baseline
+var REPORT = "BENCH.JSON";
+var TMP_ZIP = "BENCHTMP.ZIP";
+var TMP_DB = "BENCHTMP.DB";
+var TMP_BMP = "BENCHTMP.BMP";
+var TMP_PNG = "BENCHTMP.PNG";
+var IMAGE = "examples/rose.png";
+var NUM_SPRITES = 500;
+var NUM_POLYS = 500;
+var NUM_POINTS = 6;
+var NUM_BOIDS = 500;
+var TEXT_LINES = 20;
+var PIXEL_SIZE = 64;
+
+var sqlite_available = true;
+try {
+	LoadLibrary("sqlite");
+} catch (e) {
+	sqlite_available = false;
+}
+
+var canvas;
+var data = [];
+var sql;
+var cube, texture, cubeMatrix;
+var sprite, spritePos;
+var pixelImage;
+var textFont;
+var polyArrays, polyInts, polyAll, polyCounts, polyColors;
+var boids, boidVec;
+
+var MAXES = {
+	rgb: [255, 255, 255, 255],
+	hsb: [360, 100, 100, 1],
+	hsl: [360, 100, 100, 1]
+};
+
+var COLOR_INPUTS = [
+	["named", "rgb", ["orange"]],
+	["hex", "rgb", ["#ff8800"]],
+	["rgba()", "rgb", ["rgba(255, 136, 0, 0.5)"]],
+	["hsl()", "rgb", ["hsl(32, 100%, 50%)"]],
+	["HSB numbers", "hsb", [32, 100, 100]],
+	["RGB numbers", "rgb", [255, 136, 0, 128]]
+];
+
+/*
+** every workload does 'ops' operations per run. setup() and teardown() are called once around the measurement.
+** 'base' names an earlier workload doing the same work in a different way, the speedup against it is printed.
+*/
+var WORKLOADS = [
+	{
+		name: "interp.fib", ops: 21891, run: function () { fib(20); }
+	},
+	{
+		name: "interp.string", ops: 1000, run: function () {
+			var s = "";
+			for (var i = 0; i < 1000; i++) {
+				s += String.fromCharCode(65 + i % 26);
+			}
+			s.split("").reverse().join("");
+		}
+	},
+	{
+		name: "interp.object", ops: 10000, run: function () {
+			var o = { x: 0, y: 0, add: function (d) { this.x += d; this.y -= d; } };
+			for (var i = 0; i < 10000; i++) {
+				o.add(i);
+			}
+		}
+	},
+	{
+		name: "gc.alloc", ops: 10000, run: function () {
+			var a = [];
+			for (var i = 0; i < 10000; i++) {
+				a.push({ id: i, name: "obj" + i, pos: [i, i] });
+			}
+			a = null;
+			Gc(false);
+		}
+	},
+	{
+		name: "prim.line", ops: 1000, setup: useCanvas, teardown: dropCanvas, run: function () {
+			for (var i = 0; i < 1000; i++) {
+				Line(i % 640, 0, 639 - i % 640, 479, EGA.YELLOW);
+			}
+		}
+	},
+	{
+		name: "prim.box", ops: 1000, setup: useCanvas, teardown: dropCanvas, run: function () {
+			for (var i = 0; i < 1000; i++) {
+				FilledBox(i % 600, i % 440, i % 600 + 32, i % 440 + 32, EGA.LIGHT_BLUE);
+			}
+		}
+	},
+	{
+		name: "prim.circle", ops: 500, setup: useCanvas, teardown: dropCanvas, run: function () {
+			for (var i = 0; i < 500; i++) {
+				FilledCircle(i % 600 + 20, i % 440 + 20, 16, EGA.RED);
+			}
+		}
+	},
+	{
+		name: "blend.alpha", ops: 200, setup: useCanvas, teardown: dropCanvas, run: function () {
+			blendBoxes(BLEND.ALPHA);
+		}
+	},
+	{
+		name: "blend.multiply", ops: 200, setup: useCanvas, teardown: dropCanvas, run: function () {
+			blendBoxes(BLEND.MULTIPLY);
+		}
+	},
+	{
+		name: "scene.render", ops: 384, setup: function () { useScene(); }, teardown: dropScene, run: function () {
+			drawScene();
+		}
+	},
+	{
+		name: "scene.tiled", ops: 384, setup: function () { useScene(4); }, teardown: dropScene, run: function () {
+			drawScene();
+		}
+	},
+	{
+		name: "sprite.masked", ops: NUM_SPRITES, setup: function () { useSprites(SPRITE.NONE); }, teardown: dropSprites, run: function () {
+			drawSprites(false);
+		}
+	},
+	{
+		name: "sprite.masked.rle", ops: NUM_SPRITES, base: "sprite.masked", setup: function () { useSprites(SPRITE.RLE); }, teardown: dropSprites, run: function () {
+			drawSprites(false);
+		}
+	},
+	{
+		name: "sprite.masked.cmp", ops: NUM_SPRITES, base: "sprite.masked", setup: function () { useSprites(SPRITE.COMPILED); }, teardown: dropSprites, run: function () {
+			drawSprites(false);
+		}
+	},
+	{
+		name: "sprite.trans", ops: NUM_SPRITES, setup: function () { useSprites(SPRITE.NONE); }, teardown: dropSprites, run: function () {
+			drawSprites(true);
+		}
+	},
+	{
+		name: "sprite.trans.rle", ops: NUM_SPRITES, base: "sprite.trans", setup: function () { useSprites(SPRITE.RLE); }, teardown: dropSprites, run: function () {
+			drawSprites(true);
+		}
+	},
+	{
+		name: "pixel.plot", ops: PIXEL_SIZE * PIXEL_SIZE, setup: usePixelImage, teardown: dropPixelImage, run: function () {
+			invertPlot(pixelImage);
+		}
+	},
+	{
+		name: "pixel.array", ops: PIXEL_SIZE * PIXEL_SIZE, base: "pixel.plot", setup: usePixelImage, teardown: dropPixelImage, run: function () {
+			invertPixels(pixelImage);
+		}
+	},
+	{
+		name: "poly.array", ops: NUM_POLYS, setup: usePolygons, teardown: dropPolygons, run: function () {
+			for (var p = 0; p < NUM_POLYS; p++) {
+				FilledPolygon(polyArrays[p], EGA.RED);
+			}
+		}
+	},
+	{
+		name: "poly.intarray", ops: NUM_POLYS, base: "poly.array", setup: usePolygons, teardown: dropPolygons, run: function () {
+			for (var p = 0; p < NUM_POLYS; p++) {
+				FilledPolygon(polyInts[p], EGA.RED);
+			}
+		}
+	},
+	{
+		name: "poly.multi", ops: NUM_POLYS, base: "poly.array", setup: usePolygons, teardown: dropPolygons, run: function () {
+			FilledPolygons(polyAll, polyCounts, polyColors);
+		}
+	},
+	{
+		name: "poly.line", ops: NUM_POLYS, setup: usePolygons, teardown: dropPolygons, run: function () {
+			for (var p = 0; p < NUM_POLYS; p++) {
+				PolyLine(polyInts[p], EGA.WHITE, true);
+			}
+		}
+	},
+	{
+		name: "poly.points", ops: NUM_POLYS * NUM_POINTS, setup: usePolygons, teardown: dropPolygons, run: function () {
+			PlotPoints(polyAll, EGA.YELLOW);
+		}
+	},
+	{
+		name: "text.uncached", ops: TEXT_LINES * 3, setup: function () { useText(0); }, teardown: dropText, run: function () {
+			drawText();
+		}
+	},
+	{
+		name: "text.cached", ops: TEXT_LINES * 3, base: "text.uncached", setup: function () { useText(1024 * 1024); }, teardown: dropText, run: function () {
+			drawText();
+		}
+	},
+	{
+		name: "vector.js", ops: NUM_BOIDS, setup: function () { useBoids(JsVec); }, teardown: dropBoids, run: function () {
+			steerObjects();
+		}
+	},
+	{
+		name: "vector.native", ops: NUM_BOIDS, base: "vector.js", setup: function () { useBoids(PVector); }, teardown: dropBoids, run: function () {
+			steerObjects();
+		}
+	},
+	{
+		name: "vector.bulk", ops: NUM_BOIDS, base: "vector.js", setup: function () { useBoids(PVector); }, teardown: dropBoids, run: function () {
+			steerBulk();
+		}
+	},
+	{
+		name: "color.uncached", ops: 100 * COLOR_INPUTS.length, run: function () {
+			for (var n = 0; n < 100; n++) {
+				for (var i = 0; i < COLOR_INPUTS.length; i++) {
+					var c = COLOR_INPUTS[i];
+					toColor(ColorFromArgsRGBA(c[1], MAXES[c[1]], c[2]));
+				}
+			}
+		}
+	},
+	{
+		name: "color.cached", ops: 100 * COLOR_INPUTS.length, base: "color.uncached", setup: checkColors, run: function () {
+			for (var n = 0; n < 100; n++) {
+				for (var i = 0; i < COLOR_INPUTS.length; i++) {
+					var c = COLOR_INPUTS[i];
+					ColorFromArgs(c[1], MAXES[c[1]], c[2]);
+				}
+			}
+		}
+	},
+	{
+		name: "image.uncached", ops: 10, setup: function () { SetImageCacheSize(0); }, teardown: resetImageCache, run: function () {
+			loadImages();
+		}
+	},
+	{
+		name: "image.cached", ops: 10, base: "image.uncached", setup: function () { resetImageCache(); checkCopyOnWrite(); }, teardown: resetImageCache, run: function () {
+			loadImages();
+		}
+	},
+	{
+		name: "decode.bmp", ops: 1, run: function () {
+			ClearImageCache();
+			new Bitmap("examples/DOjS.bmp");
+		}
+	},
+	{
+		name: "decode.png", ops: 1, run: function () {
+			ClearImageCache();
+			new Bitmap("examples/rose.png");
+		}
+	},
+	{
+		name: "zip.write", ops: 10, setup: createData, teardown: removeTmp, run: function () {
+			writeZip();
+		}
+	},
+	{
+		name: "zip.read", ops: 10, setup: function () { createData(); writeZip(); }, teardown: removeTmp, run: function () {
+			var z = new Zip(TMP_ZIP, ZIPFILE.READ);
+			for (var i = 0; i < 10; i++) {
+				z.ReadBytes("file" + i + ".bin");
+			}
+			z.Close();
+		}
+	},
+	{
+		name: "sqlite.insert", ops: 500, setup: openDb, teardown: closeDb, run: function () {
+			sql.Exec("DELETE FROM bench;");
+			sql.Exec("BEGIN;");
+			for (var i = 0; i < 500; i++) {
+				sql.Exec("INSERT INTO bench (id, name) VALUES (?, ?);", [i, "row" + i]);
+			}
+			sql.Exec("COMMIT;");
+		}
+	},
+	{
+		name: "sqlite.select", ops: 500, setup: function () { openDb(); WORKLOADS_BY_NAME["sqlite.insert"].run(); }, teardown: closeDb, run: function () {
+			for (var i = 0; i < 500; i++) {
+				sql.Exec("SELECT * FROM bench WHERE id=?;", [i]);
+			}
+		}
+	},
+	{
+		name: "bitmap.bmp", ops: 1, setup: useCanvas, teardown: function () { dropCanvas(); removeTmp(); }, run: function () {
+			canvas.SaveBmpImage(TMP_BMP);
+			ClearImageCache();
+			new Bitmap(TMP_BMP);
+		}
+	},
+	{
+		name: "bitmap.png", ops: 1, setup: useCanvas, teardown: function () { dropCanvas(); removeTmp(); }, run: function () {
+			canvas.SavePngImage(TMP_PNG);
+			ClearImageCache();
+			new Bitmap(TMP_PNG);
+		}
+	}
+];
+
+var WORKLOADS_BY_NAME = {};
+for (var w = 0; w < WORKLOADS.length; w++) {
+	WORKLOADS_BY_NAME[WORKLOADS[w].name] = WORKLOADS[w];
+}
+
+function fib(n) {
+	return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+function useCanvas() {
+	canvas = new Bitmap(640, 480, EGA.BLACK);
+	SetRenderBitmap(canvas);
+}
+
+function dropCanvas() {
+	SetRenderBitmap(null);
+	TransparencyEnabled(BLEND.ALPHA);
+	canvas = null;
+}
+
+function blendBoxes(mode) {
+	TransparencyEnabled(mode);
+	for (var i = 0; i < 200; i++) {
+		FilledBox(i % 576, i % 416, i % 576 + 64, i % 416 + 64, Color(255, 128, 0, 128));
+	}
+}
+
+// 8x8 textured cubes with 6 faces each, rendered with render_scene() or the tiled renderer
+function useScene(threads) {
+	useCanvas();
+	SetProjectionViewport(0, 0, 640, 480);
+	CreateScene(8 * 8 * 6 * 8, 8 * 8 * 6, threads);
+	var v = [
+		[-10, -10, -10, 0, 0, 0], [-10, 10, -10, 0, 32, 0], [10, 10, -10, 32, 32, 0], [10, -10, -10, 32, 0, 0],
+		[-10, -10, 10, 32, 0, 0], [-10, 10, 10, 32, 32, 0], [10, 10, 10, 0, 32, 0], [10, -10, 10, 0, 0, 0]
+	];
+	cube = new Mesh(v, [2, 1, 0, 3, 4, 5, 6, 7, 0, 1, 5, 4, 2, 3, 7, 6, 4, 7, 3, 0, 1, 2, 6, 5], 4);
+	texture = new Bitmap(32, 32, EGA.BLUE);
+	SetRenderBitmap(texture);
+	FilledCircle(16, 16, 12, EGA.YELLOW);
+	SetRenderBitmap(canvas);
+	cubeMatrix = new Matrix();
+}
+
+function drawScene() {
+	ClearScene();
+	for (var y = 0; y < 8; y++) {
+		for (var x = 0; x < 8; x++) {
+			cubeMatrix.SetTransformation(1, x * 0.3, y * 0.3, 0, (x - 3.5) * 26, (y - 3.5) * 26, 120);
+			cube.SceneDraw(cubeMatrix, POLYTYPE.PTEX, texture, true);
+		}
+	}
+	RenderScene();
+}
+
+function dropScene() {
+	DestroyScene();
+	cube = texture = cubeMatrix = null;
+	dropCanvas();
+}
+
+// mostly transparent sprite: a ring on a background of MASK_COLOR, drawn at random positions
+function useSprites(mode) {
+	useCanvas();
+	sprite = new Bitmap(32, 32, MASK_COLOR);
+	SetRenderBitmap(sprite);
+	CustomCircle(16, 16, 12, 3, EGA.YELLOW);
+	SetRenderBitmap(canvas);
+	sprite.Optimize(mode);
+
+	spritePos = [];
+	for (var i = 0; i < NUM_SPRITES; i++) {
+		spritePos.push([GetRandomInt(640), GetRandomInt(480)]);
+	}
+}
+
+function drawSprites(trans) {
+	for (var i = 0; i < spritePos.length; i++) {
+		if (trans) {
+			sprite.DrawTrans(spritePos[i][0], spritePos[i][1]);
+		} else {
+			sprite.DrawMasked(spritePos[i][0], spritePos[i][1]);
+		}
+	}
+}
+
+function dropSprites() {
+	sprite = spritePos = null;
+	dropCanvas();
+}
+
+// black image with a white diagonal, inverting it twice must restore it
+function usePixelImage() {
+	pixelImage = new Bitmap(PIXEL_SIZE, PIXEL_SIZE, EGA.BLACK);
+	SetRenderBitmap(pixelImage);
+	Line(0, 0, PIXEL_SIZE - 1, PIXEL_SIZE - 1, EGA.WHITE);
+	SetRenderBitmap(null);
+
+	invertPixels(pixelImage);
+	invertPixels(pixelImage);
+	var px = pixelImage.GetPixels();
+	if (px.length != PIXEL_SIZE * PIXEL_SIZE * 4 || px[0] != 255 || px[4] != 0) {
+		throw new Error("PixelArray contents wrong");
+	}
+}
+
+function invertPlot(bm) {
+	SetRenderBitmap(bm);
+	for (var y = 0; y < bm.height; y++) {
+		for (var x = 0; x < bm.width; x++) {
+			var c = bm.GetPixel(x, y);
+			Plot(x, y, Color(255 - GetRed(c), 255 - GetGreen(c), 255 - GetBlue(c)));
+		}
+	}
+	SetRenderBitmap(null);
+}
+
+function invertPixels(bm) {
+	var px = bm.GetPixels();
+	for (var i = 0; i < px.length; i += 4) {
+		px[i] = 255 - px[i];
+		px[i + 1] = 255 - px[i + 1];
+		px[i + 2] = 255 - px[i + 2];
+	}
+	px.Update();
+}
+
+function dropPixelImage() {
+	pixelImage = null;
+}
+
+// random hexagons as [x, y] arrays, as one IntArray each and all in one IntArray
+function usePolygons() {
+	useCanvas();
+	polyArrays = [];
+	polyInts = [];
+	polyAll = new IntArray();
+	polyCounts = new IntArray();
+	polyColors = new IntArray();
+	for (var p = 0; p < NUM_POLYS; p++) {
+		var cx = GetRandomInt(640);
+		var cy = GetRandomInt(480);
+		var arr = [];
+		var ia = new IntArray();
+		for (var i = 0; i < NUM_POINTS; i++) {
+			var a = i * 2 * Math.PI / NUM_POINTS;
+			var x = Math.round(cx + Math.cos(a) * 20);
+			var y = Math.round(cy + Math.sin(a) * 20);
+			arr.push([x, y]);
+			ia.Push(x);
+			ia.Push(y);
+			polyAll.Push(x);
+			polyAll.Push(y);
+		}
+		polyArrays.push(arr);
+		polyInts.push(ia);
+		polyCounts.Push(NUM_POINTS);
+		polyColors.Push(EGA.RED);
+	}
+}
+
+function dropPolygons() {
+	polyArrays = polyInts = polyAll = polyCounts = polyColors = null;
+	dropCanvas();
+}
+
+function useText(cacheSize) {
+	useCanvas();
+	textFont = new Font(JSBOOTPATH + "fonts/cour14b.fnt");
+	SetTextCacheSize(cacheSize);
+	ClearTextCache();
+}
+
+function drawText() {
+	for (var i = 0; i < TEXT_LINES; i++) {
+		var y = i * textFont.height;
+		TextXY(0, y, "Line " + i + ": The quick brown fox", EGA.WHITE, NO_COLOR);
+		textFont.DrawStringLeft(200, y, "Score: " + i * 100, EGA.YELLOW, EGA.BLUE);
+		textFont.DrawStringRight(640, y, "HUD " + i, EGA.GREEN, NO_COLOR);
+	}
+}
+
+function dropText() {
+	SetTextCacheSize(1024 * 1024);
+	ClearTextCache();
+	textFont = null;
+	dropCanvas();
+}
+
+// the pure JS vector implementation PVector used before
+function JsVec(x, y, z) {
+	this.x = x || 0;
+	this.y = y || 0;
+	this.z = z || 0;
+}
+JsVec.prototype.copy = function () { return new JsVec(this.x, this.y, this.z); };
+JsVec.prototype.add = function (v) { this.x += v.x; this.y += v.y; this.z += v.z; return this; };
+JsVec.prototype.sub = function (v) { this.x -= v.x; this.y -= v.y; this.z -= v.z; return this; };
+JsVec.prototype.mult = function (n) { this.x *= n; this.y *= n; this.z *= n; return this; };
+JsVec.prototype.magSq = function () { return this.x * this.x + this.y * this.y + this.z * this.z; };
+JsVec.prototype.mag = function () { return Math.sqrt(this.magSq()); };
+JsVec.prototype.normalize = function () { var l = this.mag(); if (l !== 0) { this.mult(1 / l); } return this; };
+JsVec.prototype.limit = function (max) { var m = this.magSq(); if (m > max * max) { this.mult(max / Math.sqrt(m)); } return this; };
+JsVec.sub = function (a, b) { return a.copy().sub(b); };
+
+// flocking style particles seeking the center
+function useBoids(Vec) {
+	boidVec = Vec;
+	boids = { pos: [], vel: [], acc: [], target: new Vec(320, 240) };
+	for (var i = 0; i < NUM_BOIDS; i++) {
+		boids.pos.push(new Vec(GetRandomInt(640), GetRandomInt(480)));
+		boids.vel.push(new Vec(Math.random() * 2 - 1, Math.random() * 2 - 1));
+		boids.acc.push(new Vec(0, 0));
+	}
+}
+
+// seek the target and integrate with one method call per vector operation
+function steerObjects() {
+	var b = boids, Vec = boidVec;
+	for (var i = 0; i < NUM_BOIDS; i++) {
+		var desired = Vec.sub(b.target, b.pos[i]);
+		desired.normalize();
+		desired.mult(3);
+		var steer = Vec.sub(desired, b.vel[i]);
+		steer.limit(0.05);
+		b.acc[i].add(steer);
+
+		b.vel[i].add(b.acc[i]);
+		b.vel[i].limit(3);
+		b.pos[i].add(b.vel[i]);
+		b.acc[i].mult(0);
+	}
+}
+
+// seek the target with a reused temporary and integrate with bulk operations
+function steerBulk() {
+	var b = boids, Vec = boidVec;
+	var tmp = new Vec();
+	for (var i = 0; i < NUM_BOIDS; i++) {
+		Vec.sub(b.target, b.pos[i], tmp);
+		tmp.setMag(3);
+		tmp.sub(b.vel[i]);
+		tmp.limit(0.05);
+		b.acc[i].add(tmp);
+	}
+	Vec.addArray(b.vel, b.acc);
+	Vec.limitArray(b.vel, 3);
+	Vec.addArray(b.pos, b.vel);
+	Vec.multArray(b.acc, 0);
+}
+
+function dropBoids() {
+	boids = boidVec = null;
+}
+
+// what p5Color.toAllegro() does with normalized components
+function toColor(c) {
+	var a = Math.round(c[3] * 255);
+	return Color(Math.round(c[0] * 255), Math.round(c[1] * 255), Math.round(c[2] * 255), a == 255 ? 254 : a);
+}
+
+// both color paths must produce the same color
+function checkColors() {
+	for (var i = 0; i < COLOR_INPUTS.length; i++) {
+		var c = COLOR_INPUTS[i];
+		var cached = ColorFromArgs(c[1], MAXES[c[1]], c[2]);
+		var uncached = toColor(ColorFromArgsRGBA(c[1], MAXES[c[1]], c[2]));
+		if (cached != uncached) {
+			throw new Error("color mismatch for " + c[0] + ": " + cached.toString(16) + " != " + uncached.toString(16));
+		}
+	}
+}
+
+function loadImages() {
+	var bms = [];
+	for (var i = 0; i < 10; i++) {
+		bms.push(new Bitmap(IMAGE));
+	}
+}
+
+function resetImageCache() {
+	SetImageCacheSize(8 * 1024 * 1024);
+	ClearImageCache();
+}
+
+// modifying a shared image must not change the other Bitmaps
+function checkCopyOnWrite() {
+	var a = new Bitmap(IMAGE);
+	var b = new Bitmap(IMAGE);
+	a.Clear(EGA.RED);
+	if (a.GetPixel(0, 0) == b.GetPixel(0, 0)) {
+		throw new Error("copy on write failed");
+	}
+}
+
+function createData() {
+	data = [];
+	for (var i = 0; i < 10000; i++) {
+		data.push(i & 0xFF);
+	}
+}
+
+function writeZip() {
+	var z = new Zip(TMP_ZIP, ZIPFILE.WRITE);
+	for (var i = 0; i < 10; i++) {
+		z.WriteBytes("file" + i + ".bin", data);
+	}
+	z.Close();
+}
+
+function openDb() {
+	if (!sqlite_available) {
+		throw new Error("SQLite not available");
+	}
+	removeTmp();
+	sql = new SQLite(TMP_DB);
+	sql.Exec("CREATE TABLE bench (id INTEGER PRIMARY KEY, name TEXT);");
+}
+
+function closeDb() {
+	sql.Close();
+	sql = null;
+	removeTmp();
+}
+
+function removeTmp() {
+	var files = [TMP_ZIP, TMP_DB, TMP_BMP, TMP_PNG];
+	for (var i = 0; i < files.length; i++) {
+		try {
+			RmFile(files[i]);
+		} catch (e) {
+		}
+	}
+}
+
+/*
+** run a workload and calculate the statistics in ms.
+*/
+function measure(w) {
+	var times = [];
+	for (var i = 0; i < WARMUP + SAMPLES; i++) {
+		var start = NsecTime(true);
+		w.run();
+		var end = NsecTime(true);
+		if (i >= WARMUP) {
+			times.push((end - start) / 1000000);
+		}
+	}
+
+	var sum = 0;
+	var min = times[0];
+	for (var i = 0; i < times.length; i++) {
+		sum += times[i];
+		min = Math.min(min, times[i]);
+	}
+	var mean = sum / times.length;
+	var sq = 0;
+	for (var i = 0; i < times.length; i++) {
+		sq += (times[i] - mean) * (times[i] - mean);
+	}
+
+	return {
+		"mean": mean,
+		"stddev": Math.sqrt(sq / times.length),
+		"min": min,
+		"samples": times.length,
+		"ops": w.ops,
+		"opsPerSec": mean > 0 ? w.ops / (mean / 1000) : 0
+	};
+}
+
+function pad(s, len) {
+	s = "" + s;
+	while (s.length < len) {
+		s += " ";
+	}
+	return s;
+}
+
+function Setup() {
+	var baseline = null;
+	if (ARGS.length > 1) {
+		baseline = JSON.parse(Read(ARGS[1]));
+	}
+	var filter = ARGS.length > 2 ? ARGS[2] : "";
+
+	var report = { "date": new Date().toISOString(), "linux": LINUX, "workloads": {} };
+	var regressions = 0;
+	var failures = 0;
+
+	for (var w = 0; w < WORKLOADS.length; w++) {
+		var wl = WORKLOADS[w];
+		if (wl.name.indexOf(filter) != 0) {
+			continue;
+		}
+
+		var res = null;
+		var err = null;
+		try {
+			if (wl.setup) {
+				wl.setup();
+			}
+			res = measure(wl);
+		} catch (e) {
+			err = e;
+		}
+		try {
+			if (wl.teardown) {
+				wl.teardown();
+			}
+		} catch (e) {
+		}
+		if (err) {
+			Println(pad(wl.name, 20) + "FAILED: " + err);
+			failures++;
+			continue;
+		}
+		report.workloads[wl.name] = res;
+
+		var line = pad(wl.name, 20) + pad(res.mean.toFixed(3) + "ms", 12) + pad("+-" + res.stddev.toFixed(3), 10) + pad(res.opsPerSec.toFixed(0) + " ops/s", 16);
+		if (wl.base && report.workloads[wl.base]) {
+			line += pad((report.workloads[wl.base].mean / res.mean).toFixed(2) + "x", 10);
+		} else {
+			line += pad("", 10);
+		}
+		if (baseline && baseline.workloads[wl.name]) {
+			var change = res.mean / baseline.workloads[wl.name].mean - 1;
+			line += (change >= 0 ? "+" : "") + (change * 100).toFixed(1) + "%";
+			if (change > THRESHOLD) {
+				line += " REGRESSION";
+				regressions++;
+			}
+		}
+		Println(line);
+	}
+
+	// baseline workloads without a result (removed or failed) hide regressions
+	if (baseline) {
+		for (var name in baseline.workloads) {
+			if (name.indexOf(filter) == 0 && !report.workloads[name]) {
+				Println(pad(name, 20) + (WORKLOADS_BY_NAME[name] ? "no result" : "missing") + " REGRESSION");
+				regressions++;
+			}
+		}
+	}
+
+	var f = new File(REPORT, FILE.WRITE);
+	f.WriteString(JSON.stringify(report, null, 2));
+	f.Close();
+	Println("Results written to " + REPORT);
+
+	if (failures > 0 || regressions > 0) {
+		throw new Error(failures + " workload(s) failed, " + regressions + " workload(s) slower than or missing from the baseline");
+	}
+}
+
+/*
+** This function is repeatedly until ESC is pressed or Stop() is called.
+*/
+function Loop() {
+	Stop();
+}
+
+function Input(e) {
+}
@@ -0,0 +1,47 @@
+/*
+** test for the frame scheduler: fixed timestep Update() with interpolation and frame time statistics.
+** A box moves with 100 pixels per second, updated 20 times per second but rendered at 60fps.
+*/
+var SPEED = 100;
+var UPDATE_RATE = 20;
+
+var prevX = 0;
+var curX = 0;
+var updates = 0;
+var start;
+
+function Setup() {
+	SetFramerate(60);
+	SetUpdateRate(UPDATE_RATE);
+	start = NsecTime();
+}
+
+function Update() {
+	prevX = curX;
+	curX = (curX + SPEED / UPDATE_RATE) % SizeX();
+	updates++;
+}
+
+function Loop() {
+	ClearScreen(EGA.BLACK);
+
+	// interpolate between the last two updates
+	var x = prevX + (curX - prevX) * GetUpdateAlpha();
+	if (curX < prevX) {
+		x = curX;	// wrapped around
+	}
+	FilledBox(x, SizeY() / 2 - 10, x + 20, SizeY() / 2 + 10, EGA.YELLOW);
+
+	var secs = (NsecTime() - start) / 1000000000;
+	var stats = GetFrameStats();
+	TextXY(10, 10, "fps=" + GetFramerate().toFixed(2) + ", updates/s=" + (updates / secs).toFixed(2), EGA.WHITE, NO_COLOR);
+	TextXY(10, 20, "frame ms: min=" + stats.min.toFixed(2) + " avg=" + stats.avg.toFixed(2) + " max=" + stats.max.toFixed(2) + " p99=" + stats.p99.toFixed(2), EGA.WHITE, NO_COLOR);
+
+	if (secs > 10) {
+		Println(JSON.stringify(stats));
+		Stop();
+	}
+}
+
+function Input(e) {
+}
@@ -44,7 +44,9 @@ function Loop() {
 	ClearScreen(EGA.RED);
 
 	if (img != null) {
+		var start = MsecTime();
 		img.PlayFrame(10, 10);
+		TextXY(10, SizeY() - 20, "frame time " + (MsecTime() - start) + "ms, cached=" + img.IsCached() + ", press 'c' to cache frames", EGA.WHITE, EGA.RED);
 		Sleep(img.frameDelay);
 	}
 }
@@ -63,6 +65,9 @@ function Input(e) {
 	if (CompareKey(e.key, '3')) {
 		img = i3;
 	}
+	if (CompareKey(e.key, 'c')) {
+		Println("cache enabled = " + img.EnableCache(16 * 1024 * 1024));
+	}
 	GifInfo(img);
 }
 
@@ -0,0 +1,55 @@
+/*
+** load images in the background while animating.
+*/
+LoadLibrary("qoi");
+LoadLibrary("webp");
+
+var IMAGES = ["tests/testdata/rose.qoi", "tests/testdata/rose.webp", "tests/testdata/rose.jpg"];
+
+var handles = [];
+var loaded = [];
+var frame = 0;
+var sw;
+
+function Setup() {
+	sw = new StopWatch();
+	sw.Start();
+	for (var i = 0; i < IMAGES.length; i++) {
+		handles.push(Bitmap.LoadAsync(IMAGES[i]));
+	}
+}
+
+/*
+** This function is repeatedly until ESC is pressed or Stop() is called.
+*/
+function Loop() {
+	ClearScreen(EGA.BLACK);
+
+	// poll pending images
+	for (var i = handles.length - 1; i >= 0; i--) {
+		var bm = handles[i].Poll();
+		if (bm) {
+			Println("loaded " + bm.filename + " in frame " + frame);
+			loaded.push(bm);
+			handles.splice(i, 1);
+			if (handles.length == 0) {
+				sw.Stop();
+				sw.Print("all images");
+			}
+		}
+	}
+
+	// draw loaded images
+	for (var i = 0; i < loaded.length; i++) {
+		loaded[i].Draw(i * 40, 0);
+	}
+
+	// the animation must not stall while loading
+	var x = SizeX() / 2 + Math.sin(frame / 10) * SizeX() / 3;
+	FilledCircle(x, SizeY() / 2, 20, EGA.YELLOW);
+	TextXY(0, SizeY() - 10, "frame " + frame + ", " + GetFramerate() + " FPS", EGA.WHITE);
+	frame++;
+}
+
+function Input(e) {
+}
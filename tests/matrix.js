@@ -0,0 +1,77 @@
+/*
+** test for the native Matrix: compares the results with the array based functions and measures the speedup.
+*/
+LoadLibrary("al3d");
+
+var ITERATIONS = 2000;
+var NUM_VERTICES = 1000;
+
+function Setup() {
+	// results must match the array based functions
+	var a = MatrixMul(GetTransformationMatrix(2, 0.1, 0.2, 0.3, 10, 20, 30), GetXRotateMatrix(0.5));
+	var m = new Matrix().SetTransformation(2, 0.1, 0.2, 0.3, 10, 20, 30).Mul(GetXRotateMatrix(0.5));
+	Println("MatrixMul:       " + JSON.stringify(a));
+	Println("Matrix.Mul():    " + JSON.stringify(m.Get()));
+	Println("ApplyMatrix:     " + JSON.stringify(ApplyMatrix(a, [1, 2, 3, 4, 5, 6])));
+	var buf = [1, 2, 3, 4, 5, 6];
+	m.ApplyBuffer(buf);
+	Println("ApplyBuffer():   " + JSON.stringify(buf));
+
+	// stack
+	m.Push().Identity().Translate(1, 2, 3);
+	Println("Push/Translate:  " + JSON.stringify(m.Get()));
+	m.Pop();
+	Println("Pop:             " + JSON.stringify(m.Get()));
+
+	// build the same transformation with both APIs
+	var sw = new StopWatch();
+	sw.Start();
+	for (var i = 0; i < ITERATIONS; i++) {
+		var t = MatrixMul(GetXRotateMatrix(i), GetTranslationMatrix(i, i, i));
+		t = MatrixMul(GetYRotateMatrix(i), t);
+	}
+	sw.Stop();
+	sw.Print("MatrixMul()");
+	var arrTime = sw.ResultMs() + 1;
+
+	var n = new Matrix();
+	sw.Start();
+	for (var i = 0; i < ITERATIONS; i++) {
+		n.Identity().Translate(i, i, i).RotateX(i).RotateY(i);
+	}
+	sw.Stop();
+	sw.Print("Matrix");
+	Println("Speedup is " + (arrTime / (sw.ResultMs() + 1)) + "x\n");
+
+	// transform a vertex buffer
+	var vertices = [];
+	var flat = [];
+	for (var i = 0; i < NUM_VERTICES; i++) {
+		vertices.push([i, i, i, 0, 0, 0]);
+		flat.push(i, i, i, 0, 0, 0);
+	}
+	sw.Start();
+	for (var i = 0; i < vertices.length; i++) {
+		ApplyMatrix(a, vertices[i]);
+	}
+	sw.Stop();
+	sw.Print("ApplyMatrix()");
+	arrTime = sw.ResultMs() + 1;
+
+	var out = flat.slice();
+	sw.Start();
+	m.ApplyBuffer(flat, out);
+	sw.Stop();
+	sw.Print("Matrix.ApplyBuffer()");
+	Println("Speedup is " + (arrTime / (sw.ResultMs() + 1)) + "x\n");
+}
+
+/*
+** This function is repeatedly until ESC is pressed or Stop() is called.
+*/
+function Loop() {
+	Stop();
+}
+
+function Input(e) {
+}
@@ -0,0 +1,89 @@
+/*
+** test for Mesh: draws a grid of rotating cubes either with Mesh.SceneDraw() or with the per-polygon JS functions.
+** Press SPACE to switch between both modes and compare the frame rates.
+*/
+LoadLibrary("al3d");
+
+var GRID = 4;
+
+var VERTICES = [
+	[-10, -10, -10, 0, 0, EGA.RED],
+	[-10, 10, -10, 0, 0, EGA.GREEN],
+	[10, 10, -10, 0, 0, EGA.BLUE],
+	[10, -10, -10, 0, 0, EGA.YELLOW],
+	[-10, -10, 10, 0, 0, EGA.CYAN],
+	[-10, 10, 10, 0, 0, EGA.MAGENTA],
+	[10, 10, 10, 0, 0, EGA.WHITE],
+	[10, -10, 10, 0, 0, EGA.LIGHT_GREY]
+];
+
+var FACES = [
+	2, 1, 0, 3,
+	4, 5, 6, 7,
+	0, 1, 5, 4,
+	2, 3, 7, 6,
+	4, 7, 3, 0,
+	1, 2, 6, 5
+];
+
+var cube;
+var useMesh = true;
+var angle = 0;
+
+function Setup() {
+	SetFramerate(100);
+	SetProjectionViewport(0, 0, SizeX(), SizeY());
+	CreateScene(24 * GRID * GRID, 6 * GRID * GRID);
+	cube = new Mesh(VERTICES, FACES, 4);
+	Println("vertices=" + cube.numVertices + ", faces=" + cube.numFaces);
+}
+
+function Loop() {
+	ClearScreen(EGA.BLACK);
+	ClearScene();
+
+	var drawn = 0;
+	for (var y = 0; y < GRID; y++) {
+		for (var x = 0; x < GRID; x++) {
+			var m = GetTransformationMatrix(1, angle + x, angle + y, angle, (x - GRID / 2 + 0.5) * 30, (y - GRID / 2 + 0.5) * 30, 150);
+			if (useMesh) {
+				drawn += cube.SceneDraw(m, POLYTYPE.GCOL, null, true);
+			} else {
+				drawn += drawCube(m);
+			}
+		}
+	}
+	RenderScene();
+	angle += 0.02;
+
+	TextXY(10, 10, (useMesh ? "Mesh" : "JS") + " faces=" + drawn + " rate=" + GetFramerate().toFixed(1), EGA.WHITE, NO_COLOR);
+}
+
+// reference implementation with one conversion per polygon
+function drawCube(m) {
+	var drawn = 0;
+	for (var f = 0; f < FACES.length; f += 4) {
+		var poly = [];
+		for (var i = 0; i < 4; i++) {
+			poly.push(ApplyMatrix(m, VERTICES[FACES[f + i]]));
+		}
+		poly = Clip3D(POLYTYPE.GCOL, 0.1, 1000, poly);
+		if (poly.length < 3) {
+			continue;
+		}
+		for (var i = 0; i < poly.length; i++) {
+			poly[i] = PerspProject(poly[i]);
+		}
+		if (PolygonZNormal(poly[0], poly[1], poly[2]) > 0) {
+			ScenePolygon3D(POLYTYPE.GCOL, null, poly);
+			drawn++;
+		}
+	}
+	return drawn;
+}
+
+function Input(e) {
+	if (CompareKey(e.key, ' ')) {
+		useMesh = !useMesh;
+	}
+}
@@ -41,18 +41,33 @@ function Setup() {
 	SetFramerate(60);
 }
 
+var scale = 0;
+
 function Loop() {
 	//ClearScreen(EGA.DARK_GRAY);
 
-	m.Play(20, 20);
-
-	Box(20, 20, 20 + m.width, 20 + m.height, EGA.RED);
+	if (scale == 0) {
+		m.Play(20, 20);
+		Box(20, 20, 20 + m.width, 20 + m.height, EGA.RED);
+	} else {
+		// scale to screen height, nearest neighbour or bilinear
+		var h = SizeY() - 40;
+		var w = Math.floor(m.width * h / m.height);
+		m.Play(20, 20, w, h, scale == 2);
+		Box(20, 20, 20 + w, 20 + h, EGA.RED);
+	}
 
-	FilledBox(10, 10, 10 + 300, 10 + 10, EGA.BLACK);
-	TextXY(10, 10, "" + m.CurrentTime(), EGA.RED, NO_COLOR);
+	var s = m.GetStats();
+	FilledBox(10, 10, 10 + 500, 10 + 10, EGA.BLACK);
+	TextXY(10, 10, m.CurrentTime().toFixed(2) + "s, decoded=" + s.decoded + ", shown=" + s.shown + ", dropped=" + s.dropped + ", queued=" + s.queued + "/" + s.audioQueued + (s.threaded ? " (threaded)" : ""), EGA.RED, NO_COLOR);
 
 	//Println(GetFramerate());
 }
 
 function Input(e) {
+	// 's' cycles through unscaled, nearest neighbour and bilinear
+	if (CompareKey(e.key, 's')) {
+		scale = (scale + 1) % 3;
+		ClearScreen(EGA.BLACK);
+	}
 }
@@ -0,0 +1,83 @@
+/*
+** vertex arrays: renders a grid of cubes with glDrawElements() or immediate mode, SPACE toggles between them.
+*/
+LoadLibrary("ogl");
+LoadLibrary("neural");	// DoubleArray
+
+var GRID = 16;
+var useArrays = true;
+var angle = 0;
+var vertices, colors, indices;
+
+// corners and colors of a unit cube, faces as quads
+var CUBE_V = [
+	[-1, -1, -1], [1, -1, -1], [1, 1, -1], [-1, 1, -1],
+	[-1, -1, 1], [1, -1, 1], [1, 1, 1], [-1, 1, 1]
+];
+var CUBE_F = [0, 3, 2, 1, 4, 5, 6, 7, 0, 1, 5, 4, 2, 3, 7, 6, 1, 2, 6, 5, 0, 4, 7, 3];
+
+function Setup() {
+	glInit();
+
+	var v = [], c = [], idx = [];
+	for (var y = 0; y < GRID; y++) {
+		for (var x = 0; x < GRID; x++) {
+			var base = v.length / 3;
+			for (var i = 0; i < CUBE_V.length; i++) {
+				v.push(CUBE_V[i][0] * 0.4 + x - GRID / 2, CUBE_V[i][1] * 0.4 + y - GRID / 2, CUBE_V[i][2] * 0.4);
+				c.push(x / GRID, y / GRID, i / CUBE_V.length);
+			}
+			for (var i = 0; i < CUBE_F.length; i++) {
+				idx.push(base + CUBE_F[i]);
+			}
+		}
+	}
+	vertices = new DoubleArray(v);
+	colors = new DoubleArray(c);
+	indices = new IntArray(idx);
+	Println("vertices=" + vertices.length / 3 + ", quads=" + indices.length / 4);
+
+	glVertexPointer(3, vertices);
+	glColorPointer(3, colors);
+	glEnableClientState(GL.VERTEX_ARRAY);
+	glEnableClientState(GL.COLOR_ARRAY);
+
+	glEnable(GL.DEPTH_TEST);
+	glViewport(0, 0, GL.WIDTH, GL.HEIGHT);
+	glMatrixMode(GL.PROJECTION);
+	glLoadIdentity();
+	gluPerspective(60.0, GL.WIDTH / GL.HEIGHT, 1.0, 100.0);
+	glMatrixMode(GL.MODELVIEW);
+}
+
+function Loop() {
+	angle = (angle + 1) % 360;
+
+	var start = MsecTime();
+	glClear(GL.COLOR_BUFFER_BIT | GL.DEPTH_BUFFER_BIT);
+	glLoadIdentity();
+	glTranslate(0, 0, -GRID * 1.5);
+	glRotate(angle, 1, 1, 0);
+	if (useArrays) {
+		glDrawElements(GL.QUADS, indices);
+	} else {
+		glBegin(GL.QUADS);
+		for (var i = 0; i < indices.length; i++) {
+			var n = indices.Get(i) * 3;
+			glColor3(colors.Get(n), colors.Get(n + 1), colors.Get(n + 2));
+			glVertex3(vertices.Get(n), vertices.Get(n + 1), vertices.Get(n + 2));
+		}
+		glEnd();
+	}
+	glFlush();
+
+	if (angle % 60 == 0) {
+		Println((useArrays ? "glDrawElements() " : "immediate mode ") + (MsecTime() - start) + "ms");
+	}
+}
+
+function Input(e) {
+	if (CompareKey(e.key, ' ')) {
+		useArrays = !useArrays;
+	}
+}
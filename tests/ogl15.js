@@ -0,0 +1,68 @@
+/*
+** animated texture: a Bitmap is redrawn every frame and uploaded again with glBitmapTexture(), SPACE toggles between glBitmapTexture() and glTexImage2D().
+*/
+LoadLibrary("ogl");
+
+var SIZE = 128;
+var useCache = true;
+var tex, frame = 0;
+var bm;
+
+function Setup() {
+	glInit();
+
+	bm = new Bitmap(SIZE, SIZE, EGA.BLACK);
+	tex = glGenTextures(1)[0];
+
+	glEnable(GL.TEXTURE_2D);
+	glViewport(0, 0, GL.WIDTH, GL.HEIGHT);
+	glMatrixMode(GL.PROJECTION);
+	glLoadIdentity();
+	gluPerspective(60.0, GL.WIDTH / GL.HEIGHT, 1.0, 20.0);
+	glMatrixMode(GL.MODELVIEW);
+}
+
+function Loop() {
+	frame++;
+
+	// animate the texture
+	SetRenderBitmap(bm);
+	ClearScreen(EGA.BLUE);
+	FilledCircle(SIZE / 2 + Math.cos(frame / 10) * 40, SIZE / 2 + Math.sin(frame / 10) * 40, 20, EGA.YELLOW);
+	TextXY(4, 4, "" + frame, EGA.WHITE, NO_COLOR);
+	SetRenderBitmap(null);
+
+	var start = MsecTime();
+	for (var i = 0; i < 10; i++) {
+		if (useCache) {
+			glBitmapTexture(bm, true);
+		} else {
+			glBindTexture(GL.TEXTURE_2D, tex);
+			glTexParameter(GL.TEXTURE_2D, GL.TEXTURE_MIN_FILTER, GL.LINEAR);
+			glTexImage2D(0, GL.RGBA, 0, bm);
+		}
+	}
+	var upload = MsecTime() - start;
+
+	glClear(GL.COLOR_BUFFER_BIT | GL.DEPTH_BUFFER_BIT);
+	glLoadIdentity();
+	glTranslate(0, 0, -3);
+	glRotate(frame, 0, 1, 0);
+	glBegin(GL.QUADS);
+	glTexCoord2(0, 0); glVertex3(-1, -1, 0);
+	glTexCoord2(1, 0); glVertex3(1, -1, 0);
+	glTexCoord2(1, 1); glVertex3(1, 1, 0);
+	glTexCoord2(0, 1); glVertex3(-1, 1, 0);
+	glEnd();
+	glFlush();
+
+	if (frame % 60 == 0) {
+		Println((useCache ? "glBitmapTexture() " : "glTexImage2D() ") + upload + "ms for 10 uploads");
+	}
+}
+
+function Input(e) {
+	if (CompareKey(e.key, ' ')) {
+		useCache = !useCache;
+	}
+}
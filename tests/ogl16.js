@@ -0,0 +1,41 @@
+/*
+** OpenGL rendered into the screen Bitmap and mixed with 2D drawing, needs a Linux build with OSMESA=1.
+**
+** ./dojs -H 100 -D 99 tests/ogl16.js
+*/
+LoadLibrary("ogl");
+
+var angle = 0;
+
+function Setup() {
+	glInit();
+	Println("GL size " + GL.WIDTH + "x" + GL.HEIGHT);
+
+	glEnable(GL.DEPTH_TEST);
+	glViewport(0, 0, GL.WIDTH, GL.HEIGHT);
+	glMatrixMode(GL.PROJECTION);
+	glLoadIdentity();
+	gluPerspective(60.0, GL.WIDTH / GL.HEIGHT, 1.0, 20.0);
+	glMatrixMode(GL.MODELVIEW);
+}
+
+function Loop() {
+	angle = (angle + 2) % 360;
+
+	// 3D part
+	glClearColor(0.1, 0.39, 0.88, 1.0);
+	glClear(GL.COLOR_BUFFER_BIT | GL.DEPTH_BUFFER_BIT);
+	glLoadIdentity();
+	glTranslate(0, 0, -5);
+	glRotate(angle, 1, 1, 0);
+	glColor3(1, 1, 0);
+	glutSolidCube(1.5);
+	glFlush();
+
+	// 2D part on top of it, no copy needed
+	FilledBox(10, 10, 200, 30, EGA.BLACK);
+	TextXY(14, 14, "angle=" + angle + " fps=" + GetFramerate().toFixed(1), EGA.WHITE, NO_COLOR);
+}
+
+function Input(e) {
+}
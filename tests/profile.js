@@ -0,0 +1,44 @@
+/*
+** test for the main loop profiler: the number of drawn boxes (and garbage) grows and shrinks over time.
+** Press F12 to toggle the overlay graph. After 10 seconds the averages are printed and the data is written to PROFILE.CSV.
+*/
+var MAX_BOXES = 2000;
+
+var start;
+var frame = 0;
+
+function Setup() {
+	SetFramerate(30);
+	SetProfileOverlay(true);
+	start = NsecTime();
+}
+
+function Loop() {
+	ClearScreen(EGA.BLACK);
+
+	var num = Math.floor(MAX_BOXES * (1 + Math.sin(frame / 30)) / 2);
+	for (var i = 0; i < num; i++) {
+		var p = [GetRandomInt(SizeX()), GetRandomInt(SizeY())];
+		FilledBox(p[0], p[1], p[0] + 10, p[1] + 10, EGA.YELLOW);
+	}
+	TextXY(10, 10, "boxes=" + num + ", fps=" + GetFramerate().toFixed(2), EGA.WHITE, NO_COLOR);
+	frame++;
+
+	if ((NsecTime() - start) / 1000000000 > 10) {
+		var frames = GetProfile();
+		var avg = {};
+		for (var i = 0; i < frames.length; i++) {
+			for (var k in frames[i]) {
+				avg[k] = (avg[k] || 0) + frames[i][k] / frames.length;
+			}
+		}
+		for (var k in avg) {
+			Println(k + "=" + avg[k].toFixed(3) + "ms");
+		}
+		SaveProfileCSV("PROFILE.CSV");
+		Stop();
+	}
+}
+
+function Input(e) {
+}
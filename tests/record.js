@@ -0,0 +1,42 @@
+/*
+** test for the frame recorder: records 5 seconds of moving boxes as QOI sequence and prints the statistics.
+** Check the frame times with GetFrameStats() with and without recording to see the impact.
+*/
+LoadLibrary("qoi");
+
+var DURATION = 5000;
+var NUM_BOXES = 50;
+
+var boxes = [];
+var start;
+
+function Setup() {
+	SetFramerate(30);
+	for (var i = 0; i < NUM_BOXES; i++) {
+		boxes.push({ x: GetRandomInt(SizeX()), y: GetRandomInt(SizeY()), dx: GetRandomInt(9) - 4, dy: GetRandomInt(9) - 4, c: EGA[Object.keys(EGA)[1 + GetRandomInt(15)]] });
+	}
+	StartRecording("REC", "qoi");
+	start = MsecTime();
+}
+
+function Loop() {
+	ClearScreen(EGA.BLACK);
+	for (var i = 0; i < boxes.length; i++) {
+		var b = boxes[i];
+		b.x = (b.x + b.dx + SizeX()) % SizeX();
+		b.y = (b.y + b.dy + SizeY()) % SizeY();
+		FilledBox(b.x, b.y, b.x + 20, b.y + 20, b.c);
+	}
+
+	var stats = GetRecorderStats();
+	TextXY(10, 10, "captured=" + stats.captured + " written=" + stats.written + " dropped=" + stats.dropped + " pending=" + stats.pending, EGA.WHITE, NO_COLOR);
+
+	if (MsecTime() - start > DURATION) {
+		Println(JSON.stringify(GetFrameStats()));
+		Println(JSON.stringify(StopRecording()));
+		Stop();
+	}
+}
+
+function Input(e) {
+}
@@ -0,0 +1,98 @@
+/*
+** test for the tiled scene renderer: renders the same scene with render_scene() and the tiled renderer, counts the differing pixels and shows an animation.
+** Press SPACE to switch between both renderers and compare the frame rates.
+*/
+LoadLibrary("al3d");
+
+var GRID = 6;
+var THREADS = 4;
+
+var VERTICES = [
+	[-10, -10, -10, 0, 0, EGA.RED],
+	[-10, 10, -10, 0, 32, EGA.GREEN],
+	[10, 10, -10, 32, 32, EGA.BLUE],
+	[10, -10, -10, 32, 0, EGA.YELLOW],
+	[-10, -10, 10, 32, 0, EGA.CYAN],
+	[-10, 10, 10, 32, 32, EGA.MAGENTA],
+	[10, 10, 10, 0, 32, EGA.WHITE],
+	[10, -10, 10, 0, 0, EGA.LIGHT_GREY]
+];
+
+var FACES = [
+	2, 1, 0, 3,
+	4, 5, 6, 7,
+	0, 1, 5, 4,
+	2, 3, 7, 6,
+	4, 7, 3, 0,
+	1, 2, 6, 5
+];
+
+var cube, texture;
+var mat = new Matrix();
+var tiled = true;
+var angle = 0;
+
+function Setup() {
+	SetFramerate(100);
+	SetProjectionViewport(0, 0, SizeX(), SizeY());
+	cube = new Mesh(VERTICES, FACES, 4);
+
+	texture = new Bitmap(32, 32, EGA.BLUE);
+	SetRenderBitmap(texture);
+	FilledCircle(16, 16, 12, EGA.YELLOW);
+	SetRenderBitmap(null);
+
+	// render the same frame with both renderers and compare
+	var types = [["GCOL", POLYTYPE.GCOL], ["ATEX", POLYTYPE.ATEX], ["PTEX", POLYTYPE.PTEX], ["PTEX_MASK", POLYTYPE.PTEX_MASK]];
+	for (var t = 0; t < types.length; t++) {
+		var a = renderTo(types[t][1], undefined);
+		var b = renderTo(types[t][1], THREADS);
+		var diff = 0;
+		for (var y = 0; y < a.height; y++) {
+			for (var x = 0; x < a.width; x++) {
+				if (a.GetPixel(x, y) != b.GetPixel(x, y)) {
+					diff++;
+				}
+			}
+		}
+		Println(types[t][0] + ": " + diff + " of " + (a.width * a.height) + " pixels differ");
+	}
+
+	CreateScene(GRID * GRID * 6 * 8, GRID * GRID * 6, THREADS);
+}
+
+function renderTo(type, threads) {
+	var bm = new Bitmap(SizeX(), SizeY(), EGA.BLACK);
+	SetRenderBitmap(bm);
+	CreateScene(GRID * GRID * 6 * 8, GRID * GRID * 6, threads);
+	drawCubes(type, 0.5);
+	DestroyScene();
+	SetRenderBitmap(null);
+	return bm;
+}
+
+function drawCubes(type, a) {
+	ClearScene();
+	for (var y = 0; y < GRID; y++) {
+		for (var x = 0; x < GRID; x++) {
+			mat.SetTransformation(1, a + x, a + y, a, (x - GRID / 2 + 0.5) * 26, (y - GRID / 2 + 0.5) * 26, 140);
+			cube.SceneDraw(mat, type, texture, true);
+		}
+	}
+	RenderScene();
+}
+
+function Loop() {
+	ClearScreen(EGA.BLACK);
+	drawCubes(POLYTYPE.PTEX, angle);
+	angle += 0.02;
+
+	TextXY(10, 10, (tiled ? "tiled (" + THREADS + " threads)" : "render_scene()") + " rate=" + GetFramerate().toFixed(1), EGA.WHITE, NO_COLOR);
+}
+
+function Input(e) {
+	if (CompareKey(e.key, ' ')) {
+		tiled = !tiled;
+		CreateScene(GRID * GRID * 6 * 8, GRID * GRID * 6, tiled ? THREADS : undefined);
+	}
+}
@@ -0,0 +1,38 @@
+/*
+** draw rotating polygons with the native 2D transformation stack.
+*/
+var STAR = new IntArray();
+
+function Setup() {
+	for (var i = 0; i < 10; i++) {
+		var a = i * Math.PI / 5;
+		var r = (i % 2) ? 10 : 25;
+		STAR.Push(Math.round(Math.cos(a) * r));
+		STAR.Push(Math.round(Math.sin(a) * r));
+	}
+}
+
+/*
+** This function is repeatedly until ESC is pressed or Stop() is called.
+*/
+function Loop() {
+	ClearScreen(EGA.BLACK);
+
+	var angle = MsecTime() / 1000;
+	for (var y = 40; y < SizeY(); y += 60) {
+		for (var x = 40; x < SizeX(); x += 60) {
+			TransformPush();
+			TransformTranslate(x, y);
+			TransformRotate(angle + x / 100);
+			TransformScale(1 + Math.sin(angle + y / 100) / 2);
+			FilledPolygon(STAR, EGA.YELLOW);
+			PolyLine(STAR, EGA.RED, true);
+			Line(0, 0, 30, 0, EGA.WHITE);
+			TransformPop();
+		}
+	}
+	TextXY(0, SizeY() - 10, GetFramerate() + " FPS", EGA.WHITE, NO_COLOR);
+}
+
+function Input(e) {
+}
@@ -37,15 +37,32 @@ function Setup() {
 	Println(m.numsamples);
 	Println(m.duration);
 
+	paused = false;
+
 	SetFramerate(20);
 }
 
 function Loop() {
-	m.Play();
+	if (!paused) {
+		m.Play();
+	}
 
-	FilledBox(10, 10, 10 + 300, 10 + 20, EGA.BLACK);
+	var s = m.GetStats();
+	FilledBox(10, 10, 10 + 500, 10 + 20, EGA.BLACK);
 	TextXY(10, 10, "" + m.CurrentSample(), EGA.RED, NO_COLOR);
+	TextXY(10, 20, "buffered=" + s.buffered + ", underruns=" + s.underruns + (s.threaded ? " (threaded)" : ""), EGA.RED, NO_COLOR);
 }
 
 function Input(e) {
+	// SPACE simulates a slow frame, playback should not underrun with a decoder thread
+	if (CompareKey(e.key, ' ')) {
+		Sleep(500);
+	}
+	// 'p' pauses/resumes playback
+	if (CompareKey(e.key, 'p')) {
+		paused = !paused;
+		if (paused) {
+			m.Stop();
+		}
+	}
 }